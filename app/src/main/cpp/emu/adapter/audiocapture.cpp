@@ -0,0 +1,247 @@
+
+#include <chrono>
+#include <cstdio>
+
+#include "./audiocapture.h"
+
+AudioCapture::AudioCapture()
+    : active(false),
+    bytesCaptured(0),
+    bytesDropped(0)
+{
+    for (size_t i=0; i<numBuffers; i++)
+    {
+        buffers[i] = NULL; // allocated by the first capture
+        bufferUsage[i] = 0;
+        bufferPending[i] = false;
+    }
+
+    writeIndex = readIndex = 0;
+
+    file = NULL;
+    rawFormat = false;
+    sampleRate = 0;
+    numChannels = 0;
+    numBits = 0;
+    dataSize = 0;
+    quit = false;
+}
+
+AudioCapture::~AudioCapture()
+{
+    stop();
+
+    for (size_t i=0; i<numBuffers; i++)
+    {
+        delete [] buffers[i];
+        buffers[i] = NULL;
+    }
+}
+
+bool AudioCapture::start(const std::string& filename, bool raw,
+                         int sampleRate, int numChannels, int numBits)
+{
+    stop();
+
+    if (filename.empty()) return false;
+
+    file = fopen(filename.c_str(), "wb");
+    if (NULL == file)
+    {
+        LOGE("AudioCapture: failed to open '%s'", filename.c_str());
+        return false;
+    }
+
+    this->rawFormat = raw;
+    this->sampleRate = sampleRate;
+    this->numChannels = numChannels;
+    this->numBits = numBits;
+    dataSize = 0;
+
+    // placeholder, sizes are patched in when the capture is stopped
+    if (!rawFormat) writeHeader(0);
+
+    std::lock_guard<std::mutex> guard(captureLock);
+
+    // the whole ring is allocated here, the audio thread never allocates
+    for (size_t i=0; i<numBuffers; i++)
+    {
+        if (NULL == buffers[i]) buffers[i] = new uint8_t[bufferSize];
+        bufferUsage[i] = 0;
+        bufferPending[i] = false;
+    }
+
+    writeIndex = readIndex = 0;
+    bytesCaptured = 0;
+    bytesDropped = 0;
+    quit = false;
+
+    writerThread = std::thread(&AudioCapture::run, this);
+
+    active = true;
+
+    LOG("AudioCapture: started '%s'", filename.c_str());
+
+    return true;
+}
+
+void AudioCapture::stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(captureLock);
+
+        if (!active) return;
+        active = false;
+
+        // hand over whatever is left in the current buffer
+        if (!bufferPending[writeIndex] && bufferUsage[writeIndex] > 0)
+        {
+            submit(writeIndex);
+            writeIndex = (writeIndex + 1) % numBuffers;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(signalLock);
+        quit = true;
+    }
+    signal.notify_one();
+
+    if (writerThread.joinable())
+    {
+        writerThread.join();
+    }
+
+    if (!rawFormat)
+    {
+        writeHeader((uint32_t) std::min(dataSize, (uint64_t) 0xffffffd3));
+    }
+
+    fclose(file);
+    file = NULL;
+
+    if (bytesDropped > 0)
+    {
+        LOGE("AudioCapture: stopped (%llu bytes, %llu bytes DROPPED)",
+            (unsigned long long) bytesCaptured, (unsigned long long) bytesDropped);
+    }
+    else
+    {
+        LOG("AudioCapture: stopped (%llu bytes)", (unsigned long long) bytesCaptured);
+    }
+}
+
+void AudioCapture::write(const void* data, int len)
+{
+    if (!active || len <= 0) return;
+
+    std::lock_guard<std::mutex> guard(captureLock);
+
+    if (!active) return;
+
+    const uint8_t* src = (const uint8_t*) data;
+    size_t remaining = (size_t) len;
+
+    while (remaining > 0)
+    {
+        if (bufferPending[writeIndex])
+        {
+            // the writer is the whole ring behind, never wait for it
+            if (0 == bytesDropped)
+            {
+                LOGE("AudioCapture: writer is %d MB behind, dropping samples",
+                    (int) (numBuffers * bufferSize / (1024 * 1024)));
+            }
+            bytesDropped += remaining;
+            break;
+        }
+
+        size_t n = std::min(remaining, bufferSize - bufferUsage[writeIndex]);
+        memcpy(buffers[writeIndex] + bufferUsage[writeIndex], src, n);
+        bufferUsage[writeIndex] += n;
+        bytesCaptured += n;
+        src += n;
+        remaining -= n;
+
+        if (bufferUsage[writeIndex] == bufferSize)
+        {
+            submit(writeIndex);
+            writeIndex = (writeIndex + 1) % numBuffers;
+        }
+    }
+}
+
+void AudioCapture::submit(size_t index)
+{
+    // no lock here; the writer polls, so a wakeup it misses only delays it
+    bufferPending[index] = true;
+    signal.notify_one();
+}
+
+void AudioCapture::run()
+{
+    for (;;)
+    {
+        bool done;
+
+        {
+            std::unique_lock<std::mutex> guard(signalLock);
+            signal.wait_for(guard, std::chrono::milliseconds(100),
+                            [this] { return quit || bufferPending[readIndex]; });
+            done = quit;
+        }
+
+        // buffers are always submitted in ring order, so drain in that order
+        while (bufferPending[readIndex])
+        {
+            size_t sz = bufferUsage[readIndex];
+            if (fwrite(buffers[readIndex], 1, sz, file) != sz)
+            {
+                LOGE("AudioCapture: write error");
+            }
+            dataSize += sz;
+
+            bufferUsage[readIndex] = 0;
+            bufferPending[readIndex] = false;
+            readIndex = (readIndex + 1) % numBuffers;
+        }
+
+        if (done) break;
+    }
+
+    fflush(file);
+}
+
+static void putLE(uint8_t* dest, uint32_t value, int numBytes)
+{
+    for (int i=0; i<numBytes; i++)
+    {
+        dest[i] = (uint8_t) (value >> (i*8));
+    }
+}
+
+void AudioCapture::writeHeader(uint32_t dataSize)
+{
+    uint8_t header[44];
+
+    int blockAlign = numChannels * numBits / 8;
+    int formatTag = (numBits == 32) ? 3 : 1; // IEEE float or PCM
+
+    memcpy(header + 0, "RIFF", 4);
+    putLE(header + 4, 36 + dataSize, 4);
+    memcpy(header + 8, "WAVE", 4);
+    memcpy(header + 12, "fmt ", 4);
+    putLE(header + 16, 16, 4);
+    putLE(header + 20, formatTag, 2);
+    putLE(header + 22, numChannels, 2);
+    putLE(header + 24, sampleRate, 4);
+    putLE(header + 28, sampleRate * blockAlign, 4);
+    putLE(header + 32, blockAlign, 2);
+    putLE(header + 34, numBits, 2);
+    memcpy(header + 36, "data", 4);
+    putLE(header + 40, dataSize, 4);
+
+    fseek(file, 0, SEEK_SET);
+    fwrite(header, 1, sizeof(header), file);
+    fseek(file, 0, SEEK_END);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "bspf.hxx"
+
+/**
+  Streams the PCM produced by the sound buffer to a WAV or raw file.
+
+  The audio callback only copies into a ring of buffers, all allocated
+  when the first capture starts; full buffers are handed to a background
+  thread which does the file I/O.  The ring holds several seconds of
+  sound, so a writer stalled by the disk costs no samples.  If it falls
+  the whole ring behind, the samples are dropped rather than stalling the
+  callback; they are counted, and reported in the log.
+*/
+class AudioCapture
+{
+    public:
+        AudioCapture();
+        virtual ~AudioCapture();
+
+    public:
+        bool start(const std::string& filename, bool raw,
+                   int sampleRate, int numChannels, int numBits);
+        void stop();
+        bool isActive() const { return active; }
+
+        // called from the audio thread
+        void write(const void* data, int len);
+
+    public:
+        uint64_t getBytesCaptured() const { return bytesCaptured; }
+        uint64_t getBytesDropped() const { return bytesDropped; }
+
+    private:
+        void run();
+        void submit(size_t index);
+        void writeHeader(uint32_t dataSize);
+
+    private:
+        static const size_t bufferSize = 512 * 1024;
+        static const size_t numBuffers = 8; // 4 MB, about 20 s of 16-bit stereo
+
+        uint8_t* buffers[numBuffers];
+        size_t bufferUsage[numBuffers];
+        std::atomic<bool> bufferPending[numBuffers];
+        size_t writeIndex;
+        size_t readIndex;
+
+        FILE* file;
+        bool rawFormat;
+        int sampleRate;
+        int numChannels;
+        int numBits;
+        uint64_t dataSize;
+
+        std::atomic<bool> active;
+        std::atomic<uint64_t> bytesCaptured;
+        std::atomic<uint64_t> bytesDropped;
+
+        // guards the buffer being filled against start/stop
+        std::mutex captureLock;
+
+        std::thread writerThread;
+        std::mutex signalLock;
+        std::condition_variable signal;
+        bool quit;
+
+    private:
+        AudioCapture(const AudioCapture&) = delete;
+        AudioCapture& operator=(const AudioCapture&) = delete;
+};
@@ -3,8 +3,6 @@
 
 Rom::Rom()
 {
-    image = NULL;
-    imageSize = 0;
 }
 
 Rom::~Rom()
@@ -14,27 +12,16 @@ Rom::~Rom()
 
 Rom::Rom(const Rom& rom)
 {
-    image = NULL;
-    imageSize = 0;
-
+    // the image is shared, not copied
     this->filename = rom.filename;
-
-    if (NULL != rom.image && rom.imageSize > 0)
-    {
-        this->create(rom.image, rom.imageSize, rom.filename);
-    }
+    this->image = rom.image;
 }
 
 Rom& Rom::operator=(const Rom& rom)
 {
-    free();
-
+    // the image is shared, not copied
     this->filename = rom.filename;
-
-    if (NULL != rom.image && rom.imageSize > 0)
-    {
-        this->create(rom.image, rom.imageSize, rom.filename);
-    }
+    this->image = rom.image;
 
     return *this;
 }
@@ -43,10 +30,9 @@ void Rom::create(const void* data, int data_size, const std::string& filename)
 {
     free();
 
+    // the only copy of the image, everything else shares it
     this->filename = filename;
-    image = new uint8_t[data_size];
-    imageSize = data_size;
-    memcpy(image, data, imageSize);
+    image = RomImage((const uint8_t*) data, (uint32_t) data_size);
 
 
     /*
@@ -69,15 +55,18 @@ void Rom::create(const void* data, int data_size, const std::string& filename)
 
 }
 
-void Rom::free()
+void Rom::create(const RomImage& image, const std::string& filename)
 {
-    if (NULL != image)
-    {
-        delete [] (uint8_t*) image;
-        image = NULL;
-    }
+    free();
 
-    imageSize = 0;
+    // an image loaded elsewhere (i.e. from an archive) is shared as it is
+    this->filename = filename;
+    this->image = image;
+}
+
+void Rom::free()
+{
+    image = RomImage();
     filename = "";
 }
 
@@ -98,10 +87,15 @@ bool Rom::equals(const Rom& r) const
 
 size_t Rom::getImageSize() const
 {
-	return imageSize;
+	return image.size();
 }
 
 const void* Rom::getImage() const
+{
+	return image.data();
+}
+
+const RomImage& Rom::getRomImage() const
 {
 	return image;
 }
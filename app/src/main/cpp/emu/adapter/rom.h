@@ -1,12 +1,12 @@
 #pragma once
 
 #include "bspf.hxx"
+#include "RomImage.hxx"
 
 class Rom
 {
     private:
-        void* image;
-        size_t imageSize;
+        RomImage image;   // shared by copies of the Rom, never copied itself
         std::string filename;
 
     public:
@@ -17,11 +17,13 @@ class Rom
 
     public:
         void create(const void* data, int data_size, const std::string& filename);
+        void create(const RomImage& image, const std::string& filename);
         void free();
 
     public:
         size_t getImageSize() const;
         const void* getImage() const;
+        const RomImage& getRomImage() const;
 
     public:
         std::string getNameWithExt(const std::string& s) const;
@@ -11,8 +11,51 @@
 #include "Console.hxx"
 #include "soundbuffer.h"
 
+#if defined(__ARM_NEON__) || defined(__ARM_NEON) || defined(__aarch64__)
+#include <arm_neon.h>
+#define SOUND_CONVERT_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SOUND_CONVERT_SSE2
+#endif
+
 #define LOG2 0.30102999566; // log2
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Converts signed 16-bit samples to 32-bit float in the range [-1, 1)
+static void convertS16ToF32(const Int16* src, float* dest, uInt32 count)
+{
+    const float scale = 1.0f / 32768.0f;
+    uInt32 i = 0;
+
+#if defined(SOUND_CONVERT_NEON)
+    const float32x4_t vscale = vdupq_n_f32(scale);
+    for (; i + 8 <= count; i += 8)
+    {
+        int16x8_t s = vld1q_s16(src + i);
+        float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(s)));
+        float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(s)));
+        vst1q_f32(dest + i, vmulq_f32(lo, vscale));
+        vst1q_f32(dest + i + 4, vmulq_f32(hi, vscale));
+    }
+#elif defined(SOUND_CONVERT_SSE2)
+    const __m128 vscale = _mm_set1_ps(scale);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+        _mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), vscale));
+        _mm_storeu_ps(dest + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), vscale));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        dest[i] = float(src[i]) * scale;
+    }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 SoundBuffer::SoundBuffer(OSystem& osystem)
     : Sound(osystem),
@@ -24,6 +67,7 @@ SoundBuffer::SoundBuffer(OSystem& osystem)
     myFragmentSizeLogDiv1(0),
     myFragmentSizeLogDiv2(0),
     myIsMuted(true),
+    mySuppressWrites(false),
     myVolume(100)
 {
     myOSystem.logMessage("SoundBuffer::SoundBuffer started ...", 2);
@@ -31,9 +75,18 @@ SoundBuffer::SoundBuffer(OSystem& osystem)
     myFragmentSize = 0; // passed as argument for update
     myNumBits = 16;
     myNumSamplesPerSecond = 44100;
+    myNumHardwareChannels = 1;
     myNumChannels = 1;
     myFramerate = 60.0f;
     fragmentParamsDirty = true;
+    myConversionBufferSize = 0;
+
+    // Take over the output format negotiated with the frontend
+    const Settings& settings = myOSystem.settings();
+    myFormatDirty = false;
+    setFormat(settings.getInt("freq"), settings.getInt("hwchannels"),
+              settings.getString("sampleformat") == "f32" ? 32 : 16);
+    applyFormat();
 
     myIsInitializedFlag = true;
 
@@ -74,7 +127,7 @@ void SoundBuffer::open()
     // Now initialize the TIASound object which will actually generate sound
     myTIASound.outputFrequency(myNumSamplesPerSecond);
     const string& chanResult =
-        myTIASound.channels(myNumChannels, myNumChannels == 2);
+        myTIASound.channels(myNumHardwareChannels, myNumChannels == 2);
 
     // Adjust volume to that defined in settings
     myVolume = myOSystem.settings().getInt("volume");
@@ -188,6 +241,46 @@ void SoundBuffer::setChannels(uInt32 channels)
         myNumChannels = channels;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SoundBuffer::setFormat(int sampleRate, int numChannels, int numBits)
+{
+    if (sampleRate < 11025 || sampleRate > 48000 ||
+        (numChannels != 1 && numChannels != 2) ||
+        (numBits != 16 && numBits != 32))
+    {
+        return false;
+    }
+
+    myRequestedSamplesPerSecond = sampleRate;
+    myRequestedHardwareChannels = numChannels;
+    myRequestedBits = numBits;
+    myFormatDirty = true;
+
+    myOSystem.settings().setValue("freq", sampleRate);
+    myOSystem.settings().setValue("hwchannels", numChannels);
+    myOSystem.settings().setValue("sampleformat", numBits == 32 ? "f32" : "s16");
+
+    return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundBuffer::applyFormat()
+{
+    if (!myFormatDirty)
+        return;
+
+    myFormatDirty = false;
+
+    myNumSamplesPerSecond = myRequestedSamplesPerSecond;
+    myNumHardwareChannels = myRequestedHardwareChannels;
+    myNumBits = myRequestedBits;
+
+    myTIASound.outputFrequency(myNumSamplesPerSecond);
+    myTIASound.channels(myNumHardwareChannels, myNumChannels == 2);
+
+    fragmentParamsDirty = true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void SoundBuffer::setFrameRate(float framerate)
 {
@@ -202,6 +295,9 @@ void SoundBuffer::setFrameRate(float framerate)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void SoundBuffer::set(uInt16 addr, uInt8 value, Int32 cycle)
 {
+    if (mySuppressWrites)
+        return;
+
     setLock(true);
 
     // First, calculate how many seconds would have past since the last
@@ -227,7 +323,7 @@ void SoundBuffer::set(uInt16 addr, uInt8 value, Int32 cycle)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void SoundBuffer::processFragment(Int16* stream, uInt32 length)
 {
-    uInt32 channels = myNumChannels;
+    uInt32 channels = myNumHardwareChannels;
     length = length / channels;
 
     // If there are excessive items on the queue then we'll remove some
@@ -307,7 +403,9 @@ void SoundBuffer::processFragment(Int16* stream, uInt32 length)
 
 void SoundBuffer::update(uint8_t* buffer, int bufferLen)
 {
-    int numSamples = bufferLen / (myNumBits*myNumChannels/8); // 16bit
+    applyFormat();
+
+    int numSamples = bufferLen / (myNumBits*myNumHardwareChannels/8);
 
     if (numSamples != myFragmentSize || fragmentParamsDirty) {
         myFragmentSize = numSamples;
@@ -319,7 +417,22 @@ void SoundBuffer::update(uint8_t* buffer, int bufferLen)
         myFragmentSizeLogDiv2 = (myFragmentSizeLogBase2 - 1) / myFramerate;
     }
 
-    if (myIsEnabled)
+    if (myIsEnabled && myNumBits == 32)
+    {
+        // The TIA sound emulator deals in 16-bit (signed) data, so generate
+        // into an intermediate buffer and convert to float
+        uInt32 count = uInt32(numSamples * myNumHardwareChannels);
+        if (count > myConversionBufferSize)
+        {
+            myConversionBuffer = make_ptr<Int16[]>(count);
+            myConversionBufferSize = count;
+        }
+
+        processFragment(myConversionBuffer.get(), count);
+        convertS16ToF32(myConversionBuffer.get(),
+                        reinterpret_cast<float*>(buffer), count);
+    }
+    else if (myIsEnabled)
     {
         // The callback is requesting 8-bit (unsigned) data, but the TIA sound
         // emulator deals in 16-bit (signed) data
@@ -330,6 +443,25 @@ void SoundBuffer::update(uint8_t* buffer, int bufferLen)
     {
         memset(buffer, 0, bufferLen);  // Write 'silence'
     }
+
+    if (myCapture.isActive())
+    {
+        myCapture.write(buffer, bufferLen);
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SoundBuffer::startCapture(const string& filename, bool raw)
+{
+    // Use the requested format, which is the one of the next fragment
+    return myCapture.start(filename, raw, myRequestedSamplesPerSecond,
+                           myRequestedHardwareChannels, myRequestedBits);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundBuffer::stopCapture()
+{
+    myCapture.stop();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -3,9 +3,12 @@
 
 class OSystem;
 
+#include <atomic>
+
 #include "bspf.hxx"
 #include "TIASnd.hxx"
 #include "Sound.hxx"
+#include "audiocapture.h"
 
 class SoundBuffer : public Sound
 {
@@ -222,9 +225,20 @@ class SoundBuffer : public Sound
         int myFragmentSize;
         int myNumBits;
         int myNumSamplesPerSecond;
+        int myNumHardwareChannels;
         float myFramerate;
         bool fragmentParamsDirty;
 
+        // Output format requested by setFormat, applied by the audio thread
+        int myRequestedBits;
+        int myRequestedSamplesPerSecond;
+        int myRequestedHardwareChannels;
+        std::atomic<bool> myFormatDirty;
+
+        // Intermediate 16-bit samples when generating float output
+        unique_ptr<Int16[]> myConversionBuffer;
+        uInt32 myConversionBufferSize;
+
           // TIASound emulation object
         TIASound myTIASound;
 
@@ -237,7 +251,7 @@ class SoundBuffer : public Sound
         // Indicates the cycle when a sound register was last set
         Int32 myLastRegisterSetCycle;
 
-        // Indicates the number of channels (mono or stereo)
+        // Indicates the number of channels of the cart (mono or stereo)
         uInt32 myNumChannels;
 
         // Log base 2 of the selected fragment size
@@ -252,6 +266,9 @@ class SoundBuffer : public Sound
         // Indicates if the sound is currently muted
         bool myIsMuted;
 
+        // Indicates if register writes are currently discarded
+        bool mySuppressWrites;
+
         // Current volume as a percentage (0 - 100)
         uInt32 myVolume;
 
@@ -261,8 +278,16 @@ class SoundBuffer : public Sound
         // Queue of TIA register writes
         RegWriteQueue myRegWriteQueue;
 
+        // Records the generated fragments when capturing is active
+        AudioCapture myCapture;
+
     public:
         void update(uint8_t* buffer, int bufferLen);
+        bool setFormat(int sampleRate, int numChannels, int numBits) override;
+        bool startCapture(const string& filename, bool raw) override;
+        void stopCapture() override;
+        void suppressWrites(bool state) override { mySuppressWrites = state; }
+        const AudioCapture& capture() const { return myCapture; }
 
     private:
           // Callback function invoked by the SDL Audio library when it needs data
@@ -278,5 +303,6 @@ class SoundBuffer : public Sound
     private:
         void setPaused(bool enable);
         void setLock(bool lock);
+        void applyFormat();
             
 };
@@ -26,12 +26,12 @@ void Base::setHexUppercase(bool enable)
 {
     if (enable)
     {
-        myHexflags |= std::ios_base::uppercase;
+        myHexflags = std::ios_base::hex | std::ios_base::uppercase;
         myFmt = Base::myUpperFmt;
     }
     else
     {
-        myHexflags &= ~std::ios_base::uppercase;
+        myHexflags = std::ios_base::hex;
         myFmt = Base::myLowerFmt;
     }
 }
@@ -39,7 +39,8 @@ void Base::setHexUppercase(bool enable)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string Base::toString(int value, Common::Base::Format outputBase)
 {
-    static char vToS_buf[32];
+    char vToS_buf[32];
+    const char** fmt = myFmt;
 
     if (outputBase == Base::F_DEFAULT)
         outputBase = myDefaultBase;
@@ -71,26 +72,26 @@ string Base::toString(int value, Common::Base::Format outputBase)
             break;
 
         case Base::F_16_1:  // base 16: 1 byte wide
-            snprintf(vToS_buf, 2, myFmt[0], value);
+            snprintf(vToS_buf, 2, fmt[0], value);
             break;
         case Base::F_16_2:  // base 16: 2 bytes wide
-            snprintf(vToS_buf, 3, myFmt[1], value);
+            snprintf(vToS_buf, 3, fmt[1], value);
             break;
         case Base::F_16_4:  // base 16: 4 bytes wide
-            snprintf(vToS_buf, 5, myFmt[2], value);
+            snprintf(vToS_buf, 5, fmt[2], value);
             break;
         case Base::F_16_8:  // base 16: 8 bytes wide
-            snprintf(vToS_buf, 9, myFmt[3], value);
+            snprintf(vToS_buf, 9, fmt[3], value);
             break;
 
         case Base::F_16:    // base 16: 2, 4, 8 bytes (depending on value)
         default:
             if (value < 0x100)
-                snprintf(vToS_buf, 3, myFmt[1], value);
+                snprintf(vToS_buf, 3, fmt[1], value);
             else if (value < 0x10000)
-                snprintf(vToS_buf, 5, myFmt[2], value);
+                snprintf(vToS_buf, 5, fmt[2], value);
             else
-                snprintf(vToS_buf, 9, myFmt[3], value);
+                snprintf(vToS_buf, 9, fmt[3], value);
             break;
     }
 
@@ -98,10 +99,10 @@ string Base::toString(int value, Common::Base::Format outputBase)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Base::Format Base::myDefaultBase = Base::F_16;
+std::atomic<Base::Format> Base::myDefaultBase(Base::F_16);
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-std::ios_base::fmtflags Base::myHexflags = std::ios_base::hex;
+std::atomic<std::ios_base::fmtflags> Base::myHexflags(std::ios_base::hex);
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const char* Base::myLowerFmt[4] = {
@@ -110,6 +111,6 @@ const char* Base::myLowerFmt[4] = {
 const char* Base::myUpperFmt[4] = {
   "%1X", "%02X", "%04X", "%08X"
 };
-const char** Base::myFmt = Base::myLowerFmt;
+std::atomic<const char**> Base::myFmt(Base::myLowerFmt);
 
 } // Namespace Common
@@ -20,6 +20,7 @@
 #ifndef BASE_HXX
 #define BASE_HXX
 
+#include <atomic>
 #include <iostream>
 #include <iomanip>
 
@@ -81,17 +82,18 @@ class Base
         Common::Base::Format outputBase = Common::Base::F_DEFAULT);
 
     private:
-      // Default format to use when none is specified
-    static Format myDefaultBase;
+      // Default format to use when none is specified; the formats are
+      // shared by all instances, which may run on different threads
+    static std::atomic<Format> myDefaultBase;
 
     // Upper or lower case for HEX digits
-    static std::ios_base::fmtflags myHexflags;
+    static std::atomic<std::ios_base::fmtflags> myHexflags;
 
     // Format specifiers to use for sprintf (eventually we may convert
     // to C++ streams
     static const char* myLowerFmt[4];
     static const char* myUpperFmt[4];
-    static const char** myFmt;
+    static std::atomic<const char**> myFmt;
 
     private:
       // Following constructors and assignment operators not supported
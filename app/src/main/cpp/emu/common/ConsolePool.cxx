@@ -0,0 +1,336 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <chrono>
+#include <sstream>
+
+#include "MD5.hxx"
+#include "ConsolePool.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ConsolePool::ConsolePool(emu_instance_t* first, const string& prefs,
+    uInt32 capacity)
+    : myPrefs(prefs),
+    myCapacity(std::max(capacity, 2u)),
+    myClock(0),
+    myQuit(false),
+    myCurrent(first),
+    myPrevious(nullptr),
+    myHits(0),
+    myMisses(0),
+    myWaits(0),
+    myPrepared(0),
+    myHitMicros(0.0),
+    myMissMicros(0.0)
+{
+    // The first instance runs no ROM, so no MD5 finds it
+    myEntries.emplace_back(new Entry{ "", first, ++myClock, false, {} });
+
+    myBuilder = std::thread([this] { run(); });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ConsolePool::~ConsolePool()
+{
+    {
+        std::lock_guard<std::mutex> guard(myLock);
+        myQuit = true;
+        myJobs.clear();
+    }
+    myWork.notify_all();
+    myBuilder.join();
+
+    for (auto& entry : myEntries)
+        destroy(entry->emu);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConsolePool::prepare(const void* data, uInt32 size, const string& filename)
+{
+    string md5 = MD5::hash(static_cast<const uInt8*>(data), size);
+
+    {
+        std::lock_guard<std::mutex> guard(myLock);
+
+        if (find(md5) != nullptr)
+            return;
+        for (const Job& job : myJobs)
+            if (job.md5 == md5)
+                return;
+
+        myJobs.push_back({ md5, string(static_cast<const char*>(data), size), filename });
+    }
+    myWork.notify_one();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+emu_instance_t* ConsolePool::acquire(const void* data, uInt32 size,
+    const string& filename)
+{
+    auto start = std::chrono::steady_clock::now();
+    string md5 = MD5::hash(static_cast<const uInt8*>(data), size);
+
+    std::unique_lock<std::mutex> guard(myLock);
+
+    Entry* entry = find(md5);
+    bool hit = true;
+
+    // Wait for the thread of the pool if it is building the instance
+    if (entry != nullptr && entry->building)
+    {
+        ++myWaits;
+        myBuilt.wait(guard, [&] {
+            entry = find(md5);
+            return entry == nullptr || !entry->building;
+        });
+        hit = false;
+    }
+
+    // Not resident (or its build failed): build it right now, taking it
+    // off the queue of the thread if it is waiting there.  The entry is
+    // marked as being built first, so that nobody builds it once more.
+    if (entry == nullptr)
+    {
+        for (auto i = myJobs.begin(); i != myJobs.end(); ++i)
+        {
+            if (i->md5 == md5)
+            {
+                myJobs.erase(i);
+                break;
+            }
+        }
+
+        myEntries.emplace_back(new Entry{ md5, nullptr, ++myClock, true, {} });
+        entry = myEntries.back().get();
+
+        guard.unlock();
+        emu_instance_t* emu = build(data, size, filename);
+        guard.lock();
+
+        if (!finish(entry, emu))
+            return nullptr;
+        hit = false;
+    }
+
+    entry->lastUsed = ++myClock;
+    if (entry->emu != myCurrent)
+    {
+        myPrevious = myCurrent;
+        myCurrent = entry->emu;
+    }
+    replay(*entry);
+
+    double micros = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count();
+    if (hit)
+    {
+        ++myHits;
+        myHitMicros += micros;
+    }
+    else
+    {
+        ++myMisses;
+        myMissMicros += micros;
+    }
+
+    emu_instance_t* current = myCurrent;
+    trim();
+
+    return current;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int ConsolePool::command(int command, int param)
+{
+    std::lock_guard<std::mutex> guard(myLock);
+
+    int result = emu_instance_command(myCurrent, command, param);
+
+    switch (command)
+    {
+        case 11: // COMMAND_AUDIO_FORMAT
+        case 14: // COMMAND_RUNAHEAD
+        case 19: // COMMAND_PIPELINE
+            myCommands[command] = param;
+            for (auto& entry : myEntries)
+                if (entry->emu == myCurrent)
+                    entry->commands[command] = param;
+            break;
+        default:
+            break;
+    }
+
+    return result;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string ConsolePool::info()
+{
+    std::lock_guard<std::mutex> guard(myLock);
+
+    uInt32 resident = 0, building = 0;
+    for (const auto& entry : myEntries)
+    {
+        if (entry->building)
+            ++building;
+        else
+            ++resident;
+    }
+
+    ostringstream buf;
+    buf << "capacity=" << myCapacity
+        << " resident=" << resident
+        << " building=" << building
+        << " queued=" << myJobs.size()
+        << " prepared=" << myPrepared
+        << " hits=" << myHits
+        << " misses=" << myMisses
+        << " waits=" << myWaits
+        << " hitMicros=" << (myHits > 0 ? myHitMicros / myHits : 0.0)
+        << " missMicros=" << (myMisses > 0 ? myMissMicros / myMisses : 0.0);
+
+    return buf.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+emu_instance_t* ConsolePool::build(const void* data, uInt32 size,
+    const string& filename) const
+{
+    emu_instance_t* emu = emu_create(myPrefs.c_str(), EMU_CREATE_FLAG_HEADLESS);
+    if (emu == nullptr)
+        return nullptr;
+
+    if (emu_instance_load(emu, EMU_DATA_ROM, data, int(size), filename.c_str()) != 0)
+    {
+        destroy(emu);
+        return nullptr;
+    }
+
+    return emu;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConsolePool::destroy(emu_instance_t* emu)
+{
+    // Settings changed by an instance of the pool are dropped rather than
+    // saved, like the ones of ROM runs
+    delete emu;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ConsolePool::Entry* ConsolePool::find(const string& md5)
+{
+    for (auto& entry : myEntries)
+        if (entry->md5 == md5)
+            return entry.get();
+
+    return nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ConsolePool::finish(Entry* entry, emu_instance_t* emu)
+{
+    // Entries being built are never trimmed, so the entry is still there
+    if (emu != nullptr)
+    {
+        entry->emu = emu;
+        entry->building = false;
+    }
+    else
+    {
+        for (auto i = myEntries.begin(); i != myEntries.end(); ++i)
+        {
+            if (i->get() == entry)
+            {
+                myEntries.erase(i);
+                break;
+            }
+        }
+    }
+    myBuilt.notify_all();
+
+    return emu != nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConsolePool::replay(Entry& entry)
+{
+    for (const auto& command : myCommands)
+    {
+        auto given = entry.commands.find(command.first);
+        if (given == entry.commands.end() || given->second != command.second)
+        {
+            emu_instance_command(entry.emu, command.first, command.second);
+            entry.commands[command.first] = command.second;
+        }
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConsolePool::trim()
+{
+    for (;;)
+    {
+        uInt32 resident = 0;
+        auto oldest = myEntries.end();
+        for (auto i = myEntries.begin(); i != myEntries.end(); ++i)
+        {
+            const Entry& entry = **i;
+            if (entry.building)
+                continue;
+
+            ++resident;
+            if (entry.emu != myCurrent && entry.emu != myPrevious &&
+                (oldest == myEntries.end() || entry.lastUsed < (*oldest)->lastUsed))
+                oldest = i;
+        }
+
+        if (resident <= myCapacity || oldest == myEntries.end())
+            return;
+
+        destroy((*oldest)->emu);
+        myEntries.erase(oldest);
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConsolePool::run()
+{
+    std::unique_lock<std::mutex> guard(myLock);
+
+    for (;;)
+    {
+        myWork.wait(guard, [this] { return myQuit || !myJobs.empty(); });
+        if (myQuit)
+            return;
+
+        Job job = std::move(myJobs.front());
+        myJobs.pop_front();
+        myEntries.emplace_back(new Entry{ job.md5, nullptr, ++myClock, true, {} });
+        Entry* entry = myEntries.back().get();
+
+        guard.unlock();
+        emu_instance_t* emu = build(job.image.data(), uInt32(job.image.size()),
+                                    job.filename);
+        guard.lock();
+
+        if (finish(entry, emu))
+            ++myPrepared;
+
+        trim();
+    }
+}
@@ -0,0 +1,159 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef CONSOLE_POOL_HXX
+#define CONSOLE_POOL_HXX
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "bspf.hxx"
+#include "EmuInstance.hxx"
+
+/**
+  This class keeps the instances of the ROMs used last resident, so that
+  switching back to one of them is only a matter of handing out its
+  pointer.  An instance not handed out is simply not emulated, i.e.
+  paused where it was left.
+
+  Instances for ROMs expected next can be built ahead on a thread of the
+  pool.  Every instance is created with the same preferences, and the
+  ROMs are told apart by their MD5.  The least recently used instances
+  are destroyed when there are more than the capacity; the current and
+  the previous one always stay.
+
+  Commands which change how an instance is driven (audio format, run-ahead,
+  frame pipeline) are remembered and given to every instance handed out.
+*/
+class ConsolePool
+{
+    public:
+      /**
+        Create a pool for the given number of resident instances (at
+        least two), starting with an instance which has no ROM yet.
+        The pool owns it from now on.
+      */
+    ConsolePool(emu_instance_t* first, const string& prefs, uInt32 capacity);
+    ~ConsolePool();
+
+    public:
+      /**
+        Build the instance for a ROM on the thread of the pool, unless it
+        is resident or on its way already.
+      */
+    void prepare(const void* data, uInt32 size, const string& filename);
+
+    /**
+      Get the instance for a ROM, which becomes the current one.  It is
+      built right away if it isn't resident, or waited for if it is being
+      built.  The instance belongs to the pool; it stays valid until it
+      is destroyed to make room, after it has been neither the current
+      nor the previous one.
+
+      @return  The instance, or the null pointer if the ROM can't be run
+    */
+    emu_instance_t* acquire(const void* data, uInt32 size, const string& filename);
+
+    /**
+      Execute a command on the current instance, remembering it for the
+      others if it changes how instances are driven.
+    */
+    int command(int command, int param);
+
+    /**
+      The instance handed out last.
+    */
+    emu_instance_t* current() const { return myCurrent; }
+
+    /**
+      Answers statistics on the pool, as a string of key=value pairs.
+    */
+    string info();
+
+    private:
+    struct Entry {
+        string md5;
+        emu_instance_t* emu;  // null while it is being built
+        uInt64 lastUsed;
+        bool building;
+        std::map<int, int> commands;  // the sticky commands given to it
+    };
+
+    struct Job {
+        string md5;
+        string image;
+        string filename;
+    };
+
+    // Create an instance running the ROM, or the null pointer
+    emu_instance_t* build(const void* data, uInt32 size, const string& filename) const;
+
+    // Destroy an instance without saving its settings
+    static void destroy(emu_instance_t* emu);
+
+    // Find the entry of a ROM, or the null pointer
+    Entry* find(const string& md5);
+
+    // Fill in the instance of an entry marked as being built, or drop the
+    // entry if the build failed; wakes up whoever waits for it
+    bool finish(Entry* entry, emu_instance_t* emu);
+
+    // Give an instance the sticky commands it hasn't seen yet
+    void replay(Entry& entry);
+
+    // Destroy the least recently used instances beyond the capacity
+    void trim();
+
+    // Build the instances asked for, until told to quit
+    void run();
+
+    private:
+    string myPrefs;
+    uInt32 myCapacity;
+
+    std::mutex myLock;
+    std::condition_variable myBuilt;
+    std::condition_variable myWork;
+    std::deque<Job> myJobs;
+    vector<unique_ptr<Entry>> myEntries;
+    std::map<int, int> myCommands;
+    uInt64 myClock;
+    bool myQuit;
+
+    // The instances handed out last and before
+    emu_instance_t* myCurrent;
+    emu_instance_t* myPrevious;
+
+    // Statistics
+    uInt32 myHits, myMisses, myWaits, myPrepared;
+    double myHitMicros, myMissMicros;
+
+    std::thread myBuilder;
+
+    private:
+      // Following constructors and assignment operators not supported
+    ConsolePool() = delete;
+    ConsolePool(const ConsolePool&) = delete;
+    ConsolePool(ConsolePool&&) = delete;
+    ConsolePool& operator=(const ConsolePool&) = delete;
+    ConsolePool& operator=(ConsolePool&&) = delete;
+};
+
+#endif
@@ -0,0 +1,33 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef EMU_INSTANCE_HXX
+#define EMU_INSTANCE_HXX
+
+#include "bspf.hxx"
+#include "OSystem.hxx"
+
+#include "../../emu_bindings.h"
+
+// An emulator instance: the parent osystem object and the ROM it runs
+struct emu_instance
+{
+    unique_ptr<OSystem> osystem;
+    unique_ptr<Rom> rom;
+};
+
+#endif
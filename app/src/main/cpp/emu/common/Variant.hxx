@@ -37,10 +37,12 @@ class Variant
       // Underlying data store is (currently) always a string
     string data;
 
-    // Use singleton so we use only one ostringstream object
-    inline ostringstream& buf() {
-        static ostringstream buf;
-        return buf;
+    // Each conversion uses its own stream, so that settings of different
+    // instances can be changed from different threads
+    template<typename T> static string toData(const T& value) {
+        ostringstream buf;
+        buf << value;
+        return buf.str();
     }
 
     public:
@@ -49,12 +51,12 @@ class Variant
     Variant(const string& s) : data(s) { }
     Variant(const char* s) : data(s) { }
 
-    Variant(Int32 i) { buf().str(""); buf() << i; data = buf().str(); }
-    Variant(uInt32 i) { buf().str(""); buf() << i; data = buf().str(); }
-    Variant(float f) { buf().str(""); buf() << f; data = buf().str(); }
-    Variant(double d) { buf().str(""); buf() << d; data = buf().str(); }
-    Variant(bool b) { buf().str(""); buf() << b; data = buf().str(); }
-    Variant(const GUI::Size& s) { buf().str(""); buf() << s; data = buf().str(); }
+    Variant(Int32 i) : data(toData(i)) { }
+    Variant(uInt32 i) : data(toData(i)) { }
+    Variant(float f) : data(toData(f)) { }
+    Variant(double d) : data(toData(d)) { }
+    Variant(bool b) : data(toData(b)) { }
+    Variant(const GUI::Size& s) : data(toData(s)) { }
 
     // Conversion methods
     const string& toString() const { return data; }
@@ -0,0 +1,162 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "WorkerPool.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+WorkerPool::WorkerPool(uInt32 threads)
+    : myTask(nullptr),
+    myGeneration(0),
+    myBusy(0),
+    myQuit(false)
+{
+    if (threads == 0)
+        threads = BSPF::clamp(std::thread::hardware_concurrency(), 1u, 64u);
+
+    myShares = unique_ptr<Share[]>(new Share[threads]);
+    for (uInt32 i = 0; i < threads; ++i)
+        myShares[i].begin = myShares[i].end = 0;
+
+    for (uInt32 i = 1; i < threads; ++i)
+        myThreads.emplace_back(&WorkerPool::loop, this, i);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(myLock);
+        myQuit = true;
+    }
+    myStart.notify_all();
+
+    for (auto& thread : myThreads)
+        thread.join();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void WorkerPool::run(uInt32 count, const std::function<void(uInt32)>& task)
+{
+    if (count == 0)
+        return;
+
+    // Not worth waking anybody up for a single item
+    if (count == 1 || myThreads.empty())
+    {
+        for (uInt32 i = 0; i < count; ++i)
+            task(i);
+        return;
+    }
+
+    uInt32 threads = size();
+    for (uInt32 i = 0; i < threads; ++i)
+    {
+        myShares[i].begin = uInt32(uInt64(count) * i / threads);
+        myShares[i].end = uInt32(uInt64(count) * (i + 1) / threads);
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(myLock);
+        myTask = &task;
+        myBusy = uInt32(myThreads.size());
+        ++myGeneration;
+    }
+    myStart.notify_all();
+
+    work(0);
+
+    std::unique_lock<std::mutex> guard(myLock);
+    myDone.wait(guard, [this] { return myBusy == 0; });
+    myTask = nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool WorkerPool::take(uInt32 thread, uInt32& item)
+{
+    Share& share = myShares[thread];
+    std::lock_guard<std::mutex> guard(share.lock);
+    if (share.begin == share.end)
+        return false;
+
+    item = share.begin++;
+    return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool WorkerPool::steal(uInt32 thread, uInt32& item)
+{
+    uInt32 threads = size();
+    for (uInt32 i = 1; i < threads; ++i)
+    {
+        uInt32 begin, end;
+        {
+            Share& victim = myShares[(thread + i) % threads];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (victim.begin == victim.end)
+                continue;
+
+            end = victim.end;
+            begin = end - (end - victim.begin + 1) / 2;
+            victim.end = begin;
+        }
+
+        // Nobody steals from an empty share, so it can be refilled
+        Share& share = myShares[thread];
+        std::lock_guard<std::mutex> guard(share.lock);
+        item = begin;
+        share.begin = begin + 1;
+        share.end = end;
+
+        return true;
+    }
+
+    return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void WorkerPool::work(uInt32 thread)
+{
+    uInt32 item;
+    while (take(thread, item) || steal(thread, item))
+        (*myTask)(item);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void WorkerPool::loop(uInt32 thread)
+{
+    uInt32 generation = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> guard(myLock);
+            myStart.wait(guard, [&] { return myQuit || myGeneration != generation; });
+            if (myQuit)
+                break;
+            generation = myGeneration;
+        }
+
+        work(thread);
+
+        bool last;
+        {
+            std::lock_guard<std::mutex> guard(myLock);
+            last = --myBusy == 0;
+        }
+        if (last)
+            myDone.notify_one();
+    }
+}
@@ -0,0 +1,106 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef WORKER_POOL_HXX
+#define WORKER_POOL_HXX
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "bspf.hxx"
+
+/**
+  This class keeps a number of threads around to run the same task on
+  many items in parallel.
+
+  The calling thread works on the items as well.  Every thread starts
+  with an equal share of the items, and takes them from the front; a
+  thread out of items steals half of what is left to another, from the
+  back.  So items of very different cost (e.g. whole ROM runs) still
+  keep all threads busy, while threads rarely touch the same share.
+*/
+class WorkerPool
+{
+    public:
+      /**
+        Create a pool of the given number of threads, including the one
+        calling run() (0 for one thread per core).
+      */
+    explicit WorkerPool(uInt32 threads = 0);
+    ~WorkerPool();
+
+    public:
+      /**
+        The number of threads working on a run, including the caller.
+      */
+    uInt32 size() const { return uInt32(myThreads.size()) + 1; }
+
+    /**
+      Call the task for the items 0 to count-1, and wait until all of
+      them are done.  Only one thread may call run() at a time.
+    */
+    void run(uInt32 count, const std::function<void(uInt32)>& task);
+
+    private:
+      // The items [begin, end) not yet taken from a thread's share
+    struct Share {
+        std::mutex lock;
+        uInt32 begin;
+        uInt32 end;
+    };
+
+    // Take the next item of the given thread's share
+    bool take(uInt32 thread, uInt32& item);
+
+    // Move half of the items left to another thread into the given
+    // thread's share, and take the first of them
+    bool steal(uInt32 thread, uInt32& item);
+
+    // Work on the items of the current run, until none are left
+    void work(uInt32 thread);
+
+    // Wait for runs, until told to quit
+    void loop(uInt32 thread);
+
+    private:
+    vector<std::thread> myThreads;
+
+    // The current run: the task, and the share of every thread (the
+    // caller being the first)
+    const std::function<void(uInt32)>* myTask;
+    unique_ptr<Share[]> myShares;
+
+    // Every run gets a new generation; the workers wait for the next one,
+    // and the caller for the workers to be done with it
+    std::mutex myLock;
+    std::condition_variable myStart;
+    std::condition_variable myDone;
+    uInt32 myGeneration;
+    uInt32 myBusy;
+    bool myQuit;
+
+    private:
+      // Following constructors and assignment operators not supported
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool(WorkerPool&&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    WorkerPool& operator=(WorkerPool&&) = delete;
+};
+
+#endif
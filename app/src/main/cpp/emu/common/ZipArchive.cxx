@@ -0,0 +1,272 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "ZipArchive.hxx"
+
+namespace {
+    enum {
+        kLocalHeaderSignature = 0x04034b50,
+        kLocalHeaderSize = 30,
+        kCentralHeaderSignature = 0x02014b50,
+        kCentralHeaderSize = 46,
+        kEndSignature = 0x06054b50,
+        kEndSize = 22,
+        kMaxCommentSize = 0xffff,
+
+        kMethodStored = 0,
+        kMethodDeflated = 8,
+        kFlagEncrypted = 0x0001,
+        kFlagUtf8 = 0x0800
+    };
+
+    // Fields of the archive are little endian, and not aligned
+    inline uInt16 get16(const uInt8* p)
+    {
+        return uInt16(p[0] | (p[1] << 8));
+    }
+
+    inline uInt32 get32(const uInt8* p)
+    {
+        return uInt32(p[0]) | (uInt32(p[1]) << 8) | (uInt32(p[2]) << 16) |
+               (uInt32(p[3]) << 24);
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ZipArchive::ZipArchive()
+    : myMapping(MAP_FAILED),
+    myMappingSize(0),
+    myData(nullptr),
+    mySize(0),
+    myUtf8Names(true)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ZipArchive::~ZipArchive()
+{
+    if (myMapping != MAP_FAILED)
+        munmap(myMapping, myMappingSize);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<ZipArchive> ZipArchive::open(const string& path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return nullptr;
+
+    shared_ptr<ZipArchive> archive = open(fd, 0, 0);
+    close(fd);
+
+    return archive;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<ZipArchive> ZipArchive::open(int fd, uInt64 offset, uInt64 length)
+{
+    shared_ptr<ZipArchive> archive(new ZipArchive());
+    if (!archive->map(fd, offset, length) || !archive->index())
+        return nullptr;
+
+    return archive;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const ZipArchive::Entry* ZipArchive::find(const string& name) const
+{
+    auto i = myIndex.find(name);
+
+    return i != myIndex.end() ? &myEntries[i->second] : nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomImage ZipArchive::load(const string& name) const
+{
+    const Entry* entry = find(name);
+    if (entry == nullptr || entry->size == 0 || entry->size > kMaxEntrySize)
+        return RomImage();
+
+    const uInt8* data = entryData(*entry);
+    if (data == nullptr)
+        return RomImage();
+
+    RomImage image;
+    if (entry->method == kMethodStored)
+    {
+        if (entry->compressedSize != entry->size)
+            return RomImage();
+
+        image = RomImage(data, entry->size);
+    }
+    else
+    {
+        image = RomImage(nullptr, entry->size);
+
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+            return RomImage();
+
+        // The entry is raw deflate data, without the zlib header
+        stream.next_in = const_cast<Bytef*>(data);
+        stream.avail_in = entry->compressedSize;
+        stream.next_out = image.writable();
+        stream.avail_out = entry->size;
+
+        int result = inflate(&stream, Z_FINISH);
+        uLong inflated = stream.total_out;
+        inflateEnd(&stream);
+
+        if (result != Z_STREAM_END || inflated != entry->size)
+            return RomImage();
+    }
+
+    if (crc32(crc32(0, Z_NULL, 0), image.data(), entry->size) != entry->crc)
+        return RomImage();
+
+    return image;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ZipArchive::map(int fd, uInt64 offset, uInt64 length)
+{
+    struct stat info;
+    if (fstat(fd, &info) != 0 || uInt64(info.st_size) <= offset)
+        return false;
+
+    if (length == 0 || offset + length > uInt64(info.st_size))
+        length = uInt64(info.st_size) - offset;
+
+    // Mappings start at a page boundary
+    uInt64 page = uInt64(sysconf(_SC_PAGESIZE));
+    uInt64 start = offset - offset % page;
+
+    myMappingSize = size_t(offset - start + length);
+    myMapping = mmap(nullptr, myMappingSize, PROT_READ, MAP_PRIVATE, fd, off_t(start));
+    if (myMapping == MAP_FAILED)
+        return false;
+
+    myData = static_cast<const uInt8*>(myMapping) + (offset - start);
+    mySize = length;
+
+    return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ZipArchive::index()
+{
+    if (mySize < kEndSize)
+        return false;
+
+    // The end of central directory record is followed by a comment of up
+    // to 64K, so look for its signature backwards from the end
+    uInt64 lowest = mySize > kEndSize + kMaxCommentSize ?
+        mySize - kEndSize - kMaxCommentSize : 0;
+    const uInt8* end = nullptr;
+    for (uInt64 pos = mySize - kEndSize + 1; pos-- > lowest; )
+    {
+        if (get32(myData + pos) == kEndSignature &&
+            pos + kEndSize + get16(myData + pos + 20) <= mySize)
+        {
+            end = myData + pos;
+            break;
+        }
+    }
+    if (end == nullptr)
+        return false;
+
+    uInt32 count = get16(end + 10);
+    uInt32 directorySize = get32(end + 12);
+    uInt32 directoryOffset = get32(end + 16);
+
+    // Archives spanning disks or needing ZIP64 aren't supported
+    if (get16(end + 4) != 0 || get16(end + 6) != 0 || count == 0xffff ||
+        directoryOffset == 0xffffffff ||
+        uInt64(directoryOffset) + directorySize > mySize)
+        return false;
+
+    const uInt8* p = myData + directoryOffset;
+    const uInt8* last = p + directorySize;
+
+    myEntries.reserve(count);
+    for (uInt32 i = 0; i < count; ++i)
+    {
+        if (last - p < kCentralHeaderSize || get32(p) != kCentralHeaderSignature)
+            return false;
+
+        uInt32 nameSize = get16(p + 28);
+        uInt32 recordSize = kCentralHeaderSize + nameSize +
+            get16(p + 30) + get16(p + 32);
+        if (uInt64(last - p) < recordSize)
+            return false;
+
+        Entry entry;
+        entry.name.assign(reinterpret_cast<const char*>(p + kCentralHeaderSize), nameSize);
+        entry.method = get16(p + 10);
+        entry.crc = get32(p + 16);
+        entry.compressedSize = get32(p + 20);
+        entry.size = get32(p + 24);
+        entry.localOffset = get32(p + 42);
+
+        // Names without the flag are CP437, which only agrees with UTF-8
+        // on ASCII
+        entry.utf8 = (get16(p + 8) & kFlagUtf8) != 0 ||
+            std::all_of(entry.name.begin(), entry.name.end(),
+                        [](char c) { return (c & 0x80) == 0; });
+
+        // Leave out directories and what can't be loaded anyway
+        bool usable = !entry.name.empty() && entry.name.back() != '/' &&
+            (get16(p + 8) & kFlagEncrypted) == 0 &&
+            (entry.method == kMethodStored || entry.method == kMethodDeflated);
+
+        if (usable && myIndex.find(entry.name) == myIndex.end())
+        {
+            myIndex[entry.name] = uInt32(myEntries.size());
+            myUtf8Names = myUtf8Names && entry.utf8;
+            myEntries.push_back(std::move(entry));
+        }
+
+        p += recordSize;
+    }
+
+    return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uInt8* ZipArchive::entryData(const Entry& entry) const
+{
+    // The local header repeats the name, but may have its own extra field
+    uInt64 header = entry.localOffset;
+    if (header + kLocalHeaderSize > mySize ||
+        get32(myData + header) != kLocalHeaderSignature)
+        return nullptr;
+
+    uInt64 data = header + kLocalHeaderSize + get16(myData + header + 26) +
+        get16(myData + header + 28);
+    if (data + entry.compressedSize > mySize)
+        return nullptr;
+
+    return myData + data;
+}
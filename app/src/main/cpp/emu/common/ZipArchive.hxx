@@ -0,0 +1,137 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef ZIP_ARCHIVE_HXX
+#define ZIP_ARCHIVE_HXX
+
+#include <unordered_map>
+
+#include "bspf.hxx"
+#include "RomImage.hxx"
+
+/**
+  This class reads the entries of a zip archive in place.  The archive is
+  mapped into memory read-only, and its central directory indexed once
+  when it is opened; listing it or loading an entry never extracts
+  anything to a file.
+
+  A stored entry is copied from the mapping into its image, and a
+  deflated entry inflated straight into it.  Images never point into the
+  mapping: the file may be truncated or replaced while a game runs, and
+  reading a page of it then would raise SIGBUS.
+
+  Only what ROM archives need is supported: entries stored or deflated,
+  not encrypted, and no ZIP64.
+*/
+class ZipArchive
+{
+    public:
+      // An entry of the central directory
+    struct Entry {
+        string name;
+        uInt16 method;
+        uInt32 crc;
+        uInt32 compressedSize;
+        uInt32 size;
+        uInt32 localOffset;   // of the local header
+        bool utf8;            // the name is UTF-8 (flagged, or plain ASCII)
+    };
+
+    // The largest entry loaded; no cart comes near it
+    enum { kMaxEntrySize = 16 * 1024 * 1024 };
+
+    /**
+      Open the archive in the given file.
+
+      @return  The archive, or the null pointer if it can't be read
+    */
+    static shared_ptr<ZipArchive> open(const string& path);
+
+    /**
+      Open the archive in a piece of the given file, i.e. an asset
+      within an application package.  The descriptor is only used while
+      opening, and can be closed afterwards.
+
+      @param offset  The start of the archive in the file
+      @param length  The size of the archive, 0 for the rest of the file
+      @return  The archive, or the null pointer if it can't be read
+    */
+    static shared_ptr<ZipArchive> open(int fd, uInt64 offset, uInt64 length);
+
+    ~ZipArchive();
+
+    public:
+      /**
+        The entries of the archive, in the order of its central directory
+        (directories left out).
+      */
+    const vector<Entry>& entries() const { return myEntries; }
+
+    /**
+      Whether the names of all entries are UTF-8; names of archives made
+      without the UTF-8 flag are usually CP437.
+    */
+    bool utf8Names() const { return myUtf8Names; }
+
+    /**
+      Get the entry of the given name.
+
+      @return  The entry, or the null pointer if there is none
+    */
+    const Entry* find(const string& name) const;
+
+    /**
+      Load the given entry, checking its CRC.
+
+      @return  The image of the entry, empty if it can't be loaded
+    */
+    RomImage load(const string& name) const;
+
+    private:
+    ZipArchive();
+
+    // Map the piece of the file, and index its central directory
+    bool map(int fd, uInt64 offset, uInt64 length);
+    bool index();
+
+    // Get the data of the entry within the mapping, or the null pointer
+    // if it lies outside
+    const uInt8* entryData(const Entry& entry) const;
+
+    private:
+    // The mapping, which starts at a page boundary, possibly before the
+    // archive
+    void* myMapping;
+    size_t myMappingSize;
+
+    // The archive within the mapping
+    const uInt8* myData;
+    uInt64 mySize;
+
+    vector<Entry> myEntries;
+    std::unordered_map<string, uInt32> myIndex;
+    bool myUtf8Names;
+
+    private:
+      // Following constructors and assignment operators not supported
+    ZipArchive(const ZipArchive&) = delete;
+    ZipArchive(ZipArchive&&) = delete;
+    ZipArchive& operator=(const ZipArchive&) = delete;
+    ZipArchive& operator=(ZipArchive&&) = delete;
+};
+
+#endif
@@ -17,7 +17,11 @@
 // $Id: main.cxx 3308 2016-05-24 16:55:45Z stephena $
 //============================================================================
 
+#include <chrono>
 #include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <mutex>
 
 #include "bspf.hxx"
 ////#include "MediaFactory.hxx"
@@ -31,6 +35,12 @@
 ////#include "FSNode.hxx"
 #include "OSystem.hxx"
 #include "System.hxx"
+#include "StateManager.hxx"
+#include "Control.hxx"
+#include "MT24LC256.hxx"
+#include "TIA.hxx"
+#include "Batch.hxx"
+#include "WorkerPool.hxx"
 
 #ifdef DEBUGGER_SUPPORT
 #include "Debugger.hxx"
@@ -40,131 +50,610 @@
 #include "CheatManager.hxx"
 #endif
 
-#include "../../emu_bindings.h"
+#include "EmuInstance.hxx"
+#include "ConsolePool.hxx"
+#include "SharedContext.hxx"
+#include "ZipArchive.hxx"
 
-// Pointer to the main parent osystem object or the null pointer
-unique_ptr<OSystem> theOSystem;
-unique_ptr<Rom> theRom;
+// A batch of instances stepped together
+struct emu_batch
+{
+    unique_ptr<Batch> batch;
+};
+
+// The resident instances of a frontend switching between ROMs
+struct emu_pool
+{
+    unique_ptr<ConsolePool> pool;
+};
+
+// A zip archive ROMs are loaded from
+struct emu_archive
+{
+    shared_ptr<const ZipArchive> archive;
+};
+
+// The instance behind the handle-less functions, or the null pointer
+static emu_instance_t* theDefaultInstance = nullptr;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Does general Cleanup in case any operation failed (or at end of program);
+// headless instances may run on several threads at once, and only an
+// instance with a frontend saves its settings
+static int Cleanup(OSystem& osystem)
+{
+    osystem.logMessage("Cleanup from main", 2);
+    if (!osystem.headless())
+        osystem.saveConfig();
+
+    return 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Returns the EEPROM of the controller plugged in (if any)
+static MT24LC256* FindEEPROM(OSystem& osystem)
+{
+    if (!osystem.hasConsole())
+        return nullptr;
+
+    MT24LC256* eeprom = osystem.console().leftController().eeprom();
+    if (eeprom == nullptr)
+        eeprom = osystem.console().rightController().eeprom();
+
+    return eeprom;
+}
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-// Does general Cleanup in case any operation failed (or at end of program)
-int Cleanup()
+// Copies a value into the caller's buffer; a value that doesn't fit is
+// returned as the empty string
+static int CopyToBuffer(const std::string& value, char* buffer, int buffer_size)
 {
-    theOSystem->logMessage("Cleanup from main", 2);
-    theOSystem->saveConfig();
+    if (NULL == buffer || buffer_size <= 0) return 0;
+    *buffer = '\0';
+
+    if (value.length() > 0 && value.length() < size_t(buffer_size))
+    {
+        strcpy(buffer, value.c_str());
+    }
+
+    return strlen(buffer);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Creates the console of the ROM the instance has been given
+static int StartRom(emu_instance_t* emu)
+{
+    OSystem& osystem = *emu->osystem;
+
+    const string& result = osystem.createConsole(*emu->rom);
+    if (result != EmptyString)
+    {
+        Cleanup(osystem);
+        return -1;
+    }
+
+    osystem.eventHandler().leaveMenuMode();
 
     return 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Creates an instance for the ROM of the run, and emulates its frames
+static void RunRom(emu_run_t& run, const char* prefs)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    run.hash = 2166136261u;
+    run.micros = 0.0;
+    run.status = EMU_RUN_OK;
+
+    const void* data = run.data;
+    int dataSize = run.data_size;
+    vector<char> image;
+    if (NULL != run.path)
+    {
+        std::ifstream in(run.path, std::ios::binary);
+        if (in)
+            image.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        if (image.empty())
+        {
+            run.status = EMU_RUN_ERROR_READ;
+            return;
+        }
+        data = image.data();
+        dataSize = int(image.size());
+    }
+
+    emu_instance_t* emu = emu_create(prefs, EMU_CREATE_FLAG_HEADLESS);
+    if (NULL == emu)
+    {
+        run.status = EMU_RUN_ERROR_INSTANCE;
+        return;
+    }
+
+    if (emu_instance_load(emu, EMU_DATA_ROM, data, dataSize,
+                          NULL != run.path ? run.path : "") != 0)
+    {
+        run.status = EMU_RUN_ERROR_CONSOLE;
+    }
+    else
+    {
+        try
+        {
+            TIA& tia = emu->osystem->console().tia();
+            for (int frame = 0; frame < run.frames; frame++)
+            {
+                tia.update();
+
+                // 32 bit FNV-1a of the frame, folded into the one of the run
+                const uInt8* pixels = tia.currentFrameBuffer();
+                uInt32 size = tia.width() * tia.height();
+                uInt32 hash = 2166136261u;
+                for (uInt32 i = 0; i < size; i++)
+                    hash = (hash ^ pixels[i]) * 16777619u;
+
+                if (NULL != run.frame_hashes)
+                    run.frame_hashes[frame] = hash;
+                run.hash = (run.hash ^ hash) * 16777619u;
+            }
+        }
+        catch (...)
+        {
+            cerr << "ERROR: RunRom " << (NULL != run.path ? run.path : "") << endl;
+            run.status = EMU_RUN_ERROR_EMULATION;
+        }
+    }
+
+    // Settings changed by the run are dropped rather than saved, since
+    // all runs would write the same config file
+    delete emu;
+
+    run.micros = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
 extern "C" {
 
-    int DLLBINDING emu_init(const char* prefs, int flags)
+    emu_instance_t* DLLBINDING emu_create(const char* prefs, int flags)
     {
-        std::ios_base::sync_with_stdio(false);
+        // Instances may be created on several threads at once
+        static std::once_flag unsynced;
+        std::call_once(unsynced, [] { std::ios_base::sync_with_stdio(false); });
+
+        unique_ptr<emu_instance_t> emu = make_ptr<emu_instance_t>();
 
         // Create the parent OSystem object
-        theOSystem = make_ptr<OSystem>();
-        theOSystem->loadConfig();
-        theOSystem->logMessage("Loading config options ...", 2);
+        emu->osystem = make_ptr<OSystem>();
+        OSystem& osystem = *emu->osystem;
+        osystem.setHeadless((flags & EMU_CREATE_FLAG_HEADLESS) != 0);
+        osystem.loadConfig();
+        osystem.logMessage("Loading config options ...", 2);
+
+        // Apply the preferences handed over by the frontend
+        if (NULL != prefs)
+        {
+            osystem.settings().loadPrefs(prefs);
+        }
 
         // Take care of commandline arguments
-        theOSystem->logMessage("Loading commandline arguments ...", 2);
-        ////string romfile = "game.bin"; // theOSystem->settings().loadCommandLine(argc, argv);
+        osystem.logMessage("Loading commandline arguments ...", 2);
+        ////string romfile = "game.bin"; // osystem.settings().loadCommandLine(argc, argv);
 
         // Finally, make sure the settings are valid
         // We do it once here, so the rest of the program can assume valid settings
-        theOSystem->logMessage("Validating config options ...", 2);
-        theOSystem->settings().validate();
+        osystem.logMessage("Validating config options ...", 2);
+        osystem.settings().validate();
 
         // Create the full OSystem after the settings, since settings are
         // probably needed for defaults
-        theOSystem->logMessage("Creating the OSystem ...", 2);
-        if (!theOSystem->create())
+        osystem.logMessage("Creating the OSystem ...", 2);
+        if (!osystem.create())
         {
-            theOSystem->logMessage("ERROR: Couldn't create OSystem", 0);
-            Cleanup();
-            return -1;
+            osystem.logMessage("ERROR: Couldn't create OSystem", 0);
+            Cleanup(osystem);
+            return NULL;
         }
 
-        theRom = make_ptr<Rom>();
+        emu->rom = make_ptr<Rom>();
 
-        return 0;
+        return emu.release();
     }
 
-    int DLLBINDING emu_input(int keyCode, int state)
+    int DLLBINDING emu_destroy(emu_instance_t* emu)
     {
+        if (NULL == emu) return -1;
+
+        Cleanup(*emu->osystem);
+        emu->osystem->quit();
+        emu->osystem = nullptr;
+
+        emu->rom->free();
+        emu->rom = nullptr;
+
+        delete emu;
+
         return 0;
     }
 
-    int DLLBINDING emu_load(int data_type, const void* data, int data_size, const char* filename)
+    int DLLBINDING emu_instance_input(emu_instance_t* emu, int keyCode, int state)
     {
-        theOSystem->eventHandler().enterMenuMode(EventHandler::S_MENU);
+        return emu->osystem->input(keyCode, state) ? 1 : 0;
+    }
 
-        theRom->create(data, data_size, filename);
+    int DLLBINDING emu_instance_load(emu_instance_t* emu, int data_type, const void* data,
+                                     int data_size, const char* filename)
+    {
+        OSystem& osystem = *emu->osystem;
 
-        const string& result = theOSystem->createConsole(*theRom);
-        if (result != EmptyString)
+        if (data_type == EMU_DATA_SNAPSHOT)
         {
-            Cleanup();
-            return -1;
+            return osystem.state().restoreState(
+                static_cast<const uInt8*>(data), uInt32(data_size)) ? 0 : -1;
         }
 
-        theOSystem->eventHandler().leaveMenuMode();
+        if (data_type == EMU_DATA_NVRAM)
+        {
+            MT24LC256* eeprom = FindEEPROM(osystem);
+            if (eeprom == nullptr || NULL == data || data_size != MT24LC256::kDataSize)
+                return -1;
 
-        return 0;
+            eeprom->setData(static_cast<const uInt8*>(data));
+            return 0;
+        }
+
+        osystem.eventHandler().enterMenuMode(EventHandler::S_MENU);
+
+        emu->rom->create(data, data_size, filename);
+
+        return StartRom(emu);
     }
 
-    int DLLBINDING emu_store(int data_type, void* buffer, int buffer_size)
+    // The entry is loaded without extracting it: a stored one is used in
+    // place, a deflated one inflated straight into the image of the ROM
+    int DLLBINDING emu_instance_load_archive(emu_instance_t* emu, emu_archive_t* archive,
+                                             const char* entry)
     {
+        if (NULL == emu || NULL == archive || NULL == entry) return -1;
+
+        RomImage image = archive->archive->load(entry);
+        if (image.empty()) return -1;
+
+        emu->osystem->eventHandler().enterMenuMode(EventHandler::S_MENU);
+
+        emu->rom->create(image, entry);
+
+        return StartRom(emu);
+    }
+
+    // Returns the size of the data; it is only written if the buffer is
+    // large enough, so passing no buffer queries the size to allocate
+    int DLLBINDING emu_instance_store(emu_instance_t* emu, int data_type, void* buffer,
+                                      int buffer_size)
+    {
+        OSystem& osystem = *emu->osystem;
+        uInt32 size = buffer_size > 0 ? uInt32(buffer_size) : 0;
+
+        if (data_type == EMU_DATA_SNAPSHOT)
+        {
+            return int(osystem.state().storeState(
+                static_cast<uInt8*>(buffer), size));
+        }
+
+        if (data_type == EMU_DATA_NVRAM)
+        {
+            MT24LC256* eeprom = FindEEPROM(osystem);
+            if (eeprom == nullptr)
+                return 0;
+
+            if (NULL != buffer && size >= MT24LC256::kDataSize)
+                memcpy(buffer, eeprom->getData(), MT24LC256::kDataSize);
+
+            return MT24LC256::kDataSize;
+        }
+
         return 0;
     }
 
-    int DLLBINDING emu_command(int command, int param)
+    int DLLBINDING emu_instance_command(emu_instance_t* emu, int command, int param)
     {
-        return theOSystem->execCommand(command, param);
+        return emu->osystem->execCommand(command, param);
     }
 
-    int DLLBINDING emu_update_input(int joystickInput, int flags)
+    int DLLBINDING emu_instance_update_input(emu_instance_t* emu, int joystickInput, int flags)
     {
-        return theOSystem->updateInput(joystickInput, flags);
+        return emu->osystem->updateInput(joystickInput, flags);
     }
 
-    int DLLBINDING emu_update_audio(void* buffer, int bufferLen, int flags)
+    int DLLBINDING emu_instance_update_audio(emu_instance_t* emu, void* buffer, int bufferLen,
+                                             int flags)
     {
-        return theOSystem->updateAudio(buffer, bufferLen, flags);
+        return emu->osystem->updateAudio(buffer, bufferLen, flags);
     }
 
-    int DLLBINDING emu_update_video(emu_update_info_t* update_info, int flags)
+    int DLLBINDING emu_instance_update_video(emu_instance_t* emu,
+                                             emu_update_info_t* update_info, int flags)
     {
-        return theOSystem->updateVideo(update_info, flags);
+        return emu->osystem->updateVideo(update_info, flags);
     }
 
-    int DLLBINDING emu_get(const char* key, char* buffer, int buffer_size)
+    int DLLBINDING emu_instance_get(emu_instance_t* emu, const char* key, char* buffer,
+                                    int buffer_size)
     {
         if (NULL == key || NULL == buffer) return 0;
-        *buffer = '\0';
 
         std::string cstrKey = key;
-        std::string cstrValue = theOSystem->getAttribute(cstrKey);
+        std::string cstrValue = emu->osystem->getAttribute(cstrKey);
+
+        return CopyToBuffer(cstrValue, buffer, buffer_size);
+    }
+
+    emu_batch_t* DLLBINDING emu_batch_create(emu_instance_t* const* envs, int n_envs,
+                                             int n_threads)
+    {
+        if (NULL == envs || n_envs <= 0 || n_threads < 0) return NULL;
+
+        vector<OSystem*> osystems;
+        for (int i = 0; i < n_envs; i++)
+        {
+            if (NULL == envs[i]) return NULL;
+
+            // An instance can only be stepped by one thread at a time
+            for (int j = 0; j < i; j++)
+            {
+                if (envs[j] == envs[i]) return NULL;
+            }
+
+            osystems.push_back(envs[i]->osystem.get());
+        }
 
-        if (cstrValue.length() > 0 && cstrValue.length() < buffer_size)
+        // Environments are stepped without a frontend
+        for (OSystem* osystem : osystems)
         {
-            strcpy(buffer, cstrValue.c_str());
+            osystem->setHeadless(true);
         }
 
-        return strlen(buffer);
+        unique_ptr<emu_batch_t> batch = make_ptr<emu_batch_t>();
+        batch->batch = make_ptr<Batch>(osystems, uInt32(n_threads));
+
+        return batch.release();
     }
 
-    int DLLBINDING emu_shutdown()
+    int DLLBINDING emu_batch_destroy(emu_batch_t* batch)
+    {
+        if (NULL == batch) return -1;
+
+        delete batch;
+
+        return 0;
+    }
+
+    int DLLBINDING emu_batch_observation_size(int observation_type)
+    {
+        return (int) Batch::observationSize(observation_type);
+    }
+
+    int DLLBINDING emu_batch_step(emu_batch_t* batch, const int* actions, int frames_per_step,
+                                  const emu_batch_output_t* output)
+    {
+        if (NULL == batch || NULL == output || frames_per_step <= 0) return -1;
+
+        return batch->batch->step(actions, uInt32(frames_per_step), *output) ? 0 : -1;
+    }
+
+    // Returns the number of runs that went fine
+    int DLLBINDING emu_run_roms(emu_run_t* runs, int n_runs, const char* prefs, int n_threads)
+    {
+        if (NULL == runs || n_runs < 0 || n_threads < 0) return -1;
+
+        WorkerPool pool(static_cast<uInt32>(n_threads));
+        pool.run(uInt32(n_runs), [&](uInt32 index) { RunRom(runs[index], prefs); });
+
+        int passed = 0;
+        for (int i = 0; i < n_runs; i++)
+        {
+            if (runs[i].status == EMU_RUN_OK) passed++;
+        }
+
+        return passed;
+    }
+
+    emu_pool_t* DLLBINDING emu_pool_create(emu_instance_t* first, const char* prefs,
+                                           int capacity)
+    {
+        if (NULL == first) return NULL;
+
+        if (capacity <= 0)
+        {
+            capacity = first->osystem->settings().getInt("consolepool");
+            if (capacity <= 0) return NULL;
+        }
+
+        unique_ptr<emu_pool_t> pool = make_ptr<emu_pool_t>();
+        pool->pool = make_ptr<ConsolePool>(first, NULL != prefs ? prefs : "",
+                                           uInt32(capacity));
+
+        return pool.release();
+    }
+
+    int DLLBINDING emu_pool_destroy(emu_pool_t* pool)
     {
-        Cleanup();
-        theOSystem->quit();
-        theOSystem = nullptr;
+        if (NULL == pool) return -1;
 
-        theRom->free();
-        theRom = nullptr;
+        // Only the settings of the instance in use are kept, if it is
+        // the one the pool was created with
+        Cleanup(*pool->pool->current()->osystem);
+
+        delete pool;
 
         return 0;
     }
 
+    int DLLBINDING emu_pool_prepare(emu_pool_t* pool, const void* data, int data_size,
+                                    const char* filename)
+    {
+        if (NULL == pool || NULL == data || data_size <= 0) return -1;
+
+        pool->pool->prepare(data, uInt32(data_size), NULL != filename ? filename : "");
+
+        return 0;
+    }
+
+    emu_instance_t* DLLBINDING emu_pool_switch(emu_pool_t* pool, const void* data,
+                                               int data_size, const char* filename)
+    {
+        if (NULL == pool || NULL == data || data_size <= 0) return NULL;
+
+        return pool->pool->acquire(data, uInt32(data_size), NULL != filename ? filename : "");
+    }
+
+    emu_instance_t* DLLBINDING emu_pool_switch_archive(emu_pool_t* pool, emu_archive_t* archive,
+                                                       const char* entry)
+    {
+        if (NULL == pool || NULL == archive || NULL == entry) return NULL;
+
+        RomImage image = archive->archive->load(entry);
+        if (image.empty()) return NULL;
+
+        return pool->pool->acquire(image.data(), image.size(), entry);
+    }
+
+    int DLLBINDING emu_pool_command(emu_pool_t* pool, int command, int param)
+    {
+        if (NULL == pool) return 0;
+
+        return pool->pool->command(command, param);
+    }
+
+    int DLLBINDING emu_pool_info(emu_pool_t* pool, char* buffer, int buffer_size)
+    {
+        if (NULL == pool) return 0;
+
+        return CopyToBuffer(pool->pool->info(), buffer, buffer_size);
+    }
+
+    emu_archive_t* DLLBINDING emu_archive_open(const char* path)
+    {
+        if (NULL == path) return NULL;
+
+        shared_ptr<const ZipArchive> archive = SharedContext::instance().zipArchive(path);
+        if (!archive) return NULL;
+
+        return new emu_archive{ archive };
+    }
+
+    emu_archive_t* DLLBINDING emu_archive_open_fd(int fd, long long offset, long long length)
+    {
+        if (fd < 0 || offset < 0 || length < 0) return NULL;
+
+        shared_ptr<const ZipArchive> archive =
+            SharedContext::instance().zipArchive(fd, uInt64(offset), uInt64(length));
+        if (!archive) return NULL;
+
+        return new emu_archive{ archive };
+    }
+
+    int DLLBINDING emu_archive_close(emu_archive_t* archive)
+    {
+        if (NULL == archive) return -1;
+
+        delete archive;
+
+        return 0;
+    }
+
+    // Returns the size of the list including its terminating zero; it is
+    // only written if the buffer is large enough, so passing no buffer
+    // queries the size to allocate
+    int DLLBINDING emu_archive_list(emu_archive_t* archive, char* buffer, int buffer_size)
+    {
+        if (NULL == archive) return 0;
+
+        string list;
+        for (const ZipArchive::Entry& entry : archive->archive->entries())
+        {
+            list += entry.name;
+            list += '\n';
+        }
+
+        int size = int(list.length()) + 1;
+        if (NULL != buffer && buffer_size >= size)
+            memcpy(buffer, list.c_str(), size);
+
+        return size;
+    }
+
+    int DLLBINDING emu_archive_utf8_names(emu_archive_t* archive)
+    {
+        if (NULL == archive) return 0;
+
+        return archive->archive->utf8Names() ? 1 : 0;
+    }
+
+    // The functions without handle work on a default instance
+
+    int DLLBINDING emu_init(const char* prefs, int flags)
+    {
+        if (NULL != theDefaultInstance)
+        {
+            emu_destroy(theDefaultInstance);
+        }
+
+        theDefaultInstance = emu_create(prefs, flags);
+
+        return NULL != theDefaultInstance ? 0 : -1;
+    }
+
+    int DLLBINDING emu_input(int keyCode, int state)
+    {
+        return emu_instance_input(theDefaultInstance, keyCode, state);
+    }
+
+    int DLLBINDING emu_load(int data_type, const void* data, int data_size, const char* filename)
+    {
+        return emu_instance_load(theDefaultInstance, data_type, data, data_size, filename);
+    }
+
+    int DLLBINDING emu_load_archive(emu_archive_t* archive, const char* entry)
+    {
+        return emu_instance_load_archive(theDefaultInstance, archive, entry);
+    }
+
+    int DLLBINDING emu_store(int data_type, void* buffer, int buffer_size)
+    {
+        return emu_instance_store(theDefaultInstance, data_type, buffer, buffer_size);
+    }
+
+    int DLLBINDING emu_command(int command, int param)
+    {
+        return emu_instance_command(theDefaultInstance, command, param);
+    }
+
+    int DLLBINDING emu_update_input(int joystickInput, int flags)
+    {
+        return emu_instance_update_input(theDefaultInstance, joystickInput, flags);
+    }
+
+    int DLLBINDING emu_update_audio(void* buffer, int bufferLen, int flags)
+    {
+        return emu_instance_update_audio(theDefaultInstance, buffer, bufferLen, flags);
+    }
+
+    int DLLBINDING emu_update_video(emu_update_info_t* update_info, int flags)
+    {
+        return emu_instance_update_video(theDefaultInstance, update_info, flags);
+    }
+
+    int DLLBINDING emu_get(const char* key, char* buffer, int buffer_size)
+    {
+        return emu_instance_get(theDefaultInstance, key, buffer, buffer_size);
+    }
+
+    int DLLBINDING emu_shutdown()
+    {
+        int result = emu_destroy(theDefaultInstance);
+        theDefaultInstance = NULL;
+
+        return result;
+    }
+
 } // extern "C"
@@ -89,6 +89,11 @@ class AtariVox : public Controller
     */
     void systemCyclesReset() override;
 
+    /**
+      Returns the EEPROM holding the saved data.
+    */
+    MT24LC256* eeprom() const override { return myEEPROM.get(); }
+
     string about() const override;
 
     private:
@@ -0,0 +1,171 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "Console.hxx"
+#include "M6532.hxx"
+#include "OSystem.hxx"
+#include "TIA.hxx"
+
+#include "Batch.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Batch::Batch(const vector<OSystem*>& envs, uInt32 threads)
+    : myActions(nullptr),
+    myFrames(0),
+    myOutput(nullptr),
+    myPool(BSPF::clamp(threads, 0u, uInt32(envs.size())))
+{
+    myEnvs.resize(envs.size());
+    for (uInt32 i = 0; i < envs.size(); ++i)
+    {
+        myEnvs[i].osystem = envs[i];
+        myEnvs[i].paletteVersion = ~0u;
+        myEnvs[i].height = 0;
+    }
+
+    for (uInt32 x = 0; x < EMU_BATCH_GREY_WIDTH; ++x)
+        myColumns[x] = uInt8((2 * x + 1) * EMU_BATCH_FRAME_WIDTH / (2 * EMU_BATCH_GREY_WIDTH));
+
+    myTask = [this](uInt32 index) { stepEnv(index); };
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Batch::observationSize(int type)
+{
+    switch (type)
+    {
+        case EMU_BATCH_OBSERVATION_NONE:
+            return 0;
+        case EMU_BATCH_OBSERVATION_FRAME:
+            return EMU_BATCH_FRAME_WIDTH * EMU_BATCH_FRAME_HEIGHT;
+        case EMU_BATCH_OBSERVATION_GREY:
+            return EMU_BATCH_GREY_WIDTH * EMU_BATCH_GREY_HEIGHT;
+        default:
+            return 0;
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Batch::step(const int* actions, uInt32 frames, const emu_batch_output_t& output)
+{
+    if (actions == nullptr || frames == 0)
+        return false;
+    if (output.observation_type != EMU_BATCH_OBSERVATION_NONE &&
+        (observationSize(output.observation_type) == 0 || output.observations == nullptr))
+        return false;
+    if (output.audio != nullptr && output.audio_size <= 0)
+        return false;
+
+    myActions = actions;
+    myFrames = frames;
+    myOutput = &output;
+
+    myPool.run(size(), myTask);
+
+    myOutput = nullptr;
+    myActions = nullptr;
+
+    return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Batch::stepEnv(uInt32 index)
+{
+    OSystem& osystem = *myEnvs[index].osystem;
+    const emu_batch_output_t& output = *myOutput;
+
+    emu_update_info_t info;
+    bool emulated = false;
+    for (uInt32 frame = 0; frame < myFrames; ++frame)
+    {
+        osystem.updateInput(myActions[index]);
+        emulated = osystem.updateVideo(frame + 1 == myFrames ? &info : nullptr) != 0;
+    }
+
+    // Instances not emulating (e.g. no ROM loaded) read as blank
+
+    uInt32 size = observationSize(output.observation_type);
+    if (size > 0)
+    {
+        uInt8* dest = static_cast<uInt8*>(output.observations) + index * size;
+        if (!emulated)
+            memset(dest, 0, size);
+        else if (output.observation_type == EMU_BATCH_OBSERVATION_GREY)
+            writeGrey(index, info, dest);
+        else
+        {
+            // Frames of other heights are cut, or padded with black
+            uInt32 lines = std::min(uInt32(info.video_height), uInt32(EMU_BATCH_FRAME_HEIGHT));
+            memcpy(dest, info.video_buffer, lines * EMU_BATCH_FRAME_WIDTH);
+            memset(dest + lines * EMU_BATCH_FRAME_WIDTH, 0,
+                   (EMU_BATCH_FRAME_HEIGHT - lines) * EMU_BATCH_FRAME_WIDTH);
+        }
+    }
+
+    if (output.audio != nullptr)
+    {
+        uInt8* dest = static_cast<uInt8*>(output.audio) + index * output.audio_size;
+        if (!emulated || osystem.updateAudio(dest, output.audio_size) == 0)
+            memset(dest, 0, output.audio_size);
+    }
+
+    if (output.ram != nullptr)
+    {
+        uInt8* dest = static_cast<uInt8*>(output.ram) + index * EMU_BATCH_RAM_SIZE;
+        if (emulated)
+            memcpy(dest, osystem.console().riot().getRAM(), EMU_BATCH_RAM_SIZE);
+        else
+            memset(dest, 0, EMU_BATCH_RAM_SIZE);
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Batch::writeGrey(uInt32 index, const emu_update_info_t& info, uInt8* dest)
+{
+    Env& env = myEnvs[index];
+
+    // The palette only changes when the user picks another one; its
+    // address may be reused by the new one, so go by the version
+    uInt32 version = env.osystem->paletteVersion();
+    if (env.paletteVersion != version)
+    {
+        // Palette entries are stored as 0x00bbggrr (see OSystem::setPalette)
+        for (uInt32 i = 0; i < 256; ++i)
+        {
+            uInt32 c = info.palette[i];
+            env.grey[i] = uInt8((77 * (c & 0xff) + 150 * ((c >> 8) & 0xff) +
+                                 29 * ((c >> 16) & 0xff)) >> 8);
+        }
+        env.paletteVersion = version;
+    }
+
+    uInt32 height = uInt32(info.video_height);
+    if (env.height != height)
+    {
+        for (uInt32 y = 0; y < EMU_BATCH_GREY_HEIGHT; ++y)
+            env.lines[y] = uInt16((2 * y + 1) * height / (2 * EMU_BATCH_GREY_HEIGHT));
+        env.height = height;
+    }
+
+    const uInt8* src = static_cast<const uInt8*>(info.video_buffer);
+    for (uInt32 y = 0; y < EMU_BATCH_GREY_HEIGHT; ++y)
+    {
+        const uInt8* line = src + env.lines[y] * EMU_BATCH_FRAME_WIDTH;
+        for (uInt32 x = 0; x < EMU_BATCH_GREY_WIDTH; ++x)
+            *dest++ = env.grey[line[myColumns[x]]];
+    }
+}
@@ -0,0 +1,123 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef BATCH_HXX
+#define BATCH_HXX
+
+class OSystem;
+
+#include <functional>
+
+#include "bspf.hxx"
+#include "WorkerPool.hxx"
+#include "emu_adapter.h"
+
+/**
+  This class steps a fixed set of emulator instances together, for
+  callers running many consoles side by side (e.g. training agents).
+
+  One step feeds every instance its input for a number of frames, and
+  writes the resulting observation, audio and RAM of all instances into
+  arrays owned by the caller.  The instances are spread over a pool of
+  threads; nothing is allocated while stepping.
+*/
+class Batch
+{
+    public:
+      /**
+        Create a batch of the given instances, all of which must have a
+        console.
+
+        @param envs     The instances, stepped in this order
+        @param threads  The number of threads to step them with (0 for
+                        one per core)
+      */
+    Batch(const vector<OSystem*>& envs, uInt32 threads);
+
+    public:
+      /**
+        The number of instances in the batch.
+      */
+    uInt32 size() const { return uInt32(myEnvs.size()); }
+
+    /**
+      The number of threads stepping the instances.
+    */
+    uInt32 threads() const { return myPool.size(); }
+
+    /**
+      Answers the size in bytes of one observation of the given type,
+      or 0 if the type is unknown.
+    */
+    static uInt32 observationSize(int type);
+
+    /**
+      Run all instances for the given number of frames, holding the
+      joystick input of each for the whole step.
+
+      @param actions  The joystick input of each instance
+      @param frames   The number of frames to run
+      @param output   Where to put the results
+
+      @return  False if the output is malformed
+    */
+    bool step(const int* actions, uInt32 frames, const emu_batch_output_t& output);
+
+    private:
+      // Step the instance with the given index
+    void stepEnv(uInt32 index);
+
+    // Scale the frame down to EMU_BATCH_GREY_WIDTH x EMU_BATCH_GREY_HEIGHT
+    // grey levels
+    void writeGrey(uInt32 index, const emu_update_info_t& info, uInt8* dest);
+
+    private:
+    struct Env {
+        OSystem* osystem;
+
+        // Grey level of every colour of the palette last seen
+        uInt32 paletteVersion;
+        uInt8 grey[256];
+
+        // Source line of every line of the scaled frame, for the frame
+        // height last seen
+        uInt32 height;
+        uInt16 lines[EMU_BATCH_GREY_HEIGHT];
+    };
+    vector<Env> myEnvs;
+
+    // Source pixel of every column of the scaled frame
+    uInt8 myColumns[EMU_BATCH_GREY_WIDTH];
+
+    // The step in progress
+    const int* myActions;
+    uInt32 myFrames;
+    const emu_batch_output_t* myOutput;
+
+    WorkerPool myPool;
+    std::function<void(uInt32)> myTask;
+
+    private:
+      // Following constructors and assignment operators not supported
+    Batch() = delete;
+    Batch(const Batch&) = delete;
+    Batch(Batch&&) = delete;
+    Batch& operator=(const Batch&) = delete;
+    Batch& operator=(Batch&&) = delete;
+};
+
+#endif
@@ -59,6 +59,7 @@
 #include "CartUA.hxx"
 #include "CartWD.hxx"
 #include "CartX07.hxx"
+#include "SignatureScanner.hxx"
 #include "MD5.hxx"
 #include "Props.hxx"
 #include "Settings.hxx"
@@ -68,12 +69,113 @@
 #endif
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-unique_ptr<Cartridge> Cartridge::create(const uInt8* image, uInt32 size,
+// The signatures searched in the whole image; they are all counted in a
+// single pass, and the tests below read the counts
+enum {
+    kF8,
+    kE0, kE0Last = kE0 + 7,
+    kE7, kE7Last = kE7 + 6,
+    kEF, kEFLast = kEF + 3,
+    k0840, k0840Last = k0840 + 4,
+    k3E, k3EPlus, k3F,
+    kCV, kCVLast = kCV + 1,
+    kDASH, kDPCplus,
+    kFE, kFELast = kFE + 3,
+    kSB, kSBLast = kSB + 1,
+    kUA, kUALast = kUA + 2,
+    kX07, kX07Last = kX07 + 5,
+    kNumSignatures
+};
+
+static const SignatureScanner::Signature ourSignatures[kNumSignatures] = {
+  { { 0x8D, 0xF9, 0x1F }, 3 },  // STA $1FF9 (F8)
+
+  // E0: accesses of $FE0 to $FF9 using absolute non-indexed addressing
+  { { 0x8D, 0xE0, 0x1F }, 3 },  // STA $1FE0
+  { { 0x8D, 0xE0, 0x5F }, 3 },  // STA $5FE0
+  { { 0x8D, 0xE9, 0xFF }, 3 },  // STA $FFE9
+  { { 0x0C, 0xE0, 0x1F }, 3 },  // NOP $1FE0
+  { { 0xAD, 0xE0, 0x1F }, 3 },  // LDA $1FE0
+  { { 0xAD, 0xE9, 0xFF }, 3 },  // LDA $FFE9
+  { { 0xAD, 0xED, 0xFF }, 3 },  // LDA $FFED
+  { { 0xAD, 0xF3, 0xBF }, 3 },  // LDA $BFF3
+
+  // E7: accesses of $FE0 to $FE6 using absolute non-indexed addressing
+  { { 0xAD, 0xE2, 0xFF }, 3 },  // LDA $FFE2
+  { { 0xAD, 0xE5, 0xFF }, 3 },  // LDA $FFE5
+  { { 0xAD, 0xE5, 0x1F }, 3 },  // LDA $1FE5
+  { { 0xAD, 0xE7, 0x1F }, 3 },  // LDA $1FE7
+  { { 0x0C, 0xE7, 0x1F }, 3 },  // NOP $1FE7
+  { { 0x8D, 0xE7, 0xFF }, 3 },  // STA $FFE7
+  { { 0x8D, 0xE7, 0x1F }, 3 },  // STA $1FE7
+
+  // EF: switches to bank 0
+  { { 0x0C, 0xE0, 0xFF }, 3 },  // NOP $FFE0
+  { { 0xAD, 0xE0, 0xFF }, 3 },  // LDA $FFE0
+  { { 0x0C, 0xE0, 0x1F }, 3 },  // NOP $1FE0
+  { { 0xAD, 0xE0, 0x1F }, 3 },  // LDA $1FE0
+
+  // 0840: accesses of $0800 or $0840
+  { { 0xAD, 0x00, 0x08 }, 3 },  // LDA $0800
+  { { 0xAD, 0x40, 0x08 }, 3 },  // LDA $0840
+  { { 0x2C, 0x00, 0x08 }, 3 },  // BIT $0800
+  { { 0x0C, 0x00, 0x08, 0x4C }, 4 },  // NOP $0800; JMP ...
+  { { 0x0C, 0xFF, 0x0F, 0x4C }, 4 },  // NOP $0FFF; JMP ...
+
+  { { 0x85, 0x3E, 0xA9, 0x00 }, 4 },  // STA $3E; LDA #$00 (3E)
+  { { 'T', 'J', '3', 'E' }, 4 },      // 3E+
+  { { 0x85, 0x3F }, 2 },              // STA $3F (3F)
+
+  // CV: RAM accesses at $f3ff and $f400
+  { { 0x9D, 0xFF, 0xF3 }, 3 },  // STA $F3FF.X
+  { { 0x99, 0x00, 0xF4 }, 3 },  // STA $F400.Y
+
+  { { 'T', 'J', 'A', 'D' }, 4 },  // DASH
+  { { 'D', 'P', 'C', '+' }, 4 },  // DPC+
+
+  // FE: always seems to include a 'JSR $xxxx'
+  { { 0x20, 0x00, 0xD0, 0xC6, 0xC5 }, 5 },  // JSR $D000; DEC $C5
+  { { 0x20, 0xC3, 0xF8, 0xA5, 0x82 }, 5 },  // JSR $F8C3; LDA $82
+  { { 0xD0, 0xFB, 0x20, 0x73, 0xFE }, 5 },  // BNE $FB; JSR $FE73
+  { { 0x20, 0x00, 0xF0, 0x84, 0xD6 }, 5 },  // JSR $F000; STY $D6
+
+  // SB: accesses of $0800
+  { { 0xBD, 0x00, 0x08 }, 3 },  // LDA $0800,x
+  { { 0xAD, 0x00, 0x08 }, 3 },  // LDA $0800
+
+  // UA: accesses of $240
+  { { 0x8D, 0x40, 0x02 }, 3 },  // STA $240
+  { { 0xAD, 0x40, 0x02 }, 3 },  // LDA $240
+  { { 0xBD, 0x1F, 0x02 }, 3 },  // LDA $21F,X
+
+  // X07: accesses of $08xd
+  { { 0xAD, 0x0D, 0x08 }, 3 },  // LDA $080D
+  { { 0xAD, 0x1D, 0x08 }, 3 },  // LDA $081D
+  { { 0xAD, 0x2D, 0x08 }, 3 },  // LDA $082D
+  { { 0x0C, 0x0D, 0x08 }, 3 },  // NOP $080D
+  { { 0x0C, 0x1D, 0x08 }, 3 },  // NOP $081D
+  { { 0x0C, 0x2D, 0x08 }, 3 }   // NOP $082D
+};
+
+// Answers whether any of the signatures first..last was found minhits times
+static bool anyHits(const uInt32* hits, uInt32 first, uInt32 last, uInt32 minhits = 1)
+{
+    for (uInt32 i = first; i <= last; ++i)
+        if (hits[i] >= minhits)
+            return true;
+
+    return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+unique_ptr<Cartridge> Cartridge::create(const RomImage& rom,
     string& md5, string& dtype, string& id,
     const OSystem& osystem, Settings& settings)
 {
     unique_ptr<Cartridge> cartridge;
     string type = dtype;
+    RomImage image = rom;
+    uInt32 size = image.size();
 
     // Collect some info about the ROM
     ostringstream buf;
@@ -83,7 +185,7 @@ unique_ptr<Cartridge> Cartridge::create(const uInt8* image, uInt32 size,
     string autodetect = "";
     if (type == "AUTO" || settings.getBool("rominfo"))
     {
-        const string& detected = autodetectType(image, size);
+        const string& detected = autodetectType(image.data(), size);
         autodetect = "*";
         if (type != "AUTO" && type != detected)
             cerr << "Auto-detection not consistent: " << type << ", " << detected << endl;
@@ -180,85 +282,85 @@ unique_ptr<Cartridge> Cartridge::create(const uInt8* image, uInt32 size,
 
     // We should know the cart's type by now so let's create it
     if (type == "0840")
-        cartridge = make_ptr<Cartridge0840>(image, size, settings);
+        cartridge = make_ptr<Cartridge0840>(image.data(), size, settings);
     else if (type == "2K")
-        cartridge = make_ptr<Cartridge2K>(image, size, settings);
+        cartridge = make_ptr<Cartridge2K>(image.data(), size, settings);
     else if (type == "3E")
-        cartridge = make_ptr<Cartridge3E>(image, size, settings);
+        cartridge = make_ptr<Cartridge3E>(image, settings);
     else if (type == "3E+")
-        cartridge = make_ptr<Cartridge3EPlus>(image, size, settings);
+        cartridge = make_ptr<Cartridge3EPlus>(image, settings);
     else if (type == "3F")
-        cartridge = make_ptr<Cartridge3F>(image, size, settings);
+        cartridge = make_ptr<Cartridge3F>(image, settings);
     else if (type == "4A50")
-        cartridge = make_ptr<Cartridge4A50>(image, size, settings);
+        cartridge = make_ptr<Cartridge4A50>(image.data(), size, settings);
     else if (type == "4K")
-        cartridge = make_ptr<Cartridge4K>(image, size, settings);
+        cartridge = make_ptr<Cartridge4K>(image.data(), size, settings);
     else if (type == "4KSC")
-        cartridge = make_ptr<Cartridge4KSC>(image, size, settings);
+        cartridge = make_ptr<Cartridge4KSC>(image.data(), size, settings);
     else if (type == "AR")
-        cartridge = make_ptr<CartridgeAR>(image, size, settings);
+        cartridge = make_ptr<CartridgeAR>(image.data(), size, settings);
     else if (type == "CM")
-        cartridge = make_ptr<CartridgeCM>(image, size, settings);
+        cartridge = make_ptr<CartridgeCM>(image.data(), size, settings);
     else if (type == "CTY")
-        cartridge = make_ptr<CartridgeCTY>(image, size, osystem);
+        cartridge = make_ptr<CartridgeCTY>(image.data(), size, osystem);
     else if (type == "CV")
-        cartridge = make_ptr<CartridgeCV>(image, size, settings);
+        cartridge = make_ptr<CartridgeCV>(image.data(), size, settings);
     else if (type == "CV+")
-        cartridge = make_ptr<CartridgeCVPlus>(image, size, settings);
+        cartridge = make_ptr<CartridgeCVPlus>(image, settings);
     else if (type == "DASH")
-        cartridge = make_ptr<CartridgeDASH>(image, size, settings);
+        cartridge = make_ptr<CartridgeDASH>(image, settings);
     else if (type == "DPC")
-        cartridge = make_ptr<CartridgeDPC>(image, size, settings);
+        cartridge = make_ptr<CartridgeDPC>(image.data(), size, settings);
     else if (type == "DPC+")
-        cartridge = make_ptr<CartridgeDPCPlus>(image, size, settings);
+        cartridge = make_ptr<CartridgeDPCPlus>(image, settings);
     else if (type == "E0")
-        cartridge = make_ptr<CartridgeE0>(image, size, settings);
+        cartridge = make_ptr<CartridgeE0>(image.data(), size, settings);
     else if (type == "E7")
-        cartridge = make_ptr<CartridgeE7>(image, size, settings);
+        cartridge = make_ptr<CartridgeE7>(image.data(), size, settings);
     else if (type == "EF")
-        cartridge = make_ptr<CartridgeEF>(image, size, settings);
+        cartridge = make_ptr<CartridgeEF>(image.data(), size, settings);
     else if (type == "EFSC")
-        cartridge = make_ptr<CartridgeEFSC>(image, size, settings);
+        cartridge = make_ptr<CartridgeEFSC>(image.data(), size, settings);
     else if (type == "BF")
-        cartridge = make_ptr<CartridgeBF>(image, size, settings);
+        cartridge = make_ptr<CartridgeBF>(image.data(), size, settings);
     else if (type == "BFSC")
-        cartridge = make_ptr<CartridgeBFSC>(image, size, settings);
+        cartridge = make_ptr<CartridgeBFSC>(image.data(), size, settings);
     else if (type == "DF")
-        cartridge = make_ptr<CartridgeDF>(image, size, settings);
+        cartridge = make_ptr<CartridgeDF>(image.data(), size, settings);
     else if (type == "DFSC")
-        cartridge = make_ptr<CartridgeDFSC>(image, size, settings);
+        cartridge = make_ptr<CartridgeDFSC>(image.data(), size, settings);
     else if (type == "F0" || type == "MB")
-        cartridge = make_ptr<CartridgeF0>(image, size, settings);
+        cartridge = make_ptr<CartridgeF0>(image.data(), size, settings);
     else if (type == "F4")
-        cartridge = make_ptr<CartridgeF4>(image, size, settings);
+        cartridge = make_ptr<CartridgeF4>(image.data(), size, settings);
     else if (type == "F4SC")
-        cartridge = make_ptr<CartridgeF4SC>(image, size, settings);
+        cartridge = make_ptr<CartridgeF4SC>(image.data(), size, settings);
     else if (type == "F6")
-        cartridge = make_ptr<CartridgeF6>(image, size, settings);
+        cartridge = make_ptr<CartridgeF6>(image.data(), size, settings);
     else if (type == "F6SC")
-        cartridge = make_ptr<CartridgeF6SC>(image, size, settings);
+        cartridge = make_ptr<CartridgeF6SC>(image.data(), size, settings);
     else if (type == "F8")
-        cartridge = make_ptr<CartridgeF8>(image, size, md5, settings);
+        cartridge = make_ptr<CartridgeF8>(image.data(), size, md5, settings);
     else if (type == "F8SC")
-        cartridge = make_ptr<CartridgeF8SC>(image, size, settings);
+        cartridge = make_ptr<CartridgeF8SC>(image.data(), size, settings);
     else if (type == "FA" || type == "FASC")
-        cartridge = make_ptr<CartridgeFA>(image, size, settings);
+        cartridge = make_ptr<CartridgeFA>(image.data(), size, settings);
     else if (type == "FA2")
-        cartridge = make_ptr<CartridgeFA2>(image, size, osystem);
+        cartridge = make_ptr<CartridgeFA2>(image.data(), size, osystem);
     else if (type == "FE")
-        cartridge = make_ptr<CartridgeFE>(image, size, settings);
+        cartridge = make_ptr<CartridgeFE>(image.data(), size, settings);
     else if (type == "MC")
-        cartridge = make_ptr<CartridgeMC>(image, size, settings);
+        cartridge = make_ptr<CartridgeMC>(image.data(), size, settings);
     else if (type == "MDM")
-        cartridge = make_ptr<CartridgeMDM>(image, size, settings);
+        cartridge = make_ptr<CartridgeMDM>(image, settings);
     else if (type == "UA")
-        cartridge = make_ptr<CartridgeUA>(image, size, settings);
+        cartridge = make_ptr<CartridgeUA>(image.data(), size, settings);
     else if (type == "SB")
-        cartridge = make_ptr<CartridgeSB>(image, size, settings);
+        cartridge = make_ptr<CartridgeSB>(image, settings);
     else if (type == "WD")
-        cartridge = make_ptr<CartridgeWD>(image, size, settings);
+        cartridge = make_ptr<CartridgeWD>(image.data(), size, settings);
     else if (type == "X07")
-        cartridge = make_ptr<CartridgeX07>(image, size, settings);
+        cartridge = make_ptr<CartridgeX07>(image.data(), size, settings);
     else if (dtype == "WRONG_SIZE")
         throw runtime_error("Invalid cart size for type '" + type + "'");
     else
@@ -268,22 +370,23 @@ unique_ptr<Cartridge> Cartridge::create(const uInt8* image, uInt32 size,
         buf << " (" << size << "B) ";
     else
         buf << " (" << (size / 1024) << "K) ";
-    myAboutString = buf.str();
+    cartridge->myAboutString = buf.str();
+    cartridge->myType = type;
 
     return cartridge;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-string Cartridge::createFromMultiCart(const uInt8*& image, uInt32& size,
+string Cartridge::createFromMultiCart(RomImage& image, uInt32& size,
     uInt32 numroms, string& md5, string& id, Settings& settings)
 {
   // Get a piece of the larger image
     uInt32 i = settings.getInt("romloadcount");
     size /= numroms;
-    image += i*size;
+    image = RomImage(image, i*size, size);
 
     // We need a new md5 and name
-    md5 = MD5::hash(image, size);
+    md5 = MD5::hash(image.data(), size);
     ostringstream buf;
     buf << " [G" << (i + 1) << "]";
     id = buf.str();
@@ -368,9 +471,46 @@ void Cartridge::initializeRAM(uInt8* arr, uInt32 size, uInt8 val) const
         memset(arr, val, size);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomImage Cartridge::romImage() const
+{
+    int size = 0;
+    const uInt8* image = getImage(size);
+
+    return RomImage(image, uInt32(size));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8* Cartridge::writableImage(RomImage& image)
+{
+    const uInt8* shared = image.data();
+    uInt8* data = image.writable();
+
+    if (data != shared && mySystem != nullptr)
+    {
+        for (uInt32 page = 0; page < System::S_NUM_PAGES; ++page)
+        {
+            System::PageAccess access = mySystem->getPageAccess(page);
+            if (access.directPeekBase >= shared &&
+                access.directPeekBase < shared + image.size())
+            {
+                access.directPeekBase = data + (access.directPeekBase - shared);
+                mySystem->setPageAccess(page, access);
+            }
+        }
+    }
+
+    return data;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string Cartridge::autodetectType(const uInt8* image, uInt32 size)
 {
+    // Count all the signatures searched in the whole image at once
+    static const SignatureScanner scanner(ourSignatures, kNumSignatures);
+    uInt32 hits[kNumSignatures];
+    scanner.scan(image, size, hits);
+
   // Guess type based on size
     const char* type = nullptr;
 
@@ -389,11 +529,11 @@ string Cartridge::autodetectType(const uInt8* image, uInt32 size)
     else if ((size == 2048) ||
         (size == 4096 && memcmp(image, image + 2048, 2048) == 0))
     {
-        type = isProbablyCV(image, size) ? "CV" : "2K";
+        type = isProbablyCV(hits) ? "CV" : "2K";
     }
     else if (size == 4096)
     {
-        if (isProbablyCV(image, size))
+        if (isProbablyCV(hits))
             type = "CV";
         else if (isProbably4KSC(image, size))
             type = "4KSC";
@@ -402,25 +542,24 @@ string Cartridge::autodetectType(const uInt8* image, uInt32 size)
     }
     else if (size == 8 * 1024)  // 8K
     {
-      // First check for *potential* F8
-        uInt8 signature[] = { 0x8D, 0xF9, 0x1F };  // STA $1FF9
-        bool f8 = searchForBytes(image, size, signature, 3, 2);
+      // First check for *potential* F8 (STA $1FF9 at least twice)
+        bool f8 = hits[kF8] >= 2;
 
         if (isProbablySC(image, size))
             type = "F8SC";
         else if (memcmp(image, image + 4096, 4096) == 0)
             type = "4K";
-        else if (isProbablyE0(image, size))
+        else if (isProbablyE0(hits))
             type = "E0";
-        else if (isProbably3E(image, size))
+        else if (isProbably3E(hits))
             type = "3E";
-        else if (isProbably3F(image, size))
+        else if (isProbably3F(hits))
             type = "3F";
-        else if (isProbablyUA(image, size))
+        else if (isProbablyUA(hits))
             type = "UA";
-        else if (isProbablyFE(image, size) && !f8)
+        else if (isProbablyFE(hits) && !f8)
             type = "FE";
-        else if (isProbably0840(image, size))
+        else if (isProbably0840(hits))
             type = "0840";
         else
             type = "F8";
@@ -441,12 +580,12 @@ string Cartridge::autodetectType(const uInt8* image, uInt32 size)
     {
         if (isProbablySC(image, size))
             type = "F6SC";
-        else if (isProbablyE7(image, size))
+        else if (isProbablyE7(hits))
             type = "E7";
-        else if (isProbably3E(image, size))
+        else if (isProbably3E(hits))
             type = "3E";
         /* no known 16K 3F ROMS
-          else if(isProbably3F(image, size))
+          else if(isProbably3F(hits))
             type = "3F";
         */
         else
@@ -460,18 +599,18 @@ string Cartridge::autodetectType(const uInt8* image, uInt32 size)
     {
         if (isProbablyARM(image, size))
             type = "FA2";
-        else /*if(isProbablyDPCplus(image, size))*/
+        else /*if(isProbablyDPCplus(hits))*/
             type = "DPC+";
     }
     else if (size == 32 * 1024)  // 32K
     {
         if (isProbablySC(image, size))
             type = "F4SC";
-        else if (isProbably3E(image, size))
+        else if (isProbably3E(hits))
             type = "3E";
-        else if (isProbably3F(image, size))
+        else if (isProbably3F(hits))
             type = "3F";
-        else if (isProbablyDPCplus(image, size))
+        else if (isProbablyDPCplus(hits))
             type = "DPC+";
         else if (isProbablyCTY(image, size))
             type = "CTY";
@@ -482,59 +621,59 @@ string Cartridge::autodetectType(const uInt8* image, uInt32 size)
     }
     else if (size == 64 * 1024)  // 64K
     {
-        if (isProbably3E(image, size))
+        if (isProbably3E(hits))
             type = "3E";
-        else if (isProbably3F(image, size))
+        else if (isProbably3F(hits))
             type = "3F";
         else if (isProbably4A50(image, size))
             type = "4A50";
-        else if (isProbablyEF(image, size, type))
+        else if (isProbablyEF(image, size, hits, type))
             ; // type has been set directly in the function
-        else if (isProbablyX07(image, size))
+        else if (isProbablyX07(hits))
             type = "X07";
         else
             type = "F0";
     }
     else if (size == 128 * 1024)  // 128K
     {
-        if (isProbably3E(image, size))
+        if (isProbably3E(hits))
             type = "3E";
         else if (isProbablyDF(image, size, type))
             ; // type has been set directly in the function
-        else if (isProbably3F(image, size))
+        else if (isProbably3F(hits))
             type = "3F";
         else if (isProbably4A50(image, size))
             type = "4A50";
-        else if (isProbablySB(image, size))
+        else if (isProbablySB(hits))
             type = "SB";
         else
             type = "MC";
     }
     else if (size == 256 * 1024)  // 256K
     {
-        if (isProbably3E(image, size))
+        if (isProbably3E(hits))
             type = "3E";
         else if (isProbablyBF(image, size, type))
             ; // type has been set directly in the function
-        else if (isProbably3F(image, size))
+        else if (isProbably3F(hits))
             type = "3F";
-        else /*if(isProbablySB(image, size))*/
+        else /*if(isProbablySB(hits))*/
             type = "SB";
     }
     else  // what else can we do?
     {
-        if (isProbably3E(image, size))
+        if (isProbably3E(hits))
             type = "3E";
-        else if (isProbably3F(image, size))
+        else if (isProbably3F(hits))
             type = "3F";
         else
             type = "4K";  // Most common bankswitching type
     }
 
     // Variable sized ROM formats are independent of image size and come last
-    if (isProbablyDASH(image, size))
+    if (isProbablyDASH(hits))
         type = "DASH";
-    else if (isProbably3EPlus(image, size))
+    else if (isProbably3EPlus(hits))
         type = "3E+";
     else if (isProbablyMDM(image, size))
         type = "MDM";
@@ -622,57 +761,37 @@ bool Cartridge::isProbablyARM(const uInt8* image, uInt32 size)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbably0840(const uInt8* image, uInt32 size)
+bool Cartridge::isProbably0840(const uInt32* hits)
 {
   // 0840 cart bankswitching is triggered by accessing addresses 0x0800
   // or 0x0840 at least twice
-    uInt8 signature1[3][3] = {
-      { 0xAD, 0x00, 0x08 },  // LDA $0800
-      { 0xAD, 0x40, 0x08 },  // LDA $0840
-      { 0x2C, 0x00, 0x08 }   // BIT $0800
-    };
-    for (uInt32 i = 0; i < 3; ++i)
-        if (searchForBytes(image, size, signature1[i], 3, 2))
-            return true;
-
-    uInt8 signature2[2][4] = {
-      { 0x0C, 0x00, 0x08, 0x4C },  // NOP $0800; JMP ...
-      { 0x0C, 0xFF, 0x0F, 0x4C }   // NOP $0FFF; JMP ...
-    };
-    for (uInt32 i = 0; i < 2; ++i)
-        if (searchForBytes(image, size, signature2[i], 4, 2))
-            return true;
-
-    return false;
+    return anyHits(hits, k0840, k0840Last, 2);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbably3E(const uInt8* image, uInt32 size)
+bool Cartridge::isProbably3E(const uInt32* hits)
 {
   // 3E cart bankswitching is triggered by storing the bank number
   // in address 3E using 'STA $3E', commonly followed by an
   // immediate mode LDA
-    uInt8 signature[] = { 0x85, 0x3E, 0xA9, 0x00 };  // STA $3E; LDA #$00
-    return searchForBytes(image, size, signature, 4, 1);
+    return hits[k3E] >= 1;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbably3EPlus(const uInt8* image, uInt32 size)
+bool Cartridge::isProbably3EPlus(const uInt32* hits)
 {
   // 3E+ cart is identified key 'TJ3E' in the ROM
-    uInt8 signature[] = { 'T', 'J', '3', 'E' };
-    return searchForBytes(image, size, signature, 4, 1);
+    return hits[k3EPlus] >= 1;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbably3F(const uInt8* image, uInt32 size)
+bool Cartridge::isProbably3F(const uInt32* hits)
 {
   // 3F cart bankswitching is triggered by storing the bank number
   // in address 3F using 'STA $3F'
   // We expect it will be present at least 2 times, since there are
   // at least two banks
-    uInt8 signature[] = { 0x85, 0x3F };  // STA $3F
-    return searchForBytes(image, size, signature, 2, 2);
+    return hits[k3F] >= 2;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -700,18 +819,11 @@ bool Cartridge::isProbablyCTY(const uInt8* image, uInt32 size)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyCV(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyCV(const uInt32* hits)
 {
   // CV RAM access occurs at addresses $f3ff and $f400
   // These signatures are attributed to the MESS project
-    uInt8 signature[2][3] = {
-      { 0x9D, 0xFF, 0xF3 },  // STA $F3FF.X
-      { 0x99, 0x00, 0xF4 }   // STA $F400.Y
-    };
-    if (searchForBytes(image, size, signature[0], 3, 1))
-        return true;
-    else
-        return searchForBytes(image, size, signature[1], 3, 1);
+    return anyHits(hits, kCV, kCVLast);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -725,23 +837,21 @@ bool Cartridge::isProbablyCVPlus(const uInt8* image, uInt32)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyDASH(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyDASH(const uInt32* hits)
 {
   // DASH cart is identified key 'TJAD' in the ROM
-    uInt8 signature[] = { 'T', 'J', 'A', 'D' };
-    return searchForBytes(image, size, signature, 4, 1);
+    return hits[kDASH] >= 1;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyDPCplus(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyDPCplus(const uInt32* hits)
 {
   // DPC+ ARM code has 2 occurrences of the string DPC+
-    uInt8 signature[] = { 'D', 'P', 'C', '+' };
-    return searchForBytes(image, size, signature, 4, 2);
+    return hits[kDPCplus] >= 2;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyE0(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyE0(const uInt32* hits)
 {
   // E0 cart bankswitching is triggered by accessing addresses
   // $FE0 to $FF9 using absolute non-indexed addressing
@@ -749,25 +859,11 @@ bool Cartridge::isProbablyE0(const uInt8* image, uInt32 size)
   // search for only certain known signatures
   // Thanks to "stella@casperkitty.com" for this advice
   // These signatures are attributed to the MESS project
-    uInt8 signature[8][3] = {
-      { 0x8D, 0xE0, 0x1F },  // STA $1FE0
-      { 0x8D, 0xE0, 0x5F },  // STA $5FE0
-      { 0x8D, 0xE9, 0xFF },  // STA $FFE9
-      { 0x0C, 0xE0, 0x1F },  // NOP $1FE0
-      { 0xAD, 0xE0, 0x1F },  // LDA $1FE0
-      { 0xAD, 0xE9, 0xFF },  // LDA $FFE9
-      { 0xAD, 0xED, 0xFF },  // LDA $FFED
-      { 0xAD, 0xF3, 0xBF }   // LDA $BFF3
-    };
-    for (uInt32 i = 0; i < 8; ++i)
-        if (searchForBytes(image, size, signature[i], 3, 1))
-            return true;
-
-    return false;
+    return anyHits(hits, kE0, kE0Last);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyE7(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyE7(const uInt32* hits)
 {
   // E7 cart bankswitching is triggered by accessing addresses
   // $FE0 to $FE6 using absolute non-indexed addressing
@@ -775,24 +871,12 @@ bool Cartridge::isProbablyE7(const uInt8* image, uInt32 size)
   // search for only certain known signatures
   // Thanks to "stella@casperkitty.com" for this advice
   // These signatures are attributed to the MESS project
-    uInt8 signature[7][3] = {
-      { 0xAD, 0xE2, 0xFF },  // LDA $FFE2
-      { 0xAD, 0xE5, 0xFF },  // LDA $FFE5
-      { 0xAD, 0xE5, 0x1F },  // LDA $1FE5
-      { 0xAD, 0xE7, 0x1F },  // LDA $1FE7
-      { 0x0C, 0xE7, 0x1F },  // NOP $1FE7
-      { 0x8D, 0xE7, 0xFF },  // STA $FFE7
-      { 0x8D, 0xE7, 0x1F }   // STA $1FE7
-    };
-    for (uInt32 i = 0; i < 7; ++i)
-        if (searchForBytes(image, size, signature[i], 3, 1))
-            return true;
-
-    return false;
+    return anyHits(hits, kE7, kE7Last);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyEF(const uInt8* image, uInt32 size, const char*& type)
+bool Cartridge::isProbablyEF(const uInt8* image, uInt32 size,
+    const uInt32* hits, const char*& type)
 {
   // Newer EF carts store strings 'EFEF' and 'EFSC' starting at address $FFF8
   // This signature is attributed to "RevEng" of AtariAge
@@ -812,21 +896,7 @@ bool Cartridge::isProbablyEF(const uInt8* image, uInt32 size, const char*& type)
     // Otherwise, EF cart bankswitching switches banks by accessing addresses
     // 0xFE0 to 0xFEF, usually with either a NOP or LDA
     // It's likely that the code will switch to bank 0, so that's what is tested
-    bool isEF = false;
-    uInt8 signature[4][3] = {
-      { 0x0C, 0xE0, 0xFF },  // NOP $FFE0
-      { 0xAD, 0xE0, 0xFF },  // LDA $FFE0
-      { 0x0C, 0xE0, 0x1F },  // NOP $1FE0
-      { 0xAD, 0xE0, 0x1F }   // LDA $1FE0
-    };
-    for (uInt32 i = 0; i < 4; ++i)
-    {
-        if (searchForBytes(image, size, signature[i], 3, 1))
-        {
-            isEF = true;
-            break;
-        }
-    }
+    bool isEF = anyHits(hits, kEF, kEFLast);
 
     // Now that we know that the ROM is EF, we need to check if it's
     // the SC variant
@@ -899,22 +969,12 @@ bool Cartridge::isProbablyFA2(const uInt8* image, uInt32 size)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyFE(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyFE(const uInt32* hits)
 {
   // FE bankswitching is very weird, but always seems to include a
   // 'JSR $xxxx'
   // These signatures are attributed to the MESS project
-    uInt8 signature[4][5] = {
-      { 0x20, 0x00, 0xD0, 0xC6, 0xC5 },  // JSR $D000; DEC $C5
-      { 0x20, 0xC3, 0xF8, 0xA5, 0x82 },  // JSR $F8C3; LDA $82
-      { 0xD0, 0xFB, 0x20, 0x73, 0xFE },  // BNE $FB; JSR $FE73
-      { 0x20, 0x00, 0xF0, 0x84, 0xD6 }   // JSR $F000; STY $D6
-    };
-    for (uInt32 i = 0; i < 4; ++i)
-        if (searchForBytes(image, size, signature[i], 5, 1))
-            return true;
-
-    return false;
+    return anyHits(hits, kFE, kFELast);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -928,58 +988,27 @@ bool Cartridge::isProbablyMDM(const uInt8* image, uInt32 size)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablySB(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablySB(const uInt32* hits)
 {
   // SB cart bankswitching switches banks by accessing address 0x0800
-    uInt8 signature[2][3] = {
-      { 0xBD, 0x00, 0x08 },  // LDA $0800,x
-      { 0xAD, 0x00, 0x08 }   // LDA $0800
-    };
-    if (searchForBytes(image, size, signature[0], 3, 1))
-        return true;
-    else
-        return searchForBytes(image, size, signature[1], 3, 1);
+    return anyHits(hits, kSB, kSBLast);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyUA(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyUA(const uInt32* hits)
 {
   // UA cart bankswitching switches to bank 1 by accessing address 0x240
   // using 'STA $240' or 'LDA $240'
-    uInt8 signature[3][3] = {
-      { 0x8D, 0x40, 0x02 },  // STA $240
-      { 0xAD, 0x40, 0x02 },  // LDA $240
-      { 0xBD, 0x1F, 0x02 }   // LDA $21F,X
-    };
-    for (uInt32 i = 0; i < 3; ++i)
-        if (searchForBytes(image, size, signature[i], 3, 1))
-            return true;
-
-    return false;
+    return anyHits(hits, kUA, kUALast);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyX07(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyX07(const uInt32* hits)
 {
   // X07 bankswitching switches to bank 0, 1, 2, etc by accessing address 0x08xd
-    uInt8 signature[6][3] = {
-      { 0xAD, 0x0D, 0x08 },  // LDA $080D
-      { 0xAD, 0x1D, 0x08 },  // LDA $081D
-      { 0xAD, 0x2D, 0x08 },  // LDA $082D
-      { 0x0C, 0x0D, 0x08 },  // NOP $080D
-      { 0x0C, 0x1D, 0x08 },  // NOP $081D
-      { 0x0C, 0x2D, 0x08 }   // NOP $082D
-    };
-    for (uInt32 i = 0; i < 6; ++i)
-        if (searchForBytes(image, size, signature[i], 3, 1))
-            return true;
-
-    return false;
+    return anyHits(hits, kX07, kX07Last);
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-string Cartridge::myAboutString = "";
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Cartridge::BankswitchType Cartridge::ourBSList[ourNumBSTypes] = {
   { "AUTO",     "Auto-detect"                   },
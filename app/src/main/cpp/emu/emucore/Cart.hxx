@@ -32,6 +32,7 @@ class GuiObject;
 #include "bspf.hxx"
 #include "Device.hxx"
 #include "Settings.hxx"
+#include "RomImage.hxx"
 ////#include "Font.hxx"
 
 /**
@@ -50,8 +51,7 @@ class Cartridge : public Device
         Create a new cartridge object allocated on the heap.  The
         type of cartridge created depends on the properties object.
 
-        @param image    A pointer to the ROM image
-        @param size     The size of the ROM image
+        @param rom      The ROM image, which the cartridge may share
         @param md5      The md5sum for the given ROM image (can be updated)
         @param dtype    The detected bankswitch type of the ROM image
         @param id       Any extra info about the ROM (currently which part
@@ -61,7 +61,7 @@ class Cartridge : public Device
         @return   Pointer to the new cartridge object allocated on the heap
       */
     static unique_ptr<Cartridge>
-        create(const uInt8* image, uInt32 size,
+        create(const RomImage& rom,
             string& md5, string& dtype, string& id,
             const OSystem& system, Settings& settings);
 
@@ -76,7 +76,14 @@ class Cartridge : public Device
     /**
       Query some information about this cartridge.
     */
-    static constexpr string& about() { return myAboutString; }
+    const string& about() const { return myAboutString; }
+
+    /**
+      Query the bankswitch type this cartridge was created as (after
+      autodetection), so an identical cartridge can be created again
+      from its image.
+    */
+    const string& type() const { return myType; }
 
     /**
       Save the internal (patched) ROM image.
@@ -167,6 +174,13 @@ class Cartridge : public Device
     */
     virtual const uInt8* getImage(int& size) const = 0;
 
+    /**
+      Get the ROM image to create an identical cartridge from.  Carts
+      sharing the image they were created from hand it on without a copy;
+      the others copy their internal one.
+    */
+    virtual RomImage romImage() const;
+
     /**
       Informs the cartridge about the name of the ROM file used when
       creating this cart.
@@ -219,12 +233,22 @@ class Cartridge : public Device
     */
     void initializeRAM(uInt8* arr, uInt32 size, uInt8 val = 0) const;
 
+    /**
+      Get write access to the shared ROM image of the cart (i.e. to patch
+      it).  If the image had to be copied for this, the pages of the system
+      reading from the old bytes are moved over to the copy.
+
+      @param image  The ROM image of the cart
+      @return  A pointer to the bytes of the image
+    */
+    uInt8* writableImage(RomImage& image);
+
     private:
       /**
-        Get an image pointer and size for a ROM that is part of a larger,
-        multi-ROM image.
+        Get the image and size of a ROM that is part of a larger,
+        multi-ROM image; the piece shares the bytes of the larger one.
 
-        @param image    A pointer to the ROM image
+        @param image    The ROM image
         @param size     The size of the ROM image
         @param numroms  The number of ROMs in the multicart
         @param md5      The md5sum for the specific cart in the ROM image
@@ -232,7 +256,7 @@ class Cartridge : public Device
         @param settings The settings associated with the system
         @return   The bankswitch type for the specific cart in the ROM image
       */
-    static string createFromMultiCart(const uInt8*& image, uInt32& size,
+    static string createFromMultiCart(RomImage& image, uInt32& size,
         uInt32 numroms, string& md5, string& id, Settings& settings);
 
     /**
@@ -260,6 +284,12 @@ class Cartridge : public Device
         const uInt8* signature, uInt32 sigsize,
         uInt32 minhits);
 
+    /*
+      The isProbably tests below taking 'hits' read the counts of the
+      signatures searched in the whole image, as found by the single
+      scan of autodetectType (see the table in Cart.cxx)
+    */
+
 /**
   Returns true if the image is probably a SuperChip (256 bytes RAM)
 */
@@ -278,22 +308,22 @@ class Cartridge : public Device
     /**
       Returns true if the image is probably a 0840 bankswitching cartridge
     */
-    static bool isProbably0840(const uInt8* image, uInt32 size);
+    static bool isProbably0840(const uInt32* hits);
 
     /**
       Returns true if the image is probably a 3E bankswitching cartridge
     */
-    static bool isProbably3E(const uInt8* image, uInt32 size);
+    static bool isProbably3E(const uInt32* hits);
 
     /**
       Returns true if the image is probably a 3E+ bankswitching cartridge
     */
-    static bool isProbably3EPlus(const uInt8* image, uInt32 size);
+    static bool isProbably3EPlus(const uInt32* hits);
 
     /**
       Returns true if the image is probably a 3F bankswitching cartridge
     */
-    static bool isProbably3F(const uInt8* image, uInt32 size);
+    static bool isProbably3F(const uInt32* hits);
 
     /**
       Returns true if the image is probably a 4A50 bankswitching cartridge
@@ -313,7 +343,7 @@ class Cartridge : public Device
     /**
       Returns true if the image is probably a CV bankswitching cartridge
     */
-    static bool isProbablyCV(const uInt8* image, uInt32 size);
+    static bool isProbablyCV(const uInt32* hits);
 
     /**
       Returns true if the image is probably a CV+ bankswitching cartridge
@@ -323,7 +353,7 @@ class Cartridge : public Device
     /**
       Returns true if the image is probably a DASH bankswitching cartridge
     */
-    static bool isProbablyDASH(const uInt8* image, uInt32 size);
+    static bool isProbablyDASH(const uInt32* hits);
 
     /**
       Returns true if the image is probably a DF/DFSC bankswitching cartridge
@@ -333,22 +363,23 @@ class Cartridge : public Device
     /**
       Returns true if the image is probably a DPC+ bankswitching cartridge
     */
-    static bool isProbablyDPCplus(const uInt8* image, uInt32 size);
+    static bool isProbablyDPCplus(const uInt32* hits);
 
     /**
       Returns true if the image is probably a E0 bankswitching cartridge
     */
-    static bool isProbablyE0(const uInt8* image, uInt32 size);
+    static bool isProbablyE0(const uInt32* hits);
 
     /**
       Returns true if the image is probably a E7 bankswitching cartridge
     */
-    static bool isProbablyE7(const uInt8* image, uInt32 size);
+    static bool isProbablyE7(const uInt32* hits);
 
     /**
       Returns true if the image is probably an EF/EFSC bankswitching cartridge
     */
-    static bool isProbablyEF(const uInt8* image, uInt32 size, const char*& type);
+    static bool isProbablyEF(const uInt8* image, uInt32 size,
+        const uInt32* hits, const char*& type);
 
     /**
       Returns true if the image is probably an F6 bankswitching cartridge
@@ -363,7 +394,7 @@ class Cartridge : public Device
     /**
       Returns true if the image is probably an FE bankswitching cartridge
     */
-    static bool isProbablyFE(const uInt8* image, uInt32 size);
+    static bool isProbablyFE(const uInt32* hits);
 
     /**
       Returns true if the image is probably a MDM bankswitching cartridge
@@ -373,17 +404,17 @@ class Cartridge : public Device
     /**
       Returns true if the image is probably a SB bankswitching cartridge
     */
-    static bool isProbablySB(const uInt8* image, uInt32 size);
+    static bool isProbablySB(const uInt32* hits);
 
     /**
       Returns true if the image is probably a UA bankswitching cartridge
     */
-    static bool isProbablyUA(const uInt8* image, uInt32 size);
+    static bool isProbablyUA(const uInt32* hits);
 
     /**
       Returns true if the image is probably an X07 bankswitching cartridge
     */
-    static bool isProbablyX07(const uInt8* image, uInt32 size);
+    static bool isProbablyX07(const uInt32* hits);
 
     protected:
       // Settings class for the application
@@ -404,8 +435,11 @@ class Cartridge : public Device
       // by the debugger, when disassembling/dumping ROM.
     bool myBankLocked;
 
+    // The bankswitch type this cartridge was created as
+    string myType;
+
     // Contains info about this cartridge in string format
-    static string myAboutString;
+    string myAboutString;
 
     // Following constructors and assignment operators not supported
     Cartridge() = delete;
@@ -22,17 +22,14 @@
 #include "Cart3E.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Cartridge3E::Cartridge3E(const uInt8* image, uInt32 size,
+Cartridge3E::Cartridge3E(const RomImage& image,
     const Settings& settings)
     : Cartridge(settings),
-    mySize(size),
+    mySize(image.size()),
     myCurrentBank(0)
 {
-  // Allocate array for the ROM image
-    myImage = make_ptr<uInt8[]>(mySize);
-
-    // Copy the ROM image into my buffer
-    memcpy(myImage.get(), image, mySize);
+  // Share the ROM image, it is only written to when patched
+    myImage = image;
     createCodeAccessBase(mySize + 32768);
 
     // Remember startup bank
@@ -66,7 +63,7 @@ void Cartridge3E::install(System& system)
     access.type = System::PA_READ;
     for (uInt32 j = 0x1800; j < 0x2000; j += (1 << System::S_PAGE_SHIFT))
     {
-        access.directPeekBase = &myImage[(mySize - 2048) + (j & 0x07FF)];
+        access.directPeekBase = myImage.peekBase((mySize - 2048) + (j & 0x07FF));
         access.codeAccessBase = &myCodeAccessBase[(mySize - 2048) + (j & 0x07FF)];
         mySystem->setPageAccess(j >> System::S_PAGE_SHIFT, access);
     }
@@ -163,7 +160,7 @@ bool Cartridge3E::bank(uInt16 bank)
         for (uInt32 address = 0x1000; address < 0x1800;
             address += (1 << System::S_PAGE_SHIFT))
         {
-            access.directPeekBase = &myImage[offset + (address & 0x07FF)];
+            access.directPeekBase = myImage.peekBase(offset + (address & 0x07FF));
             access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x07FF)];
             mySystem->setPageAccess(address >> System::S_PAGE_SHIFT, access);
         }
@@ -227,12 +224,12 @@ bool Cartridge3E::patch(uInt16 address, uInt8 value)
     if (address < 0x0800)
     {
         if (myCurrentBank < 256)
-            myImage[(address & 0x07FF) + (myCurrentBank << 11)] = value;
+            writableImage(myImage)[(address & 0x07FF) + (myCurrentBank << 11)] = value;
         else
             myRAM[(address & 0x03FF) + ((myCurrentBank - 256) << 10)] = value;
     }
     else
-        myImage[(address & 0x07FF) + mySize - 2048] = value;
+        writableImage(myImage)[(address & 0x07FF) + mySize - 2048] = value;
 
     return myBankChanged = true;
 }
@@ -241,7 +238,7 @@ bool Cartridge3E::patch(uInt16 address, uInt8 value)
 const uInt8* Cartridge3E::getImage(int& size) const
 {
     size = mySize;
-    return myImage.get();
+    return myImage.data();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
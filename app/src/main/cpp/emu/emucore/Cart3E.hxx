@@ -72,11 +72,10 @@ class Cartridge3E : public Cartridge
       /**
         Create a new cartridge using the specified image and size
 
-        @param image     Pointer to the ROM image
-        @param size      The size of the ROM image
+        @param image     The ROM image, which is shared
         @param settings  A reference to the various settings (read-only)
       */
-    Cartridge3E(const uInt8* image, uInt32 size, const Settings& settings);
+    Cartridge3E(const RomImage& image, const Settings& settings);
     virtual ~Cartridge3E() = default;
 
     public:
@@ -127,6 +126,11 @@ class Cartridge3E : public Cartridge
     */
     const uInt8* getImage(int& size) const override;
 
+    /**
+      Get the ROM image to create an identical cartridge from (shared).
+    */
+    RomImage romImage() const override { return myImage; }
+
     /**
       Save the current state of this cart to the given Serializer.
 
@@ -180,8 +184,8 @@ class Cartridge3E : public Cartridge
     bool poke(uInt16 address, uInt8 value) override;
 
     private:
-      // Pointer to a dynamically allocated ROM image of the cartridge
-    BytePtr myImage;
+      // The ROM image of the cartridge, shared with the one it was loaded from
+    RomImage myImage;
 
     // RAM contents. For now every ROM gets all 32K of potential RAM
     uInt8 myRAM[32 * 1024];
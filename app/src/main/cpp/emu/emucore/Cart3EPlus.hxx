@@ -51,11 +51,10 @@ class Cartridge3EPlus : public Cartridge
       /**
         Create a new cartridge using the specified image and size
 
-        @param image     Pointer to the ROM image
-        @param size      The size of the ROM image
+        @param image     The ROM image, which is shared
         @param settings  A reference to the various settings (read-only)
       */
-    Cartridge3EPlus(const uInt8* image, uInt32 size, const Settings& settings);
+    Cartridge3EPlus(const RomImage& image, const Settings& settings);
     virtual ~Cartridge3EPlus() = default;
 
     public:
@@ -87,6 +86,11 @@ class Cartridge3EPlus : public Cartridge
     */
     const uInt8* getImage(int& size) const override;
 
+    /**
+      Get the ROM image to create an identical cartridge from (shared).
+    */
+    RomImage romImage() const override { return myImage; }
+
     /**
       Save the current state of this cart to the given Serializer.
 
@@ -178,7 +182,7 @@ class Cartridge3EPlus : public Cartridge
 
     static constexpr uInt16 RAM_WRITE_OFFSET = 0x200;
 
-    BytePtr myImage;  // Pointer to a dynamically allocated ROM image of the cartridge
+    RomImage myImage;  // The ROM image of the cartridge (shared)
     uInt32  mySize;   // Size of the ROM image
     uInt8 myRAM[RAM_TOTAL_SIZE];
 
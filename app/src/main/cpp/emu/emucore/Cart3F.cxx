@@ -22,17 +22,14 @@
 #include "Cart3F.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Cartridge3F::Cartridge3F(const uInt8* image, uInt32 size,
+Cartridge3F::Cartridge3F(const RomImage& image,
     const Settings& settings)
     : Cartridge(settings),
-    mySize(size),
+    mySize(image.size()),
     myCurrentBank(0)
 {
-  // Allocate array for the ROM image
-    myImage = make_ptr<uInt8[]>(mySize);
-
-    // Copy the ROM image into my buffer
-    memcpy(myImage.get(), image, mySize);
+  // Share the ROM image, it is only written to when patched
+    myImage = image;
     createCodeAccessBase(mySize);
 
     // Remember startup bank
@@ -64,7 +61,7 @@ void Cartridge3F::install(System& system)
     access.type = System::PA_READ;
     for (uInt32 j = 0x1800; j < 0x2000; j += (1 << System::S_PAGE_SHIFT))
     {
-        access.directPeekBase = &myImage[(mySize - 2048) + (j & 0x07FF)];
+        access.directPeekBase = myImage.peekBase((mySize - 2048) + (j & 0x07FF));
         access.codeAccessBase = &myCodeAccessBase[(mySize - 2048) + (j & 0x07FF)];
         mySystem->setPageAccess(j >> System::S_PAGE_SHIFT, access);
     }
@@ -133,7 +130,7 @@ bool Cartridge3F::bank(uInt16 bank)
     for (uInt32 address = 0x1000; address < 0x1800;
         address += (1 << System::S_PAGE_SHIFT))
     {
-        access.directPeekBase = &myImage[offset + (address & 0x07FF)];
+        access.directPeekBase = myImage.peekBase(offset + (address & 0x07FF));
         access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x07FF)];
         mySystem->setPageAccess(address >> System::S_PAGE_SHIFT, access);
     }
@@ -158,9 +155,9 @@ bool Cartridge3F::patch(uInt16 address, uInt8 value)
     address &= 0x0FFF;
 
     if (address < 0x0800)
-        myImage[(address & 0x07FF) + (myCurrentBank << 11)] = value;
+        writableImage(myImage)[(address & 0x07FF) + (myCurrentBank << 11)] = value;
     else
-        myImage[(address & 0x07FF) + mySize - 2048] = value;
+        writableImage(myImage)[(address & 0x07FF) + mySize - 2048] = value;
 
     return myBankChanged = true;
 }
@@ -169,16 +166,26 @@ bool Cartridge3F::patch(uInt16 address, uInt8 value)
 const uInt8* Cartridge3F::getImage(int& size) const
 {
     size = mySize;
-    return myImage.get();
+    return myImage.data();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Layout of Cartridge3F::State: 1 short
+static constexpr Serializer::Layout StateLayout = {
+    Serializer::makeTag('3', 'F', ' ', 1), 0, 1, 0
+};
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge3F::save(Serializer& out) const
 {
+    static_assert(sizeof(State) == StateLayout.size(), "Cartridge3F::State layout");
+
     try
     {
-        out.putString(name());
-        out.putShort(myCurrentBank);
+        State state;
+        state.bank = myCurrentBank;
+
+        out.putBlock(StateLayout, &state);
     }
     catch (...)
     {
@@ -194,10 +201,11 @@ bool Cartridge3F::load(Serializer& in)
 {
     try
     {
-        if (in.getString() != name())
+        State state;
+        if (!in.getBlock(StateLayout, &state))
             return false;
 
-        myCurrentBank = in.getShort();
+        myCurrentBank = state.bank;
     }
     catch (...)
     {
@@ -49,11 +49,10 @@ class Cartridge3F : public Cartridge
       /**
         Create a new cartridge using the specified image and size
 
-        @param image     Pointer to the ROM image
-        @param size      The size of the ROM image
+        @param image     The ROM image, which is shared
         @param settings  A reference to the various settings (read-only)
       */
-    Cartridge3F(const uInt8* image, uInt32 size, const Settings& settings);
+    Cartridge3F(const RomImage& image, const Settings& settings);
     virtual ~Cartridge3F() = default;
 
     public:
@@ -104,6 +103,11 @@ class Cartridge3F : public Cartridge
     */
     const uInt8* getImage(int& size) const override;
 
+    /**
+      Get the ROM image to create an identical cartridge from (shared).
+    */
+    RomImage romImage() const override { return myImage; }
+
     /**
       Save the current state of this cart to the given Serializer.
 
@@ -157,8 +161,8 @@ class Cartridge3F : public Cartridge
     bool poke(uInt16 address, uInt8 value) override;
 
     private:
-      // Pointer to a dynamically allocated ROM image of the cartridge
-    BytePtr myImage;
+      // The ROM image of the cartridge, shared with the one it was loaded from
+    RomImage myImage;
 
     // Size of the ROM image
     uInt32 mySize;
@@ -166,6 +170,11 @@ class Cartridge3F : public Cartridge
     // Indicates which bank is currently active for the first segment
     uInt16 myCurrentBank;
 
+    // Fixed layout of the saved state (see Serializer::Layout)
+    struct State {
+        uInt16 bank;
+    };
+
     private:
       // Following constructors and assignment operators not supported
     Cartridge3F() = delete;
@@ -33,7 +33,6 @@ CartridgeCTY::CartridgeCTY(const uInt8* image, uInt32 size, const OSystem& osyst
     myRandomNumber(0x2B435044),
     myRamAccessTimeout(0),
     mySystemCycles(0),
-    myFractionalClocks(0.0),
     myCurrentBank(0)
 {
   // Copy the ROM image into my buffer
@@ -56,7 +55,7 @@ void CartridgeCTY::reset()
 
     // Update cycles to the current system cycles
     mySystemCycles = mySystem->cycles();
-    myFractionalClocks = 0.0;
+    myMusicClock.reset();
 
     // Upon reset we switch to the startup bank
     bank(myStartBank);
@@ -67,6 +66,12 @@ void CartridgeCTY::systemCyclesReset()
 {
   // Adjust the cycle counter so that it reflects the new value
     mySystemCycles -= mySystem->cycles();
+
+    // Keep a pending load/save the same time away; one that is due
+    // completes on the next access
+    if (myRamAccessTimeout > 0)
+        myRamAccessTimeout = myRamAccessTimeout > mySystem->cycles() ?
+            myRamAccessTimeout - mySystem->cycles() : 1;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -298,7 +303,8 @@ bool CartridgeCTY::save(Serializer& out) const
         out.putBool(myLDAimmediate);
         out.putInt(myRandomNumber);
         out.putInt(mySystemCycles);
-        out.putInt(uInt32(myFractionalClocks * 100000000.0));
+        out.putInt(myMusicClock.phase());
+        out.putInt(myRamAccessTimeout);
 
     }
     catch (...)
@@ -327,7 +333,8 @@ bool CartridgeCTY::load(Serializer& in)
         myLDAimmediate = in.getBool();
         myRandomNumber = in.getInt();
         mySystemCycles = in.getInt();
-        myFractionalClocks = double(in.getInt()) / 100000000.0;
+        myMusicClock.setPhase(in.getInt());
+        myRamAccessTimeout = in.getInt();
     }
     catch (...)
     {
@@ -377,7 +384,7 @@ uInt8 CartridgeCTY::ramReadWrite()
                 if (index < 7)
                 {
                   // Add 0.5 s delay for read
-                    myRamAccessTimeout = myOSystem.getTicks() + 500000;
+                    myRamAccessTimeout = mySystem->cycles() + 596591;
                     loadTune(index);
                 }
                 break;
@@ -385,7 +392,7 @@ uInt8 CartridgeCTY::ramReadWrite()
                 if (index < 4)
                 {
                   // Add 0.5 s delay for read
-                    myRamAccessTimeout = myOSystem.getTicks() + 500000;
+                    myRamAccessTimeout = mySystem->cycles() + 596591;
                     loadScore(index);
                 }
                 break;
@@ -393,13 +400,13 @@ uInt8 CartridgeCTY::ramReadWrite()
                 if (index < 4)
                 {
                   // Add 1 s delay for write
-                    myRamAccessTimeout = myOSystem.getTicks() + 1000000;
+                    myRamAccessTimeout = mySystem->cycles() + 1193182;
                     saveScore(index);
                 }
                 break;
             case 4:  // Wipe all score tables
               // Add 1 s delay for write
-                myRamAccessTimeout = myOSystem.getTicks() + 1000000;
+                myRamAccessTimeout = mySystem->cycles() + 1193182;
                 wipeAllScores();
                 break;
         }
@@ -409,7 +416,7 @@ uInt8 CartridgeCTY::ramReadWrite()
     else
     {
       // Have we reached the timeout value yet?
-        if (myOSystem.getTicks() >= myRamAccessTimeout)
+        if (mySystem->cycles() >= myRamAccessTimeout)
         {
             myRamAccessTimeout = 0;  // Turn off timer
             myRAM[0] = 0;            // Successful operation
@@ -518,9 +525,7 @@ inline void CartridgeCTY::updateMusicModeDataFetchers()
     mySystemCycles = mySystem->cycles();
 
     // Calculate the number of DPC OSC clocks since the last update
-    double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-    Int32 wholeClocks = Int32(clocks);
-    myFractionalClocks = clocks - double(wholeClocks);
+    Int32 wholeClocks = Int32(myMusicClock.clock(cycles));
 
     if (wholeClocks <= 0)
         return;
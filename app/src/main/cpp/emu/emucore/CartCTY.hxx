@@ -24,6 +24,7 @@ class System;
 
 #include "bspf.hxx"
 #include "Cart.hxx"
+#include "MusicClock.hxx"
 #ifdef DEBUGGER_SUPPORT
 #include "CartCTYWidget.hxx"
 #endif
@@ -290,11 +291,12 @@ class CartridgeCTY : public Cartridge
     // The random number generator register
     uInt32 myRandomNumber;
 
-    // The time after which the first request of a load/save operation
-    // will actually be completed
+    // The system cycle after which the first request of a load/save
+    // operation will actually be completed (0 if none is pending)
     // Due to Harmony EEPROM constraints, a read/write isn't instantaneous,
-    // so we need to emulate the delay as well
-    uInt64 myRamAccessTimeout;
+    // so we need to emulate the delay as well; this is measured in
+    // emulated time, so that it doesn't depend on the host's speed
+    uInt32 myRamAccessTimeout;
 
     // Full pathname of the file to use when emulating load/save
     // of internal RAM to Harmony cart EEPROM
@@ -304,7 +306,7 @@ class CartridgeCTY : public Cartridge
     Int32 mySystemCycles;
 
     // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks;
+    MusicClock myMusicClock;
 
     // Indicates which bank is currently active
     uInt16 myCurrentBank;
@@ -22,17 +22,14 @@
 #include "CartCVPlus.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-CartridgeCVPlus::CartridgeCVPlus(const uInt8* image, uInt32 size,
+CartridgeCVPlus::CartridgeCVPlus(const RomImage& image,
     const Settings& settings)
     : Cartridge(settings),
-    mySize(size),
+    mySize(image.size()),
     myCurrentBank(0)
 {
-  // Allocate array for the ROM image
-    myImage = make_ptr<uInt8[]>(mySize);
-
-    // Copy the ROM image into my buffer
-    memcpy(myImage.get(), image, mySize);
+  // Share the ROM image, it is only written to when patched
+    myImage = image;
     createCodeAccessBase(mySize + 1024);
 
     // Remember startup bank
@@ -151,7 +148,7 @@ bool CartridgeCVPlus::bank(uInt16 bank)
     for (uInt32 address = 0x1800; address < 0x2000;
         address += (1 << System::S_PAGE_SHIFT))
     {
-        access.directPeekBase = &myImage[offset + (address & 0x07FF)];
+        access.directPeekBase = myImage.peekBase(offset + (address & 0x07FF));
         access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x07FF)];
         mySystem->setPageAccess(address >> System::S_PAGE_SHIFT, access);
     }
@@ -185,7 +182,7 @@ bool CartridgeCVPlus::patch(uInt16 address, uInt8 value)
         myRAM[address & 0x03FF] = value;
     }
     else
-        myImage[(address & 0x07FF) + (myCurrentBank << 11)] = value;
+        writableImage(myImage)[(address & 0x07FF) + (myCurrentBank << 11)] = value;
 
     return myBankChanged = true;
 }
@@ -194,7 +191,7 @@ bool CartridgeCVPlus::patch(uInt16 address, uInt8 value)
 const uInt8* CartridgeCVPlus::getImage(int& size) const
 {
     size = mySize;
-    return myImage.get();
+    return myImage.data();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -56,11 +56,10 @@ class CartridgeCVPlus : public Cartridge
       /**
         Create a new cartridge using the specified image and size
 
-        @param image     Pointer to the ROM image
-        @param size      The size of the ROM image
+        @param image     The ROM image, which is shared
         @param settings  A reference to the various settings (read-only)
       */
-    CartridgeCVPlus(const uInt8* image, uInt32 size, const Settings& settings);
+    CartridgeCVPlus(const RomImage& image, const Settings& settings);
     virtual ~CartridgeCVPlus() = default;
 
     public:
@@ -111,6 +110,11 @@ class CartridgeCVPlus : public Cartridge
     */
     const uInt8* getImage(int& size) const override;
 
+    /**
+      Get the ROM image to create an identical cartridge from (shared).
+    */
+    RomImage romImage() const override { return myImage; }
+
     /**
       Save the current state of this cart to the given Serializer.
 
@@ -164,8 +168,8 @@ class CartridgeCVPlus : public Cartridge
     bool poke(uInt16 address, uInt8 value) override;
 
     private:
-      // Pointer to a dynamically allocated ROM image of the cartridge
-    BytePtr myImage;
+      // The ROM image of the cartridge, shared with the one it was loaded from
+    RomImage myImage;
 
     // The 1024 bytes of RAM
     uInt8 myRAM[1024];
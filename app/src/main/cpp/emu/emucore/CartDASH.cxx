@@ -22,15 +22,12 @@
 #include "CartDASH.hxx"
 
 //  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-CartridgeDASH::CartridgeDASH(const uInt8* image, uInt32 size, const Settings& settings)
+CartridgeDASH::CartridgeDASH(const RomImage& image, const Settings& settings)
     : Cartridge(settings),
-    mySize(size)
+    mySize(image.size())
 {
-  // Allocate array for the ROM image
-    myImage = make_ptr<uInt8[]>(mySize);
-
-    // Copy the ROM image into my buffer
-    memcpy(myImage.get(), image, mySize);
+  // Share the ROM image, it is only written to when patched
+    myImage = image;
     createCodeAccessBase(mySize + RAM_TOTAL_SIZE);
 
     // Remember startup bank (0 per spec, rather than last per 3E scheme).
@@ -237,7 +234,7 @@ void CartridgeDASH::bankROMSlot(uInt16 bank)
 
     for (uInt32 address = start; address <= end; address += (1 << System::S_PAGE_SHIFT))
     {
-        access.directPeekBase = &myImage[startCurrentBank + (address & (ROM_BANK_SIZE - 1))];
+        access.directPeekBase = myImage.peekBase(startCurrentBank + (address & (ROM_BANK_SIZE - 1)));
         access.codeAccessBase = &myCodeAccessBase[startCurrentBank + (address & (ROM_BANK_SIZE - 1))];
         mySystem->setPageAccess(address >> System::S_PAGE_SHIFT, access);
     }
@@ -295,7 +292,7 @@ bool CartridgeDASH::patch(uInt16 address, uInt8 value)
 
         uInt32 byteOffset = address & BITMASK_ROM_BANK;
         uInt32 baseAddress = (whichBankIsThere << ROM_BANK_TO_POWER) + byteOffset;
-        myImage[baseAddress] = value;   // write to the image
+        writableImage(myImage)[baseAddress] = value;   // write to the image
     }
 
     return myBankChanged;
@@ -308,7 +305,7 @@ bool CartridgeDASH::patch(uInt16 address, uInt8 value)
 const uInt8* CartridgeDASH::getImage(int& size) const
 {
     size = mySize;
-    return myImage.get();
+    return myImage.data();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
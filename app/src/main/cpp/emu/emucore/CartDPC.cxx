@@ -26,7 +26,6 @@ CartridgeDPC::CartridgeDPC(const uInt8* image, uInt32 size,
     : Cartridge(settings),
     mySize(size),
     mySystemCycles(0),
-    myFractionalClocks(0.0),
     myCurrentBank(0)
 {
   // Make a copy of the entire image
@@ -60,7 +59,7 @@ void CartridgeDPC::reset()
 {
   // Update cycles to the current system cycles
     mySystemCycles = mySystem->cycles();
-    myFractionalClocks = 0.0;
+    myMusicClock.reset();
 
     // Upon reset we switch to the startup bank
     bank(myStartBank);
@@ -113,9 +112,7 @@ inline void CartridgeDPC::updateMusicModeDataFetchers()
     mySystemCycles = mySystem->cycles();
 
     // Calculate the number of DPC OSC clocks since the last update
-    double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-    Int32 wholeClocks = Int32(clocks);
-    myFractionalClocks = clocks - double(wholeClocks);
+    Int32 wholeClocks = Int32(myMusicClock.clock(cycles));
 
     if (wholeClocks <= 0)
     {
@@ -487,7 +484,7 @@ bool CartridgeDPC::save(Serializer& out) const
         out.putByte(myRandomNumber);
 
         out.putInt(mySystemCycles);
-        out.putInt(uInt32(myFractionalClocks * 100000000.0));
+        out.putInt(myMusicClock.phase());
     }
     catch (...)
     {
@@ -530,7 +527,7 @@ bool CartridgeDPC::load(Serializer& in)
 
         // Get system cycles and fractional clocks
         mySystemCycles = Int32(in.getInt());
-        myFractionalClocks = double(in.getInt()) / 100000000.0;
+        myMusicClock.setPhase(in.getInt());
     }
     catch (...)
     {
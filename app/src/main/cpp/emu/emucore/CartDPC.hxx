@@ -24,6 +24,7 @@ class System;
 
 #include "bspf.hxx"
 #include "Cart.hxx"
+#include "MusicClock.hxx"
 #ifdef DEBUGGER_SUPPORT
 #include "CartDPCWidget.hxx"
 #endif
@@ -209,7 +210,7 @@ class CartridgeDPC : public Cartridge
     Int32 mySystemCycles;
 
     // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks;
+    MusicClock myMusicClock;
 
     // Indicates which bank is currently active
     uInt16 myCurrentBank;
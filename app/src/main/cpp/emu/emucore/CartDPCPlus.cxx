@@ -25,25 +25,28 @@
 #include "CartDPCPlus.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-CartridgeDPCPlus::CartridgeDPCPlus(const uInt8* image, uInt32 size,
+CartridgeDPCPlus::CartridgeDPCPlus(const RomImage& image,
     const Settings& settings)
     : Cartridge(settings),
     myFastFetch(false),
     myLDAimmediate(false),
     myParameterPointer(0),
     mySystemCycles(0),
-    myFractionalClocks(0.0),
     myCurrentBank(0)
 {
-  // Store image, making sure it's at least 29KB
+  // Share the image, making sure it's at least 29KB; it's only copied
+  // when the zeros following it don't make up for a smaller size
+    uInt32 size = image.size();
     uInt32 minsize = 4096 * 6 + 4096 + 1024 + 255;
     mySize = std::max(minsize, size);
-    myImage = make_ptr<uInt8[]>(mySize);
-    memcpy(myImage.get(), image, size);
+    if (size + image.padding() >= mySize)
+        myImage = image;
+    else
+        myImage = RomImage(image.data(), size, mySize - size);
     createCodeAccessBase(4096 * 6);
 
     // Pointer to the program ROM (24K @ 0 byte offset)
-    myProgramImage = myImage.get();
+    myProgramImage = myImage.data();
 
     // Pointer to the display RAM
     myDisplayImage = myDPCRAM + 0xC00;
@@ -59,7 +62,7 @@ CartridgeDPCPlus::CartridgeDPCPlus(const uInt8* image, uInt32 size,
 #ifdef THUMB_SUPPORT
   // Create Thumbulator ARM emulator
     myThumbEmulator = make_ptr<Thumbulator>
-        (reinterpret_cast<uInt16*>(myProgramImage - 0xC00),
+        (reinterpret_cast<const uInt16*>(myProgramImage - 0xC00),
             reinterpret_cast<uInt16*>(myDPCRAM),
             settings.getBool("thumb.trapfatal"));
 #endif
@@ -74,7 +77,7 @@ void CartridgeDPCPlus::reset()
 {
   // Update cycles to the current system cycles
     mySystemCycles = mySystem->cycles();
-    myFractionalClocks = 0.0;
+    myMusicClock.reset();
 
     setInitialState();
 
@@ -149,9 +152,7 @@ inline void CartridgeDPCPlus::updateMusicModeDataFetchers()
     mySystemCycles = mySystem->cycles();
 
     // Calculate the number of DPC OSC clocks since the last update
-    double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-    Int32 wholeClocks = Int32(clocks);
-    myFractionalClocks = clocks - double(wholeClocks);
+    Int32 wholeClocks = Int32(myMusicClock.clock(cycles));
 
     if (wholeClocks <= 0)
     {
@@ -621,7 +622,21 @@ bool CartridgeDPCPlus::patch(uInt16 address, uInt8 value)
     // For now, we ignore attempts to patch the DPC address space
     if (address >= 0x0080)
     {
-        myProgramImage[(myCurrentBank << 12) + (address & 0x0FFF)] = value;
+        // The program ROM moves along if the image has to be copied first
+        uInt32 program = uInt32(myProgramImage - myImage.data());
+        uInt8* image = writableImage(myImage);
+        if (image + program != myProgramImage)
+        {
+            myProgramImage = image + program;
+#ifdef THUMB_SUPPORT
+            myThumbEmulator = make_ptr<Thumbulator>
+                (reinterpret_cast<const uInt16*>(myProgramImage - 0xC00),
+                    reinterpret_cast<uInt16*>(myDPCRAM),
+                    mySettings.getBool("thumb.trapfatal"));
+#endif
+        }
+
+        image[program + (myCurrentBank << 12) + (address & 0x0FFF)] = value;
         return myBankChanged = true;
     }
     else
@@ -632,7 +647,7 @@ bool CartridgeDPCPlus::patch(uInt16 address, uInt8 value)
 const uInt8* CartridgeDPCPlus::getImage(int& size) const
 {
     size = mySize;
-    return myImage.get();
+    return myImage.data();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -683,7 +698,7 @@ bool CartridgeDPCPlus::save(Serializer& out) const
         out.putInt(myRandomNumber);
 
         out.putInt(mySystemCycles);
-        out.putInt(uInt32(myFractionalClocks * 100000000.0));
+        out.putInt(myMusicClock.phase());
     }
     catch (...)
     {
@@ -744,7 +759,7 @@ bool CartridgeDPCPlus::load(Serializer& in)
 
         // Get system cycles and fractional clocks
         mySystemCycles = in.getInt();
-        myFractionalClocks = double(in.getInt()) / 100000000.0;
+        myMusicClock.setPhase(in.getInt());
     }
     catch (...)
     {
@@ -30,6 +30,7 @@ class System;
 
 #include "bspf.hxx"
 #include "Cart.hxx"
+#include "MusicClock.hxx"
 
 /**
   Cartridge class used for DPC+, derived from Pitfall II.  There are six 4K
@@ -52,11 +53,10 @@ class CartridgeDPCPlus : public Cartridge
       /**
         Create a new cartridge using the specified image
 
-        @param image     Pointer to the ROM image
-        @param size      The size of the ROM image
+        @param image     The ROM image, which is shared
         @param settings  A reference to the various settings (read-only)
       */
-    CartridgeDPCPlus(const uInt8* image, uInt32 size, const Settings& settings);
+    CartridgeDPCPlus(const RomImage& image, const Settings& settings);
     virtual ~CartridgeDPCPlus() = default;
 
     public:
@@ -114,6 +114,11 @@ class CartridgeDPCPlus : public Cartridge
     */
     const uInt8* getImage(int& size) const override;
 
+    /**
+      Get the ROM image to create an identical cartridge from (shared).
+    */
+    RomImage romImage() const override { return myImage; }
+
     /**
       Save the current state of this cart to the given Serializer.
 
@@ -194,12 +199,12 @@ class CartridgeDPCPlus : public Cartridge
     void callFunction(uInt8 value);
 
     private:
-      // The ROM image and size
-    BytePtr myImage;
+      // The ROM image (shared, with at least mySize bytes readable) and size
+    RomImage myImage;
     uInt32 mySize;
 
     // Pointer to the 24K program ROM image of the cartridge
-    uInt8* myProgramImage;
+    const uInt8* myProgramImage;
 
     // Pointer to the 4K display ROM image of the cartridge
     uInt8* myDisplayImage;
@@ -261,7 +266,7 @@ class CartridgeDPCPlus : public Cartridge
     Int32 mySystemCycles;
 
     // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks;
+    MusicClock myMusicClock;
 
     // Indicates which bank is currently active
     uInt16 myCurrentBank;
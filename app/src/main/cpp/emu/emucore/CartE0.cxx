@@ -194,13 +194,23 @@ const uInt8* CartridgeE0::getImage(int& size) const
     return myImage;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Layout of CartridgeE0::State: 4 shorts
+static constexpr Serializer::Layout StateLayout = {
+    Serializer::makeTag('E', '0', ' ', 1), 0, 4, 0
+};
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeE0::save(Serializer& out) const
 {
+    static_assert(sizeof(State) == StateLayout.size(), "CartridgeE0::State layout");
+
     try
     {
-        out.putString(name());
-        out.putShortArray(myCurrentSlice, 4);
+        State state;
+        memcpy(state.slice, myCurrentSlice, sizeof(state.slice));
+
+        out.putBlock(StateLayout, &state);
     }
     catch (...)
     {
@@ -216,10 +226,11 @@ bool CartridgeE0::load(Serializer& in)
 {
     try
     {
-        if (in.getString() != name())
+        State state;
+        if (!in.getBlock(StateLayout, &state))
             return false;
 
-        in.getShortArray(myCurrentSlice, 4);
+        memcpy(myCurrentSlice, state.slice, sizeof(state.slice));
     }
     catch (...)
     {
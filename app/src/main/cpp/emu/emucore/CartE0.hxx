@@ -168,6 +168,11 @@ class CartridgeE0 : public Cartridge
       // Indicates the slice mapped into each of the four segments
     uInt16 myCurrentSlice[4];
 
+    // Fixed layout of the saved state (see Serializer::Layout)
+    struct State {
+        uInt16 slice[4];
+    };
+
     // The 8K ROM image of the cartridge
     uInt8 myImage[8192];
 
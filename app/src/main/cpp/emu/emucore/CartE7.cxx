@@ -271,15 +271,25 @@ const uInt8* CartridgeE7::getImage(int& size) const
     return myImage;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Layout of CartridgeE7::State: 3 shorts, 2048 bytes
+static constexpr Serializer::Layout StateLayout = {
+    Serializer::makeTag('E', '7', ' ', 1), 0, 3, 2048
+};
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeE7::save(Serializer& out) const
 {
+    static_assert(sizeof(State) == StateLayout.size(), "CartridgeE7::State layout");
+
     try
     {
-        out.putString(name());
-        out.putShortArray(myCurrentSlice, 2);
-        out.putShort(myCurrentRAM);
-        out.putByteArray(myRAM, 2048);
+        State state;
+        memcpy(state.slice, myCurrentSlice, sizeof(state.slice));
+        state.ramBank = myCurrentRAM;
+        memcpy(state.ram, myRAM, 2048);
+
+        out.putBlock(StateLayout, &state);
     }
     catch (...)
     {
@@ -295,12 +305,13 @@ bool CartridgeE7::load(Serializer& in)
 {
     try
     {
-        if (in.getString() != name())
+        State state;
+        if (!in.getBlock(StateLayout, &state))
             return false;
 
-        in.getShortArray(myCurrentSlice, 2);
-        myCurrentRAM = in.getShort();
-        in.getByteArray(myRAM, 2048);
+        memcpy(myCurrentSlice, state.slice, sizeof(state.slice));
+        myCurrentRAM = state.ramBank;
+        memcpy(myRAM, state.ram, 2048);
     }
     catch (...)
     {
@@ -197,6 +197,13 @@ class CartridgeE7 : public Cartridge
     // Indicates which 256 byte bank of RAM is being used
     uInt16 myCurrentRAM;
 
+    // Fixed layout of the saved state (see Serializer::Layout)
+    struct State {
+        uInt16 slice[2];
+        uInt16 ramBank;
+        uInt8 ram[2048];
+    };
+
     private:
       // Following constructors and assignment operators not supported
     CartridgeE7() = delete;
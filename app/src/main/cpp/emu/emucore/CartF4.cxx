@@ -134,13 +134,23 @@ const uInt8* CartridgeF4::getImage(int& size) const
     return myImage;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Layout of CartridgeF4::State: 1 short
+static constexpr Serializer::Layout StateLayout = {
+    Serializer::makeTag('F', '4', ' ', 1), 0, 1, 0
+};
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeF4::save(Serializer& out) const
 {
+    static_assert(sizeof(State) == StateLayout.size(), "CartridgeF4::State layout");
+
     try
     {
-        out.putString(name());
-        out.putShort(myCurrentBank);
+        State state;
+        state.bank = myCurrentBank;
+
+        out.putBlock(StateLayout, &state);
     }
     catch (...)
     {
@@ -156,10 +166,11 @@ bool CartridgeF4::load(Serializer& in)
 {
     try
     {
-        if (in.getString() != name())
+        State state;
+        if (!in.getBlock(StateLayout, &state))
             return false;
 
-        myCurrentBank = in.getShort();
+        myCurrentBank = state.bank;
     }
     catch (...)
     {
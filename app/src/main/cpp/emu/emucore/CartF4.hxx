@@ -157,6 +157,11 @@ class CartridgeF4 : public Cartridge
     // Indicates which bank is currently active
     uInt16 myCurrentBank;
 
+    // Fixed layout of the saved state (see Serializer::Layout)
+    struct State {
+        uInt16 bank;
+    };
+
     private:
       // Following constructors and assignment operators not supported
     CartridgeF4() = delete;
@@ -160,6 +160,12 @@ class CartridgeF4SC : public Cartridge
     // Indicates which bank is currently active
     uInt16 myCurrentBank;
 
+    // Fixed layout of the saved state (see Serializer::Layout)
+    struct State {
+        uInt16 bank;
+        uInt8 ram[128];
+    };
+
     private:
       // Following constructors and assignment operators not supported
     CartridgeF4SC() = delete;
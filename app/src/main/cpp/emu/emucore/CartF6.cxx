@@ -174,13 +174,23 @@ const uInt8* CartridgeF6::getImage(int& size) const
     return myImage;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Layout of CartridgeF6::State: 1 short
+static constexpr Serializer::Layout StateLayout = {
+    Serializer::makeTag('F', '6', ' ', 1), 0, 1, 0
+};
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeF6::save(Serializer& out) const
 {
+    static_assert(sizeof(State) == StateLayout.size(), "CartridgeF6::State layout");
+
     try
     {
-        out.putString(name());
-        out.putShort(myCurrentBank);
+        State state;
+        state.bank = myCurrentBank;
+
+        out.putBlock(StateLayout, &state);
     }
     catch (...)
     {
@@ -196,10 +206,11 @@ bool CartridgeF6::load(Serializer& in)
 {
     try
     {
-        if (in.getString() != name())
+        State state;
+        if (!in.getBlock(StateLayout, &state))
             return false;
 
-        myCurrentBank = in.getShort();
+        myCurrentBank = state.bank;
     }
     catch (...)
     {
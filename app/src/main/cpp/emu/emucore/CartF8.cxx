@@ -163,13 +163,23 @@ const uInt8* CartridgeF8::getImage(int& size) const
     return myImage;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Layout of CartridgeF8::State: 1 short
+static constexpr Serializer::Layout StateLayout = {
+    Serializer::makeTag('F', '8', ' ', 1), 0, 1, 0
+};
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeF8::save(Serializer& out) const
 {
+    static_assert(sizeof(State) == StateLayout.size(), "CartridgeF8::State layout");
+
     try
     {
-        out.putString(name());
-        out.putShort(myCurrentBank);
+        State state;
+        state.bank = myCurrentBank;
+
+        out.putBlock(StateLayout, &state);
     }
     catch (...)
     {
@@ -185,10 +195,11 @@ bool CartridgeF8::load(Serializer& in)
 {
     try
     {
-        if (in.getString() != name())
+        State state;
+        if (!in.getBlock(StateLayout, &state))
             return false;
 
-        myCurrentBank = in.getShort();
+        myCurrentBank = state.bank;
     }
     catch (...)
     {
@@ -159,6 +159,11 @@ class CartridgeF8 : public Cartridge
     // Indicates which bank is currently active
     uInt16 myCurrentBank;
 
+    // Fixed layout of the saved state (see Serializer::Layout)
+    struct State {
+        uInt16 bank;
+    };
+
     private:
       // Following constructors and assignment operators not supported
     CartridgeF8() = delete;
@@ -207,14 +207,24 @@ const uInt8* CartridgeF8SC::getImage(int& size) const
     return myImage;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Layout of CartridgeF8SC::State: 1 short, 128 bytes
+static constexpr Serializer::Layout StateLayout = {
+    Serializer::makeTag('F', '8', 'S', 1), 0, 1, 128
+};
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeF8SC::save(Serializer& out) const
 {
+    static_assert(sizeof(State) == StateLayout.size(), "CartridgeF8SC::State layout");
+
     try
     {
-        out.putString(name());
-        out.putShort(myCurrentBank);
-        out.putByteArray(myRAM, 128);
+        State state;
+        state.bank = myCurrentBank;
+        memcpy(state.ram, myRAM, 128);
+
+        out.putBlock(StateLayout, &state);
     }
     catch (...)
     {
@@ -230,11 +240,12 @@ bool CartridgeF8SC::load(Serializer& in)
 {
     try
     {
-        if (in.getString() != name())
+        State state;
+        if (!in.getBlock(StateLayout, &state))
             return false;
 
-        myCurrentBank = in.getShort();
-        in.getByteArray(myRAM, 128);
+        myCurrentBank = state.bank;
+        memcpy(myRAM, state.ram, 128);
     }
     catch (...)
     {
@@ -53,6 +53,16 @@ void CartridgeFA2::reset()
     bank(myStartBank);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeFA2::systemCyclesReset()
+{
+  // Keep a pending load/save the same time away; one that is due
+  // completes on the next access
+    if (myRamAccessTimeout > 0)
+        myRamAccessTimeout = myRamAccessTimeout > mySystem->cycles() ?
+            myRamAccessTimeout - mySystem->cycles() : 1;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeFA2::install(System& system)
 {
@@ -290,6 +300,7 @@ bool CartridgeFA2::save(Serializer& out) const
         out.putString(name());
         out.putShort(myCurrentBank);
         out.putByteArray(myRAM, 256);
+        out.putInt(myRamAccessTimeout);
     }
     catch (...)
     {
@@ -310,6 +321,7 @@ bool CartridgeFA2::load(Serializer& in)
 
         myCurrentBank = in.getShort();
         in.getByteArray(myRAM, 256);
+        myRamAccessTimeout = in.getInt();
     }
     catch (...)
     {
@@ -354,7 +366,7 @@ uInt8 CartridgeFA2::ramReadWrite()
     if (myRamAccessTimeout == 0)
     {
       // Remember when the first access was made
-        myRamAccessTimeout = myOSystem.getTicks();
+        myRamAccessTimeout = mySystem->cycles();
 
         // We go ahead and do the access now, and only return when a sufficient
         // amount of time has passed
@@ -371,7 +383,7 @@ uInt8 CartridgeFA2::ramReadWrite()
                 {
                     memset(myRAM, 0, 256);
                 }
-                myRamAccessTimeout += 500;  // Add 0.5 ms delay for read
+                myRamAccessTimeout += 597;  // Add 0.5 ms delay for read
             }
             else if (myRAM[255] == 2)  // write
             {
@@ -384,7 +396,7 @@ uInt8 CartridgeFA2::ramReadWrite()
                   // Maybe add logging here that save failed?
                     cerr << name() << ": ERROR saving score table" << endl;
                 }
-                myRamAccessTimeout += 101000;  // Add 101 ms delay for write
+                myRamAccessTimeout += 120511;  // Add 101 ms delay for write
             }
         }
         // Bit 6 is 1, busy
@@ -393,7 +405,7 @@ uInt8 CartridgeFA2::ramReadWrite()
     else
     {
       // Have we reached the timeout value yet?
-        if (myOSystem.getTicks() >= myRamAccessTimeout)
+        if (mySystem->cycles() >= myRamAccessTimeout)
         {
             myRamAccessTimeout = 0;  // Turn off timer
             myRAM[255] = 0;          // Successful operation
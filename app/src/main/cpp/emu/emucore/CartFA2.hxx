@@ -64,6 +64,13 @@ class CartridgeFA2 : public Cartridge
       */
     void reset() override;
 
+    /**
+      Notification method invoked by the system right before the
+      system resets its cycle counter to zero.  It may be necessary
+      to override this method for devices that remember cycle counts.
+    */
+    void systemCyclesReset() override;
+
     /**
       Install cartridge in the specified system.  Invoked by the system
       when the cartridge is attached to it.
@@ -198,11 +205,12 @@ class CartridgeFA2 : public Cartridge
     // The 256 bytes of RAM on the cartridge
     uInt8 myRAM[256];
 
-    // The time after which the first request of a load/save operation
-    // will actually be completed
+    // The system cycle after which the first request of a load/save
+    // operation will actually be completed (0 if none is pending)
     // Due to flash RAM constraints, a read/write isn't instantaneous,
-    // so we need to emulate the delay as well
-    uInt64 myRamAccessTimeout;
+    // so we need to emulate the delay as well; this is measured in
+    // emulated time, so that it doesn't depend on the host's speed
+    uInt32 myRamAccessTimeout;
 
     // Full pathname of the file to use when emulating load/save
     // of internal RAM to Harmony cart flash
@@ -21,17 +21,14 @@
 #include "CartMDM.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-CartridgeMDM::CartridgeMDM(const uInt8* image, uInt32 size, const Settings& settings)
+CartridgeMDM::CartridgeMDM(const RomImage& image, const Settings& settings)
     : Cartridge(settings),
-    mySize(size),
+    mySize(image.size()),
     myCurrentBank(0),
     myBankingDisabled(false)
 {
-  // Allocate array for the ROM image
-    myImage = make_ptr<uInt8[]>(mySize);
-
-    // Copy the ROM image into my buffer
-    memcpy(myImage.get(), image, mySize);
+  // Share the ROM image, it is only written to when patched
+    myImage = image;
     createCodeAccessBase(mySize);
 
     // Remember startup bank
@@ -116,7 +113,7 @@ bool CartridgeMDM::bank(uInt16 bank)
     for (uInt32 address = 0x1000; address < 0x2000;
         address += (1 << System::S_PAGE_SHIFT))
     {
-        access.directPeekBase = &myImage[offset + (address & 0x0FFF)];
+        access.directPeekBase = myImage.peekBase(offset + (address & 0x0FFF));
         access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x0FFF)];
         mySystem->setPageAccess(address >> System::S_PAGE_SHIFT, access);
     }
@@ -142,7 +139,7 @@ uInt16 CartridgeMDM::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeMDM::patch(uInt16 address, uInt8 value)
 {
-    myImage[(myCurrentBank << 12) + (address & 0x0FFF)] = value;
+    writableImage(myImage)[(myCurrentBank << 12) + (address & 0x0FFF)] = value;
     return myBankChanged = true;
 }
 
@@ -150,7 +147,7 @@ bool CartridgeMDM::patch(uInt16 address, uInt8 value)
 const uInt8* CartridgeMDM::getImage(int& size) const
 {
     size = mySize;
-    return myImage.get();
+    return myImage.data();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -54,11 +54,10 @@ class CartridgeMDM : public Cartridge
       /**
         Create a new cartridge using the specified image
 
-        @param image     Pointer to the ROM image
-        @param size      The size of the ROM image
+        @param image     The ROM image, which is shared
         @param settings  A reference to the various settings (read-only)
       */
-    CartridgeMDM(const uInt8* image, uInt32 size, const Settings& settings);
+    CartridgeMDM(const RomImage& image, const Settings& settings);
     virtual ~CartridgeMDM() = default;
 
     public:
@@ -109,6 +108,11 @@ class CartridgeMDM : public Cartridge
     */
     const uInt8* getImage(int& size) const override;
 
+    /**
+      Get the ROM image to create an identical cartridge from (shared).
+    */
+    RomImage romImage() const override { return myImage; }
+
     /**
       Save the current state of this cart to the given Serializer.
 
@@ -162,8 +166,8 @@ class CartridgeMDM : public Cartridge
     bool poke(uInt16 address, uInt8 value) override;
 
     private:
-      // Pointer to a dynamically allocated ROM image of the cartridge
-    BytePtr myImage;
+      // The ROM image of the cartridge, shared with the one it was loaded from
+    RomImage myImage;
 
     // Size of the ROM image
     uInt32 mySize;
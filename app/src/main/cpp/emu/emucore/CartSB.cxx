@@ -21,17 +21,14 @@
 #include "CartSB.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-CartridgeSB::CartridgeSB(const uInt8* image, uInt32 size,
+CartridgeSB::CartridgeSB(const RomImage& image,
     const Settings& settings)
     : Cartridge(settings),
-    mySize(size),
+    mySize(image.size()),
     myCurrentBank(0)
 {
-  // Allocate array for the ROM image
-    myImage = make_ptr<uInt8[]>(mySize);
-
-    // Copy the ROM image into my buffer
-    memcpy(myImage.get(), image, mySize);
+  // Share the ROM image, it is only written to when patched
+    myImage = image;
     createCodeAccessBase(mySize);
 
     // Remember startup bank
@@ -126,7 +123,7 @@ bool CartridgeSB::bank(uInt16 bank)
     for (uInt32 address = 0x1000; address < 0x2000;
         address += (1 << System::S_PAGE_SHIFT))
     {
-        access.directPeekBase = &myImage[offset + (address & 0x0FFF)];
+        access.directPeekBase = myImage.peekBase(offset + (address & 0x0FFF));
         access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x0FFF)];
         mySystem->setPageAccess(address >> System::S_PAGE_SHIFT, access);
     }
@@ -148,7 +145,7 @@ uInt16 CartridgeSB::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeSB::patch(uInt16 address, uInt8 value)
 {
-    myImage[(myCurrentBank << 12) + (address & 0x0FFF)] = value;
+    writableImage(myImage)[(myCurrentBank << 12) + (address & 0x0FFF)] = value;
     return myBankChanged = true;
 }
 
@@ -156,7 +153,7 @@ bool CartridgeSB::patch(uInt16 address, uInt8 value)
 const uInt8* CartridgeSB::getImage(int& size) const
 {
     size = mySize;
-    return myImage.get();
+    return myImage.data();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
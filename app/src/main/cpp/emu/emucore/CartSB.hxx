@@ -43,11 +43,10 @@ class CartridgeSB : public Cartridge
       /**
         Create a new cartridge using the specified image
 
-        @param image     Pointer to the ROM image
-        @param size      The size of the ROM image
+        @param image     The ROM image, which is shared
         @param settings  A reference to the various settings (read-only)
       */
-    CartridgeSB(const uInt8* image, uInt32 size, const Settings& settings);
+    CartridgeSB(const RomImage& image, const Settings& settings);
     virtual ~CartridgeSB() = default;
 
     public:
@@ -98,6 +97,11 @@ class CartridgeSB : public Cartridge
     */
     const uInt8* getImage(int& size) const override;
 
+    /**
+      Get the ROM image to create an identical cartridge from (shared).
+    */
+    RomImage romImage() const override { return myImage; }
+
     /**
       Save the current state of this cart to the given Serializer.
 
@@ -152,7 +156,7 @@ class CartridgeSB : public Cartridge
 
     private:
       // The 128-256K ROM image and size of the cartridge
-    BytePtr myImage;
+    RomImage myImage;
     uInt32 mySize;
 
     // Indicates which bank is currently active
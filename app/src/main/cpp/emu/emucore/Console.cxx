@@ -71,23 +71,21 @@ Console::Console(OSystem& osystem, unique_ptr<Cartridge>& cart,
     : myOSystem(osystem),
     myEvent(osystem.eventHandler().event()),
     myProperties(props),
+    myArena(osystem.consoleArena().acquire()),
     myCart(std::move(cart)),
     myDisplayFormat(""),  // Unknown TV format @ start
     myFramerate(0.0),     // Unknown framerate @ start
     myCurrentFormat(0),   // Unknown format @ start
-    myUserPaletteDefined(false)
+    myUserPalette(SharedContext::instance().userPalette(osystem.paletteFile()))
 {
-  // Load user-defined palette for this ROM
-    loadUserPalette();
-
     // Create subsystems for the console
-    my6502 = make_ptr<M6502>(myOSystem.settings());
-    myRiot = make_ptr<M6532>(*this, myOSystem.settings());
-    myTIA = make_ptr<TIA>(*this, myOSystem.sound(), myOSystem.settings());
-    mySwitches = make_ptr<Switches>(myEvent, myProperties);
+    my6502 = ConsoleArena::create<M6502>(myArena.get(), "cpu", myOSystem.settings());
+    myRiot = ConsoleArena::create<M6532>(myArena.get(), "riot", *this, myOSystem.settings());
+    myTIA = ConsoleArena::create<TIA>(myArena.get(), "tia", *this, myOSystem.sound(), myOSystem.settings());
+    mySwitches = ConsoleArena::create<Switches>(myArena.get(), "switches", myEvent, myProperties);
 
     // Construct the system and components
-    mySystem = make_ptr<System>(osystem, *my6502, *myRiot, *myTIA, *myCart);
+    mySystem = ConsoleArena::create<System>(myArena.get(), "system", osystem, *my6502, *myRiot, *myTIA, *myCart);
 
     // The real controllers for this console will be added later
     // For now, we just add dummy joystick controllers, since autodetection
@@ -163,6 +161,45 @@ Console::Console(OSystem& osystem, unique_ptr<Cartridge>& cart,
     myCart->setRomName(myConsoleInfo.CartName);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Console::Console(const Console& console, unique_ptr<Cartridge>& cart)
+    : myOSystem(console.myOSystem),
+    myEvent(console.myEvent),
+    myProperties(console.myProperties),
+    myCart(std::move(cart)),
+    myDisplayFormat(console.myDisplayFormat),
+    myFramerate(console.myFramerate),
+    myCurrentFormat(console.myCurrentFormat),
+    myUserPalette(console.myUserPalette),
+    myConsoleInfo(console.myConsoleInfo)
+{
+    my6502 = ConsoleArena::create<M6502>(myArena.get(), "cpu", myOSystem.settings());
+    myRiot = ConsoleArena::create<M6532>(myArena.get(), "riot", *this, myOSystem.settings());
+    myTIA = ConsoleArena::create<TIA>(myArena.get(), "tia", *this, myOSystem.sound(), myOSystem.settings());
+    mySwitches = ConsoleArena::create<Switches>(myArena.get(), "switches", myEvent, myProperties);
+
+    mySystem = ConsoleArena::create<System>(myArena.get(), "system", myOSystem, *my6502, *myRiot, *myTIA, *myCart);
+
+    // Same as above, but there's no autodetection to protect the real
+    // controllers from
+    myLeftControl = make_ptr<Joystick>(Controller::Left, myEvent, *mySystem);
+    myRightControl = make_ptr<Joystick>(Controller::Right, myEvent, *mySystem);
+
+    mySystem->initialize();
+
+    // The display format is already known, so only the TIA needs to be
+    // set up; keep the framerate it has settled on, which setTIAProperties()
+    // resets and the TIA picks up on reset
+    setTIAProperties();
+    myFramerate = console.myFramerate;
+
+    setControllers(myProperties.get(Cartridge_MD5));
+
+    mySystem->reset();
+
+    myCart->setRomName(myConsoleInfo.CartName);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Console::~Console()
 {
@@ -214,6 +251,37 @@ bool Console::load(Serializer& in)
     return true;  // success
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+unique_ptr<Console> Console::clone() const
+{
+    unique_ptr<Console> console;
+
+    try
+    {
+      // Create the cartridge as the detected type, so the image isn't
+      // scanned again (and shared if the cart shares it)
+        string md5 = myProperties.get(Cartridge_MD5);
+        string type = myCart->type();
+        string id;
+
+        unique_ptr<Cartridge> cart = Cartridge::create(myCart->romImage(),
+            md5, type, id, myOSystem, myOSystem.settings());
+
+        console = unique_ptr<Console>(new Console(*this, cart));
+
+        Serializer state;
+        if (!save(state) || !console->load(state))
+            console = nullptr;
+    }
+    catch (...)
+    {
+        cerr << "ERROR: Console::clone" << endl;
+        console = nullptr;
+    }
+
+    return console;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Console::toggleFormat(int direction)
 {
@@ -300,7 +368,7 @@ void Console::togglePalette()
     {
       // If we have a user-defined palette, it will come next in
       // the sequence; otherwise loop back to the standard one
-        if (myUserPaletteDefined)
+        if (myUserPalette)
         {
             palette = "user";
             message = "User-defined palette";
@@ -333,11 +401,17 @@ void Console::setPalette(const string& type)
 {
   // Look at all the palettes, since we don't know which one is
   // currently active
-    static uInt32* palettes[3][3] = {
+    const uInt32* palettes[3][3] = {
       { &ourNTSCPalette[0],     &ourPALPalette[0],     &ourSECAMPalette[0]     },
       { &ourNTSCPaletteZ26[0],  &ourPALPaletteZ26[0],  &ourSECAMPaletteZ26[0]  },
-      { &ourUserNTSCPalette[0], &ourUserPALPalette[0], &ourUserSECAMPalette[0] }
+      { nullptr,                nullptr,               nullptr                 }
     };
+    if (myUserPalette)
+    {
+        palettes[2][0] = &myUserPalette->ntsc[0];
+        palettes[2][1] = &myUserPalette->pal[0];
+        palettes[2][2] = &myUserPalette->secam[0];
+    }
 
     // See which format we should be using
     int paletteNum = 0;
@@ -345,7 +419,7 @@ void Console::setPalette(const string& type)
         paletteNum = 0;
     else if (type == "z26")
         paletteNum = 1;
-    else if (type == "user" && myUserPaletteDefined)
+    else if (type == "user" && myUserPalette)
         paletteNum = 2;
 
       // Now consider the current display format
@@ -746,83 +820,18 @@ void Console::setControllers(const string& rommd5)
     }
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Console::loadUserPalette()
-{
-    const string& palette = myOSystem.paletteFile();
-    ifstream in(palette, std::ios::binary);
-    if (!in)
-        return;
-
-      // Make sure the contains enough data for the NTSC, PAL and SECAM palettes
-      // This means 128 colours each for NTSC and PAL, at 3 bytes per pixel
-      // and 8 colours for SECAM at 3 bytes per pixel
-    in.seekg(0, std::ios::end);
-    std::streampos length = in.tellg();
-    in.seekg(0, std::ios::beg);
-    if (length < 128 * 3 * 2 + 8 * 3)
-    {
-        cerr << "ERROR: invalid palette file " << palette << endl;
-        return;
-    }
-
-    // Now that we have valid data, create the user-defined palettes
-    uInt8 pixbuf[3];  // Temporary buffer for one 24-bit pixel
-
-    for (int i = 0; i < 128; i++)  // NTSC palette
-    {
-        in.read(reinterpret_cast<char*>(pixbuf), 3);
-        uInt32 pixel = (int(pixbuf[0]) << 16) + (int(pixbuf[1]) << 8) + int(pixbuf[2]);
-        ourUserNTSCPalette[(i << 1)] = pixel;
-    }
-    for (int i = 0; i < 128; i++)  // PAL palette
-    {
-        in.read(reinterpret_cast<char*>(pixbuf), 3);
-        uInt32 pixel = (int(pixbuf[0]) << 16) + (int(pixbuf[1]) << 8) + int(pixbuf[2]);
-        ourUserPALPalette[(i << 1)] = pixel;
-    }
-
-    uInt32 secam[16];  // All 8 24-bit pixels, plus 8 colorloss pixels
-    for (int i = 0; i < 8; i++)    // SECAM palette
-    {
-        in.read(reinterpret_cast<char*>(pixbuf), 3);
-        uInt32 pixel = (int(pixbuf[0]) << 16) + (int(pixbuf[1]) << 8) + int(pixbuf[2]);
-        secam[(i << 1)] = pixel;
-        secam[(i << 1) + 1] = 0;
-    }
-    uInt32* ptr = ourUserSECAMPalette;
-    for (int i = 0; i < 16; ++i)
-    {
-        uInt32* s = secam;
-        for (int j = 0; j < 16; ++j)
-            *ptr++ = *s++;
-    }
-
-    myUserPaletteDefined = true;
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Console::generateColorLossPalette()
 {
-  // Look at all the palettes, since we don't know which one is
-  // currently active
-    uInt32* palette[9] = {
+  // Look at all the built-in palettes, since we don't know which one is
+  // currently active; the user-defined ones are shared and stay as read
+    uInt32* palette[6] = {
       &ourNTSCPalette[0],    &ourPALPalette[0],    &ourSECAMPalette[0],
-      &ourNTSCPaletteZ26[0], &ourPALPaletteZ26[0], &ourSECAMPaletteZ26[0],
-      0, 0, 0
+      &ourNTSCPaletteZ26[0], &ourPALPaletteZ26[0], &ourSECAMPaletteZ26[0]
     };
-    if (myUserPaletteDefined)
-    {
-        palette[6] = &ourUserNTSCPalette[0];
-        palette[7] = &ourUserPALPalette[0];
-        palette[8] = &ourUserSECAMPalette[0];
-    }
 
-    for (int i = 0; i < 9; ++i)
+    for (int i = 0; i < 6; ++i)
     {
-        if (palette[i] == 0)
-            continue;
-
           // Fill the odd numbered palette entries with gray values (calculated
           // using the standard RGB -> grayscale conversion formula)
         for (int j = 0; j < 128; ++j)
@@ -1137,12 +1146,3 @@ uInt32 Console::ourSECAMPaletteZ26[256] = {
   0x000000, 0, 0x2121ff, 0, 0xf03c79, 0, 0xff3cff, 0,
   0x7fff00, 0, 0x7fffff, 0, 0xffff3f, 0, 0xffffff, 0
 };
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 Console::ourUserNTSCPalette[256] = { 0 }; // filled from external file
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 Console::ourUserPALPalette[256] = { 0 }; // filled from external file
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 Console::ourUserSECAMPalette[256] = { 0 }; // filled from external file
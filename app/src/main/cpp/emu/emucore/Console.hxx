@@ -36,6 +36,8 @@ class CompuMate;
 #include "TIATables.hxx"
 ////#include "FrameBuffer.hxx"
 #include "Serializable.hxx"
+#include "ConsoleArena.hxx"
+#include "SharedContext.hxx"
 ////#include "NTSCFilter.hxx"
 #include "EventHandler.hxx"
 
@@ -129,6 +131,13 @@ class Console : public Serializable
     */
     M6532& riot() const { return *myRiot; }
 
+    /**
+      Get the arena the subsystems of the console live in
+
+      @return The arena, or the null pointer if they are on the heap
+    */
+    ConsoleArena* arena() const { return myArena.get(); }
+
     /**
       Saves the current state of this console class to the given Serializer.
 
@@ -145,6 +154,17 @@ class Console : public Serializable
     */
     bool load(Serializer& in) override;
 
+    /**
+      Create an independent copy of this console, i.e. to branch off from
+      the current state during a search.  The copy has its own cartridge
+      (created from this one's image), CPU, RIOT, TIA and controllers, and
+      the complete emulation state is copied over.  The OSystem, the event
+      object and the static tables and palettes are shared.
+
+      @return  The copy, or the null pointer if the state couldn't be copied
+    */
+    unique_ptr<Console> clone() const;
+
     /**
       Get a descriptor for this console class (used in error checking).
 
@@ -288,21 +308,24 @@ class Console : public Serializable
 
     private:
       /**
-        Sets various properties of the TIA (YStart, Height, etc) based on
-        the current display format.
+        Create a console with the same properties and display format as the
+        given one, skipping the autodetection (used by clone()).
+
+        @param console  The console to copy the setup from
+        @param cart     The cartridge to use with this console
       */
-    void setTIAProperties();
+    Console(const Console& console, unique_ptr<Cartridge>& cart);
 
     /**
-      Adds the left and right controllers to the console.
+      Sets various properties of the TIA (YStart, Height, etc) based on
+      the current display format.
     */
-    void setControllers(const string& rommd5);
+    void setTIAProperties();
 
     /**
-      Loads a user-defined palette file (from OSystem::paletteFile), filling the
-      appropriate user-defined palette arrays.
+      Adds the left and right controllers to the console.
     */
-    void loadUserPalette();
+    void setControllers(const string& rommd5);
 
     /**
       Loads all defined palettes with PAL color-loss data, even those that
@@ -324,24 +347,28 @@ class Console : public Serializable
     // Properties for the game
     Properties myProperties;
 
+    // The arena holding the subsystems below, if they aren't on the
+    // heap; declared first, so that it's given back after them
+    ConsoleArena::Lease myArena;
+
     // Pointer to the 6502 based system being emulated 
-    unique_ptr<System> mySystem;
+    ConsoleArena::Ptr<System> mySystem;
 
     // Pointer to the M6502 CPU
-    unique_ptr<M6502> my6502;
+    ConsoleArena::Ptr<M6502> my6502;
 
     // Pointer to the 6532 (aka RIOT) (the debugger needs it)
     // A RIOT of my own! (...with apologies to The Clash...)
-    unique_ptr<M6532> myRiot;
+    ConsoleArena::Ptr<M6532> myRiot;
 
     // Pointer to the TIA object 
-    unique_ptr<TIA> myTIA;
+    ConsoleArena::Ptr<TIA> myTIA;
 
     // Pointer to the Cartridge (the debugger needs it)
     unique_ptr<Cartridge> myCart;
 
     // Pointer to the switches on the front of the console
-    unique_ptr<Switches> mySwitches;
+    ConsoleArena::Ptr<Switches> mySwitches;
 
     // Pointers to the left and right controllers
     unique_ptr<Controller> myLeftControl, myRightControl;
@@ -358,9 +385,10 @@ class Console : public Serializable
     // Display format currently in use
     uInt32 myCurrentFormat;
 
-    // Indicates whether an external palette was found and
-    // successfully loaded
-    bool myUserPaletteDefined;
+    // The user-defined palette (from OSystem::paletteFile), or the null
+    // pointer if none was found; shared by the consoles using the same
+    // palette file
+    shared_ptr<const SharedContext::UserPalette> myUserPalette;
 
     // Contains detailed info about this console
     ConsoleInfo myConsoleInfo;
@@ -375,11 +403,6 @@ class Console : public Serializable
     static uInt32 ourPALPaletteZ26[256];
     static uInt32 ourSECAMPaletteZ26[256];
 
-    // Table of RGB values for NTSC, PAL and SECAM - user-defined
-    static uInt32 ourUserNTSCPalette[256];
-    static uInt32 ourUserPALPalette[256];
-    static uInt32 ourUserSECAMPalette[256];
-
     private:
       // Following constructors and assignment operators not supported
     Console() = delete;
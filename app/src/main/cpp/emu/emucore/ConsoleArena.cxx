@@ -0,0 +1,117 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <sstream>
+
+#include "M6502.hxx"
+#include "M6532.hxx"
+#include "Switches.hxx"
+#include "System.hxx"
+#include "TIA.hxx"
+#include "ConsoleArena.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ConsoleArena::ConsoleArena(uInt32 capacity)
+    : myMemory(make_ptr<uInt8[]>(capacity)),
+    myCapacity(capacity),
+    myUsed(0),
+    myTaken(false),
+    myNumComponents(0),
+    myOverflows(0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ConsoleArena::BytePtr ConsoleArena::createBytes(ConsoleArena* arena,
+    const char* component, uInt32 size)
+{
+    void* memory = arena ? arena->allocate(size, component) : nullptr;
+    if (memory == nullptr)
+        return BytePtr(new uInt8[size], ByteDeleter(false));
+
+    return BytePtr(static_cast<uInt8*>(memory), ByteDeleter(true));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ConsoleArena::Lease ConsoleArena::acquire()
+{
+    if (myTaken)
+        return Lease();
+
+    myTaken = true;
+    myUsed = myNumComponents = myOverflows = 0;
+
+    return Lease(this);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConsoleArena::release()
+{
+    myTaken = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 ConsoleArena::consoleSize()
+{
+    const uInt32 parts[] = {
+        sizeof(System), sizeof(M6502), sizeof(M6532), sizeof(TIA),
+        sizeof(Switches), 160 * 320, 160 * 320
+    };
+
+    uInt32 size = 0;
+    for (uInt32 part : parts)
+        size += (part + kAlignment - 1) / kAlignment * kAlignment;
+
+    return size;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void* ConsoleArena::allocate(uInt32 size, const char* component)
+{
+    uInt32 aligned = (size + kAlignment - 1) / kAlignment * kAlignment;
+    if (!myTaken || myUsed + aligned > myCapacity)
+    {
+        ++myOverflows;
+        return nullptr;
+    }
+
+    void* memory = myMemory.get() + myUsed;
+    myUsed += aligned;
+
+    // Parts with the same name are reported together
+    uInt32 i = 0;
+    while (i < myNumComponents && strcmp(myComponents[i].name, component) != 0)
+        ++i;
+    if (i == myNumComponents && myNumComponents < kMaxComponents)
+        myComponents[myNumComponents++] = { component, 0 };
+    if (i < myNumComponents)
+        myComponents[i].bytes += aligned;
+
+    return memory;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string ConsoleArena::info() const
+{
+    ostringstream buf;
+    buf << "arena=" << myCapacity << " used=" << myUsed
+        << " overflows=" << myOverflows;
+    for (uInt32 i = 0; i < myNumComponents; ++i)
+        buf << " " << myComponents[i].name << "=" << myComponents[i].bytes;
+
+    return buf.str();
+}
@@ -0,0 +1,163 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef CONSOLE_ARENA_HXX
+#define CONSOLE_ARENA_HXX
+
+#include <new>
+#include <utility>
+
+#include "bspf.hxx"
+
+/**
+  This class is one block of memory holding the subsystems of a console
+  (system, CPU, RIOT, TIA with its frame buffers, switches).  It is
+  allocated once per OSystem and used by one console at a time: loading
+  a ROM rewinds it instead of going back to the heap for every part.
+
+  Consoles built while the arena is taken (clones, the console of
+  getROMInfo) and parts which don't fit get their memory from the heap
+  as before; the pointers handed out know where their object lives.
+*/
+class ConsoleArena
+{
+    public:
+      /**
+        Create an arena with room for the given number of bytes.
+      */
+    explicit ConsoleArena(uInt32 capacity);
+
+    public:
+      // Destroys objects of the arena in place, and others on the heap
+    template<typename T>
+    struct Deleter {
+        bool inArena;
+
+        Deleter(bool arena = false) : inArena(arena) { }
+
+        void operator()(T* object) const {
+            if (inArena)
+                object->~T();
+            else
+                delete object;
+        }
+    };
+
+    template<typename T>
+    using Ptr = unique_ptr<T, Deleter<T>>;
+
+    // Byte arrays are never destroyed, only given back
+    struct ByteDeleter {
+        bool inArena;
+
+        ByteDeleter(bool arena = false) : inArena(arena) { }
+
+        void operator()(uInt8* bytes) const {
+            if (!inArena)
+                delete[] bytes;
+        }
+    };
+
+    using BytePtr = unique_ptr<uInt8[], ByteDeleter>;
+
+    /**
+      Create an object in the arena, or on the heap if there is no arena
+      or it is full.
+
+      @param arena      The arena, or the null pointer for the heap
+      @param component  The name of the part, for the memory report
+    */
+    template<typename T, typename... Args>
+    static Ptr<T> create(ConsoleArena* arena, const char* component,
+        Args&&... args)
+    {
+        void* memory = arena ? arena->allocate(sizeof(T), component) : nullptr;
+        if (memory == nullptr)
+            return Ptr<T>(new T(std::forward<Args>(args)...), Deleter<T>(false));
+
+        return Ptr<T>(new (memory) T(std::forward<Args>(args)...), Deleter<T>(true));
+    }
+
+    /**
+      Create a byte array in the arena, or on the heap if there is no
+      arena or it is full.
+    */
+    static BytePtr createBytes(ConsoleArena* arena, const char* component,
+        uInt32 size);
+
+    // Gives the arena back once the console using it is gone
+    struct Releaser {
+        void operator()(ConsoleArena* arena) const { arena->release(); }
+    };
+
+    using Lease = unique_ptr<ConsoleArena, Releaser>;
+
+    /**
+      Take the arena for a new console.  The lease must outlive
+      everything created in the arena.
+
+      @return  The lease, or an empty one if another console is using it
+    */
+    Lease acquire();
+
+    /**
+      The number of bytes a console needs, as a starting capacity.
+    */
+    static uInt32 consoleSize();
+
+    /**
+      Answers the memory taken by the parts of the console using the
+      arena, as a string of key=value pairs.
+    */
+    string info() const;
+
+    private:
+    // Get aligned memory for a part, or the null pointer if it is full
+    void* allocate(uInt32 size, const char* component);
+
+    // Give the arena back, once everything in it has been destroyed
+    void release();
+
+    private:
+    enum { kAlignment = 16, kMaxComponents = 16 };
+
+    unique_ptr<uInt8[]> myMemory;
+    uInt32 myCapacity;
+    uInt32 myUsed;
+    bool myTaken;
+
+    // The parts of the console using the arena, and their sizes
+    struct Component {
+        const char* name;
+        uInt32 bytes;
+    };
+    Component myComponents[kMaxComponents];
+    uInt32 myNumComponents;
+
+    // Parts which went to the heap because the arena was full
+    uInt32 myOverflows;
+
+    private:
+      // Following constructors and assignment operators not supported
+    ConsoleArena() = delete;
+    ConsoleArena(const ConsoleArena&) = delete;
+    ConsoleArena(ConsoleArena&&) = delete;
+    ConsoleArena& operator=(const ConsoleArena&) = delete;
+    ConsoleArena& operator=(ConsoleArena&&) = delete;
+};
+
+#endif
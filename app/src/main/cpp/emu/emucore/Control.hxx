@@ -23,6 +23,7 @@
 class Controller;
 class Event;
 class System;
+class MT24LC256;
 
 #include "Serializable.hxx"
 #include "bspf.hxx"
@@ -196,6 +197,12 @@ class Controller : public Serializable
         return false;
     }
 
+    /**
+      Returns the EEPROM built into this controller (SaveKey, AtariVox),
+      or the null pointer if it has none.
+    */
+    virtual MT24LC256* eeprom() const { return nullptr; }
+
 /**
   Returns the name of this controller.
 */
@@ -200,9 +200,10 @@ void EventHandler::poll(uInt64 time)
     // related to emulation
     if (myState == S_EMULATE)
     {
+      // A movie being played back or netplay replaces the input of this frame
+        myOSystem.state().updateInput(myEvent);
         myOSystem.console().riot().update();
 
-#if 0
     // Now check if the StateManager should be saving or loading state
     // Per-frame cheats are disabled if the StateManager is active, since
     // it would interfere with proper playback
@@ -211,7 +212,6 @@ void EventHandler::poll(uInt64 time)
             myOSystem.state().update();
         }
         else
-#endif
         {
 #ifdef CHEATCODE_SUPPORT
             for (auto& cheat : myOSystem.cheat().perFrame())
@@ -1142,17 +1142,20 @@ bool EventHandler::eventStateChange(Event::Type type)
 void EventHandler::setActionMappings(EventMode mode)
 {
     int listsize = 0;
-    ActionList* list = nullptr;
+    const ActionList* list = nullptr;
+    string* keys = nullptr;
 
     switch (mode)
     {
         case kEmulationMode:
             listsize = kEmulActionListSize;
             list = ourEmulActionList;
+            keys = myEmulActionKeys;
             break;
         case kMenuMode:
             listsize = kMenuActionListSize;
             list = ourMenuActionList;
+            keys = myMenuActionKeys;
             break;
         default:
             return;
@@ -1164,7 +1167,7 @@ void EventHandler::setActionMappings(EventMode mode)
     for (int i = 0; i < listsize; ++i)
     {
         Event::Type event = list[i].event;
-        list[i].key = "None";
+        keys[i] = "None";
         string key = "";
         for (int j = 0; j < KBDK_LAST; ++j)   // key mapping
         {
@@ -1271,7 +1274,7 @@ void EventHandler::setActionMappings(EventMode mode)
             key = prepend + ", " + key;
 
         if (key != "")
-            list[i].key = key;
+            keys[i] = key;
     }
 }
 
@@ -1793,12 +1796,12 @@ string EventHandler::keyAtIndex(int idx, EventMode mode) const
             if (idx < 0 || idx >= kEmulActionListSize)
                 return EmptyString;
             else
-                return ourEmulActionList[idx].key;
+                return myEmulActionKeys[idx];
         case kMenuMode:
             if (idx < 0 || idx >= kMenuActionListSize)
                 return EmptyString;
             else
-                return ourMenuActionList[idx].key;
+                return myMenuActionKeys[idx];
         default:
             return EmptyString;
     }
@@ -2095,7 +2098,7 @@ uInt32 EventHandler::resetEventsCallback(uInt32 interval, void* param)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-EventHandler::ActionList EventHandler::ourEmulActionList[kEmulActionListSize] = {
+const EventHandler::ActionList EventHandler::ourEmulActionList[kEmulActionListSize] = {
   { Event::ConsoleSelect,          "Select",                   "", true  },
   { Event::ConsoleReset,           "Reset",                    "", true  },
   { Event::ConsoleColor,           "Color TV",                 "", true  },
@@ -2202,7 +2205,7 @@ EventHandler::ActionList EventHandler::ourEmulActionList[kEmulActionListSize] =
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-EventHandler::ActionList EventHandler::ourMenuActionList[kMenuActionListSize] = {
+const EventHandler::ActionList EventHandler::ourMenuActionList[kMenuActionListSize] = {
   { Event::UIUp,        "Move Up",              "", false },
   { Event::UIDown,      "Move Down",            "", false },
   { Event::UILeft,      "Move Left",            "", false },
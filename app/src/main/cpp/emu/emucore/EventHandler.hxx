@@ -104,6 +104,7 @@ class EventHandler
       @return The event object
     */
     const Event& event() const { return myEvent; }
+    Event& event() { return myEvent; }
 
     /**
       Initialize state of this eventhandler.
@@ -584,8 +585,13 @@ class EventHandler
     uInt32 myContSnapshotCounter;
 
     // Holds static strings for the remap menu (emulation and menu events)
-    static ActionList ourEmulActionList[kEmulActionListSize];
-    static ActionList ourMenuActionList[kMenuActionListSize];
+    static const ActionList ourEmulActionList[kEmulActionListSize];
+    static const ActionList ourMenuActionList[kMenuActionListSize];
+
+    // The keys currently mapped to the actions of the lists above; kept
+    // per handler, since every OSystem has its own mappings
+    string myEmulActionKeys[kEmulActionListSize];
+    string myMenuActionKeys[kMenuActionListSize];
 
     // Static lookup tables for Stelladaptor/2600-daptor axis/button support
     static const Event::Type SA_Axis[2][2];
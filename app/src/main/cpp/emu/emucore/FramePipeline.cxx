@@ -0,0 +1,173 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <chrono>
+
+#include "TIA.hxx"
+#include "FramePipeline.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FramePipeline::FramePipeline()
+    : mySlots(new Slot[kSlots]),
+    myWritten(0),
+    myProcessed(0),
+    myReleased(0),
+    myDropped(0),
+    myProcessNanos(0),
+    myQuit(false)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FramePipeline::~FramePipeline()
+{
+    stopThread();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FramePipeline::setThreaded(bool threaded)
+{
+    if (threaded == isThreaded())
+        return;
+
+    if (threaded)
+    {
+        myQuit = false;
+        myThread = std::thread(&FramePipeline::run, this);
+    }
+    else
+        stopThread();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FramePipeline::stopThread()
+{
+    if (!myThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(mySignalLock);
+        myQuit = true;
+    }
+    mySignal.notify_one();
+    myThread.join();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FramePipeline::push(const TIA& tia, const uInt32* palette)
+{
+    uInt64 written = myWritten.load(std::memory_order_relaxed);
+
+    // The slot to write last held the frame kSlots back; it must have been
+    // given back (and so processed) already
+    if (written - myReleased >= kSlots)
+    {
+        ++myDropped;
+        return;
+    }
+
+    Slot& slot = mySlots[written % kSlots];
+    slot.height = std::min(tia.height(), uInt32(kMaxHeight));
+    slot.ystart = tia.ystart();
+    memcpy(slot.pixels, tia.currentFrameBuffer(), kWidth * slot.height);
+    memcpy(slot.palette, palette, sizeof(slot.palette));
+
+    if (!isThreaded())
+    {
+        process(slot);
+        myProcessed.store(written + 1, std::memory_order_release);
+        myWritten.store(written + 1, std::memory_order_relaxed);
+        return;
+    }
+
+    myWritten.store(written + 1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> guard(mySignalLock);
+    }
+    mySignal.notify_one();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FramePipeline::latest(emu_update_info_t& info)
+{
+    uInt64 processed = myProcessed.load(std::memory_order_acquire);
+    if (processed == 0)
+        return false;
+
+    // All frames before the newest one can be written again
+    myReleased = processed - 1;
+
+    const Slot& slot = mySlots[myReleased % kSlots];
+    info.video_buffer = slot.colors;
+    info.video_width = kWidth;
+    info.video_height = slot.height;
+    info.video_ystart = slot.ystart;
+    info.palette = nullptr;
+
+    return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string FramePipeline::info() const
+{
+    uInt64 processed = myProcessed;
+
+    ostringstream buf;
+    buf << "threaded=" << (isThreaded() ? 1 : 0)
+        << " frames=" << processed
+        << " dropped=" << myDropped
+        << " postMicros=" << (processed > 0 ? myProcessNanos / 1000.0 / processed : 0.0);
+
+    return buf.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FramePipeline::process(Slot& slot)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // Palette entries are 0x00bbggrr, so the pixels are RGBA in memory
+    const uInt8* src = slot.pixels;
+    uInt32* dest = slot.colors;
+    for (uInt32 i = 0; i < kWidth * slot.height; ++i)
+        dest[i] = 0xFF000000 | slot.palette[src[i]];
+
+    myProcessNanos += uInt64(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FramePipeline::run()
+{
+    for (;;)
+    {
+        uInt64 processed = myProcessed.load(std::memory_order_relaxed);
+        {
+            std::unique_lock<std::mutex> guard(mySignalLock);
+            mySignal.wait(guard, [&] {
+                return myQuit || myWritten.load(std::memory_order_acquire) > processed;
+            });
+
+            // Frames written before quitting are still finished
+            if (myWritten.load(std::memory_order_acquire) == processed)
+                break;
+        }
+
+        process(mySlots[processed % kSlots]);
+        myProcessed.store(processed + 1, std::memory_order_release);
+    }
+}
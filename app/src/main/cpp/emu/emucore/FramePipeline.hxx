@@ -0,0 +1,135 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef FRAME_PIPELINE_HXX
+#define FRAME_PIPELINE_HXX
+
+class TIA;
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "bspf.hxx"
+#include "emu_adapter.h"
+
+/**
+  This class turns the frames emulated into 32 bit colour frames, either
+  right away or on a thread of its own.
+
+  On its own thread, the post-processing of a frame runs while the next
+  one is emulated.  Every frame emulated is copied into a slot, which
+  the post-processing thread converts and hands back; the slots are
+  passed along by counters only, so neither side ever waits for the
+  other.  A frame arriving while all slots are busy is dropped.  The
+  frames shown lag one frame behind the emulation.
+*/
+class FramePipeline
+{
+    public:
+    FramePipeline();
+    ~FramePipeline();
+
+    public:
+      /**
+        Post-process the frames on a thread of their own, or right away
+        when they are pushed.
+      */
+    void setThreaded(bool threaded);
+    bool isThreaded() const { return myThread.joinable(); }
+
+    /**
+      Hand over the frame the TIA has just finished.
+
+      @param tia      The TIA with the frame
+      @param palette  The colours of the frame
+    */
+    void push(const TIA& tia, const uInt32* palette);
+
+    /**
+      Get the newest frame post-processed.  It stays valid until the
+      next call.
+
+      @return  False if no frame is done yet
+    */
+    bool latest(emu_update_info_t& info);
+
+    /**
+      Answers statistics on the frames post-processed, as a string of
+      key=value pairs.
+    */
+    string info() const;
+
+    /**
+      The number of bytes taken by the frames in the pipeline.
+    */
+    uInt32 size() const { return kSlots * sizeof(Slot); }
+
+    private:
+    enum : uInt32 {
+        kSlots = 3,  // one shown, one post-processed, one written
+        kWidth = 160,
+        kMaxHeight = 320
+    };
+
+    struct Slot {
+        // The immutable snapshot of the frame
+        uInt8 pixels[kWidth * kMaxHeight];
+        uInt32 palette[256];
+        uInt32 height;
+        uInt32 ystart;
+
+        // The result
+        uInt32 colors[kWidth * kMaxHeight];
+    };
+
+    // Convert the frame of a slot
+    void process(Slot& slot);
+
+    // Post-process the frames written, until told to quit
+    void run();
+
+    // Stop the thread, finishing the frames written
+    void stopThread();
+
+    private:
+    unique_ptr<Slot[]> mySlots;
+
+    // Frames written by the emulation, frames post-processed, and the
+    // first frame not yet given back (the one shown, once there is one)
+    std::atomic<uInt64> myWritten;
+    std::atomic<uInt64> myProcessed;
+    uInt64 myReleased;
+
+    uInt64 myDropped;
+    std::atomic<uInt64> myProcessNanos;
+
+    std::thread myThread;
+    std::mutex mySignalLock;
+    std::condition_variable mySignal;
+    bool myQuit;
+
+    private:
+      // Following constructors and assignment operators not supported
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline(FramePipeline&&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+    FramePipeline& operator=(FramePipeline&&) = delete;
+};
+
+#endif
@@ -0,0 +1,126 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef INPUT_QUEUE_HXX
+#define INPUT_QUEUE_HXX
+
+#include <atomic>
+
+#include "bspf.hxx"
+#include "Event.hxx"
+
+/**
+  A queue of timestamped input events, handed from the thread of the
+  user interface to the one emulating without locking.  There must be
+  only one thread pushing and one thread taking events at a time.
+
+  The queue has a fixed size; events pushed while it is full are dropped
+  (and counted).
+*/
+class InputQueue
+{
+    public:
+    struct Entry {
+        Event::Type event;
+        Int32 state;
+        uInt64 time;   // when it happened, in microseconds
+        bool pulse;    // released again at the start of the next frame
+    };
+
+    InputQueue() : myHead(0), myTail(0), myDropped(0) { }
+
+    public:
+      /**
+        Add an event at the end of the queue (thread pushing only).
+
+        @return  False if the queue is full and the event was dropped
+      */
+    bool push(const Entry& entry)
+    {
+        uInt32 tail = myTail.load(std::memory_order_relaxed);
+        if (tail - myHead.load(std::memory_order_acquire) == kCapacity)
+        {
+            myDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        myEntries[tail & (kCapacity - 1)] = entry;
+        myTail.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+      Get the event at the front of the queue without taking it
+      (thread taking events only).
+
+      @return  False if the queue is empty
+    */
+    bool peek(Entry& entry) const
+    {
+        uInt32 head = myHead.load(std::memory_order_relaxed);
+        if (head == myTail.load(std::memory_order_acquire))
+            return false;
+
+        entry = myEntries[head & (kCapacity - 1)];
+
+        return true;
+    }
+
+    /**
+      Take the event at the front of the queue (thread taking events only).
+    */
+    void pop()
+    {
+        myHead.store(myHead.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_release);
+    }
+
+    /**
+      The number of events waiting, as seen by the calling thread.
+    */
+    uInt32 size() const
+    {
+        return myTail.load(std::memory_order_acquire) -
+               myHead.load(std::memory_order_acquire);
+    }
+
+    /**
+      The number of events dropped because the queue was full.
+    */
+    uInt32 dropped() const { return myDropped.load(std::memory_order_relaxed); }
+
+    private:
+    enum { kCapacity = 64 };  // a power of two
+
+    Entry myEntries[kCapacity];
+
+    // Positions of the next event to take and to push, counting up forever
+    std::atomic<uInt32> myHead;
+    std::atomic<uInt32> myTail;
+
+    std::atomic<uInt32> myDropped;
+
+    private:
+      // Following constructors and assignment operators not supported
+    InputQueue(const InputQueue&) = delete;
+    InputQueue(InputQueue&&) = delete;
+    InputQueue& operator=(const InputQueue&) = delete;
+    InputQueue& operator=(InputQueue&&) = delete;
+};
+
+#endif
@@ -142,4 +142,4 @@ void Joystick::setDeadZone(int deadzone)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-int Joystick::_DEAD_ZONE = 3200;
+std::atomic<int> Joystick::_DEAD_ZONE(3200);
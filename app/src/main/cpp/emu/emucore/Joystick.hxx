@@ -20,6 +20,8 @@
 #ifndef JOYSTICK_HXX
 #define JOYSTICK_HXX
 
+#include <atomic>
+
 #include "bspf.hxx"
 #include "Control.hxx"
 #include "Event.hxx"
@@ -86,7 +88,7 @@ class Joystick : public Controller
 // Controller to emulate in normal mouse axis mode
     int myControlID;
 
-    static int _DEAD_ZONE;
+    static std::atomic<int> _DEAD_ZONE;
 
     private:
       // Following constructors and assignment operators not supported
@@ -275,43 +275,52 @@ void M6502::interruptHandler()
     myExecutionStatus &= ~(MaskableInterruptBit | NonmaskableInterruptBit);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Layout of M6502::State: 5 ints, 5 shorts, 13 bytes and 1 byte padding
+static constexpr Serializer::Layout StateLayout = {
+    Serializer::makeTag('C', 'P', 'U', 1), 5, 5, 14
+};
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool M6502::save(Serializer& out) const
 {
-    const string& CPU = name();
+    static_assert(sizeof(State) == StateLayout.size(), "M6502::State layout");
 
     try
     {
-        out.putString(CPU);
+        State state;
 
-        out.putByte(A);    // Accumulator
-        out.putByte(X);    // X index register
-        out.putByte(Y);    // Y index register
-        out.putByte(SP);   // Stack Pointer
-        out.putByte(IR);   // Instruction register
-        out.putShort(PC);  // Program Counter
+        state.A = A;    // Accumulator
+        state.X = X;    // X index register
+        state.Y = Y;    // Y index register
+        state.SP = SP;  // Stack Pointer
+        state.IR = IR;  // Instruction register
+        state.PC = PC;  // Program Counter
 
-        out.putBool(N);    // N flag for processor status register
-        out.putBool(V);    // V flag for processor status register
-        out.putBool(B);    // B flag for processor status register
-        out.putBool(D);    // D flag for processor status register
-        out.putBool(I);    // I flag for processor status register
-        out.putBool(notZ); // Z flag complement for processor status register
-        out.putBool(C);    // C flag for processor status register
+        state.N = N;    // Flags for processor status register
+        state.V = V;
+        state.B = B;
+        state.D = D;
+        state.I = I;
+        state.notZ = notZ;
+        state.C = C;
 
-        out.putByte(myExecutionStatus);
+        state.executionStatus = myExecutionStatus;
 
         // Indicates the number of distinct memory accesses
-        out.putInt(myNumberOfDistinctAccesses);
+        state.distinctAccesses = myNumberOfDistinctAccesses;
         // Indicates the last address(es) which was accessed
-        out.putShort(myLastAddress);
-        out.putShort(myLastPeekAddress);
-        out.putShort(myLastPokeAddress);
-        out.putShort(myDataAddressForPoke);
-        out.putInt(myLastSrcAddressS);
-        out.putInt(myLastSrcAddressA);
-        out.putInt(myLastSrcAddressX);
-        out.putInt(myLastSrcAddressY);
+        state.lastAddress = myLastAddress;
+        state.lastPeekAddress = myLastPeekAddress;
+        state.lastPokeAddress = myLastPokeAddress;
+        state.dataAddressForPoke = myDataAddressForPoke;
+        state.lastSrcAddressS = myLastSrcAddressS;
+        state.lastSrcAddressA = myLastSrcAddressA;
+        state.lastSrcAddressX = myLastSrcAddressX;
+        state.lastSrcAddressY = myLastSrcAddressY;
+        state.unused = 0;
+
+        out.putBlock(StateLayout, &state);
     }
     catch (...)
     {
@@ -325,41 +334,40 @@ bool M6502::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool M6502::load(Serializer& in)
 {
-    const string& CPU = name();
-
     try
     {
-        if (in.getString() != CPU)
+        State state;
+        if (!in.getBlock(StateLayout, &state))
             return false;
 
-        A = in.getByte();    // Accumulator
-        X = in.getByte();    // X index register
-        Y = in.getByte();    // Y index register
-        SP = in.getByte();   // Stack Pointer
-        IR = in.getByte();   // Instruction register
-        PC = in.getShort();  // Program Counter
+        A = state.A;    // Accumulator
+        X = state.X;    // X index register
+        Y = state.Y;    // Y index register
+        SP = state.SP;  // Stack Pointer
+        IR = state.IR;  // Instruction register
+        PC = state.PC;  // Program Counter
 
-        N = in.getBool();    // N flag for processor status register
-        V = in.getBool();    // V flag for processor status register
-        B = in.getBool();    // B flag for processor status register
-        D = in.getBool();    // D flag for processor status register
-        I = in.getBool();    // I flag for processor status register
-        notZ = in.getBool(); // Z flag complement for processor status register
-        C = in.getBool();    // C flag for processor status register
+        N = state.N;    // Flags for processor status register
+        V = state.V;
+        B = state.B;
+        D = state.D;
+        I = state.I;
+        notZ = state.notZ;
+        C = state.C;
 
-        myExecutionStatus = in.getByte();
+        myExecutionStatus = state.executionStatus;
 
         // Indicates the number of distinct memory accesses
-        myNumberOfDistinctAccesses = in.getInt();
+        myNumberOfDistinctAccesses = state.distinctAccesses;
         // Indicates the last address(es) which was accessed
-        myLastAddress = in.getShort();
-        myLastPeekAddress = in.getShort();
-        myLastPokeAddress = in.getShort();
-        myDataAddressForPoke = in.getShort();
-        myLastSrcAddressS = in.getInt();
-        myLastSrcAddressA = in.getInt();
-        myLastSrcAddressX = in.getInt();
-        myLastSrcAddressY = in.getInt();
+        myLastAddress = state.lastAddress;
+        myLastPeekAddress = state.lastPeekAddress;
+        myLastPokeAddress = state.lastPokeAddress;
+        myDataAddressForPoke = state.dataAddressForPoke;
+        myLastSrcAddressS = state.lastSrcAddressS;
+        myLastSrcAddressA = state.lastSrcAddressA;
+        myLastSrcAddressX = state.lastSrcAddressX;
+        myLastSrcAddressY = state.lastSrcAddressY;
     }
     catch (...)
     {
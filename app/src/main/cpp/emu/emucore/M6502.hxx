@@ -328,6 +328,18 @@ class M6502 : public Serializable
   /// is set to zero
     uInt16 myDataAddressForPoke;
 
+    /// Fixed layout of the saved state (see Serializer::Layout)
+    struct State {
+        uInt32 distinctAccesses;
+        Int32 lastSrcAddressS, lastSrcAddressA, lastSrcAddressX, lastSrcAddressY;
+        uInt16 PC;
+        uInt16 lastAddress, lastPeekAddress, lastPokeAddress, dataAddressForPoke;
+        uInt8 A, X, Y, SP, IR;
+        uInt8 N, V, B, D, I, notZ, C;
+        uInt8 executionStatus;
+        uInt8 unused;
+    };
+
     /// Indicates the number of system cycles per processor cycle 
     static constexpr uInt32 SYSTEM_CYCLES_PER_CPU = 1;
 
@@ -330,28 +330,39 @@ void M6532::setPinState(bool swcha)
     }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Layout of M6532::State: 3 ints, 139 bytes and 1 byte padding
+static constexpr Serializer::Layout StateLayout = {
+    Serializer::makeTag('R', 'I', 'T', 1), 3, 0, 140
+};
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool M6532::save(Serializer& out) const
 {
+    static_assert(sizeof(State) == StateLayout.size(), "M6532::State layout");
+
     try
     {
-        out.putString(name());
+        State state;
+
+        memcpy(state.ram, myRAM, 128);
 
-        out.putByteArray(myRAM, 128);
+        state.timer = myTimer;
+        state.intervalShift = myIntervalShift;
+        state.cyclesWhenTimerSet = myCyclesWhenTimerSet;
 
-        out.putInt(myTimer);
-        out.putInt(myIntervalShift);
-        out.putInt(myCyclesWhenTimerSet);
+        state.DDRA = myDDRA;
+        state.DDRB = myDDRB;
+        state.outA = myOutA;
+        state.outB = myOutB;
 
-        out.putByte(myDDRA);
-        out.putByte(myDDRB);
-        out.putByte(myOutA);
-        out.putByte(myOutB);
+        state.interruptFlag = myInterruptFlag;
+        state.timerFlagValid = myTimerFlagValid;
+        state.edgeDetectPositive = myEdgeDetectPositive;
+        memcpy(state.outTimer, myOutTimer, 4);
+        state.unused = 0;
 
-        out.putByte(myInterruptFlag);
-        out.putBool(myTimerFlagValid);
-        out.putBool(myEdgeDetectPositive);
-        out.putByteArray(myOutTimer, 4);
+        out.putBlock(StateLayout, &state);
     }
     catch (...)
     {
@@ -367,24 +378,25 @@ bool M6532::load(Serializer& in)
 {
     try
     {
-        if (in.getString() != name())
+        State state;
+        if (!in.getBlock(StateLayout, &state))
             return false;
 
-        in.getByteArray(myRAM, 128);
+        memcpy(myRAM, state.ram, 128);
 
-        myTimer = in.getInt();
-        myIntervalShift = in.getInt();
-        myCyclesWhenTimerSet = in.getInt();
+        myTimer = state.timer;
+        myIntervalShift = state.intervalShift;
+        myCyclesWhenTimerSet = state.cyclesWhenTimerSet;
 
-        myDDRA = in.getByte();
-        myDDRB = in.getByte();
-        myOutA = in.getByte();
-        myOutB = in.getByte();
+        myDDRA = state.DDRA;
+        myDDRB = state.DDRB;
+        myOutA = state.outA;
+        myOutB = state.outB;
 
-        myInterruptFlag = in.getByte();
-        myTimerFlagValid = in.getBool();
-        myEdgeDetectPositive = in.getBool();
-        in.getByteArray(myOutTimer, 4);
+        myInterruptFlag = state.interruptFlag;
+        myTimerFlagValid = state.timerFlagValid;
+        myEdgeDetectPositive = state.edgeDetectPositive;
+        memcpy(myOutTimer, state.outTimer, 4);
     }
     catch (...)
     {
@@ -117,6 +117,13 @@ class M6532 : public Device
     */
     string name() const override { return "M6532"; }
 
+    /**
+      Get the 128 bytes of RAM, without side effects on the system.
+
+      @return  Pointer to the RAM
+    */
+    const uInt8* getRAM() const { return myRAM; }
+
     public:
      /**
        Get the byte at the specified address
@@ -203,6 +210,20 @@ class M6532 : public Device
     // Last value written to the timer registers
     uInt8 myOutTimer[4];
 
+    // Fixed layout of the saved state (see Serializer::Layout)
+    struct State {
+        uInt32 timer;
+        uInt32 intervalShift;
+        Int32 cyclesWhenTimerSet;
+        uInt8 ram[128];
+        uInt8 DDRA, DDRB, outA, outB;
+        uInt8 interruptFlag;
+        uInt8 timerFlagValid;
+        uInt8 edgeDetectPositive;
+        uInt8 outTimer[4];
+        uInt8 unused;
+    };
+
     private:
       // Following constructors and assignment operators not supported
     M6532() = delete;
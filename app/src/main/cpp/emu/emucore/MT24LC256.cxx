@@ -68,7 +68,9 @@ MT24LC256::MT24LC256(const string& filename, const System& system)
     jpee_state(0),
     jpee_nb(0),
     jpee_address(0),
-    jpee_ad_known(0)
+    jpee_ad_known(0),
+    myCheckpointActive(false),
+    myCheckpointHasData(false)
 {
   // Load the data from an external file (if it exists)
     ifstream in(myDataFile, std::ios_base::binary);
@@ -149,7 +151,14 @@ void MT24LC256::update()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void MT24LC256::erase()
 {
-    memset(myData, 0xff, 32768);
+    memset(myData, 0xff, kDataSize);
+    myDataChanged = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MT24LC256::setData(const uInt8* data)
+{
+    memcpy(myData, data, kDataSize);
     myDataChanged = true;
 }
 
@@ -164,6 +173,60 @@ void MT24LC256::systemCyclesReset()
     myCyclesWhenTimerSet -= cycles;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MT24LC256::checkpoint()
+{
+    myCheckpoint.sda = mySDA;
+    myCheckpoint.scl = mySCL;
+    myCheckpoint.timerActive = myTimerActive;
+    myCheckpoint.dataChanged = myDataChanged;
+    myCheckpoint.cyclesWhenTimerSet = myCyclesWhenTimerSet;
+    myCheckpoint.cyclesWhenSDASet = myCyclesWhenSDASet;
+    myCheckpoint.cyclesWhenSCLSet = myCyclesWhenSCLSet;
+    myCheckpoint.mdat = jpee_mdat;
+    myCheckpoint.sdat = jpee_sdat;
+    myCheckpoint.mclk = jpee_mclk;
+    myCheckpoint.pptr = jpee_pptr;
+    myCheckpoint.state = jpee_state;
+    myCheckpoint.nb = jpee_nb;
+    myCheckpoint.address = jpee_address;
+    myCheckpoint.adKnown = jpee_ad_known;
+    memcpy(myCheckpoint.packet, jpee_packet, sizeof(jpee_packet));
+
+    myCheckpointActive = true;
+    myCheckpointHasData = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MT24LC256::rollback()
+{
+    if (!myCheckpointActive)
+        return;
+
+    mySDA = myCheckpoint.sda;
+    mySCL = myCheckpoint.scl;
+    myTimerActive = myCheckpoint.timerActive;
+    myDataChanged = myCheckpoint.dataChanged;
+    myCyclesWhenTimerSet = myCheckpoint.cyclesWhenTimerSet;
+    myCyclesWhenSDASet = myCheckpoint.cyclesWhenSDASet;
+    myCyclesWhenSCLSet = myCheckpoint.cyclesWhenSCLSet;
+    jpee_mdat = myCheckpoint.mdat;
+    jpee_sdat = myCheckpoint.sdat;
+    jpee_mclk = myCheckpoint.mclk;
+    jpee_pptr = myCheckpoint.pptr;
+    jpee_state = myCheckpoint.state;
+    jpee_nb = myCheckpoint.nb;
+    jpee_address = myCheckpoint.address;
+    jpee_ad_known = myCheckpoint.adKnown;
+    memcpy(jpee_packet, myCheckpoint.packet, sizeof(jpee_packet));
+
+    if (myCheckpointHasData)
+        memcpy(myData, myCheckpointData.get(), kDataSize);
+
+    myCheckpointActive = false;
+    myCheckpointHasData = false;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void MT24LC256::jpee_init()
 {
@@ -229,6 +292,14 @@ void MT24LC256::jpee_data_stop()
             jpee_pptr = 4 + jpee_pagemask - (jpee_address & jpee_pagemask);
             JPEE_LOG1("I2C_WARNING PAGECROSSING!(Truncate to %d bytes)", jpee_pptr - 3);
         }
+        if (myCheckpointActive && !myCheckpointHasData)
+        {
+          // First write since checkpoint(), keep the data to return to
+            if (!myCheckpointData)
+                myCheckpointData = make_ptr<uInt8[]>(kDataSize);
+            memcpy(myCheckpointData.get(), myData, kDataSize);
+            myCheckpointHasData = true;
+        }
         for (int i = 3; i < jpee_pptr; i++)
         {
             myDataChanged = true;
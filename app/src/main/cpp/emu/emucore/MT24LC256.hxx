@@ -35,6 +35,10 @@ class System;
 */
 class MT24LC256
 {
+    public:
+      // Size of the EEPROM in bytes
+    enum { kDataSize = 32768 };
+
     public:
       /**
         Create a new 24LC256 with its data stored in the given file
@@ -56,6 +60,10 @@ class MT24LC256
     /** Erase entire EEPROM to known state ($FF) */
     void erase();
 
+    /** Access the entire EEPROM contents (kDataSize bytes) */
+    const uInt8* getData() const { return myData; }
+    void setData(const uInt8* data);
+
     /**
       Notification method invoked by the system right before the
       system resets its cycle counter to zero.  It may be necessary
@@ -63,6 +71,15 @@ class MT24LC256
     */
     void systemCyclesReset();
 
+    /**
+      Remember the state of the device, and return to it later.  Used
+      around frames which are emulated and then taken back (run-ahead),
+      so they cannot commit writes to the EEPROM.  The data itself is
+      only copied once such a frame writes to it.
+    */
+    void checkpoint();
+    void rollback();
+
     private:
       // I2C access code provided by Supercat
     void jpee_init();
@@ -79,7 +96,7 @@ class MT24LC256
     const System& mySystem;
 
     // The EEPROM data
-    uInt8 myData[32768];
+    uInt8 myData[kDataSize];
 
     // Cached state of the SDA and SCL pins on the last write
     bool mySDA, mySCL;
@@ -109,6 +126,22 @@ class MT24LC256
     uInt32 jpee_address, jpee_ad_known;
     uInt8 jpee_packet[70];
 
+    // The state remembered by checkpoint()
+    struct Checkpoint
+    {
+        bool sda, scl, timerActive, dataChanged;
+        uInt32 cyclesWhenTimerSet, cyclesWhenSDASet, cyclesWhenSCLSet;
+        Int32 mdat, sdat, mclk, pptr, state, nb;
+        uInt32 address, adKnown;
+        uInt8 packet[70];
+    };
+    Checkpoint myCheckpoint;
+    bool myCheckpointActive;
+
+    // Copy of the EEPROM data, valid once written to after checkpoint()
+    BytePtr myCheckpointData;
+    bool myCheckpointHasData;
+
     private:
       // Following constructors and assignment operators not supported
     MT24LC256() = delete;
@@ -0,0 +1,91 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef MUSIC_CLOCK_HXX
+#define MUSIC_CLOCK_HXX
+
+#include "bspf.hxx"
+
+/**
+  Integer phase accumulator for the 20 kHz music OSC used by the DPC,
+  DPC+ and CTY carts.
+
+  The 6507 runs at 3579575 / 3 Hz, so one CPU cycle corresponds to
+  20000 * 3 / 3579575 = 2400 / 143183 OSC clocks.  Instead of tracking
+  the leftover fraction as a double, we keep the numerator of that
+  fraction (always less than 143183), which is exact and can be saved
+  and restored without loss.
+*/
+class MusicClock
+{
+    public:
+    MusicClock() : myPhase(0) { }
+
+    /**
+      Clear the fractional OSC clocks, as done on cart reset.
+    */
+    void reset() { myPhase = 0; }
+
+    /**
+      Advance the clock by the given number of CPU cycles.
+
+      @param cycles  CPU cycles elapsed since the last call
+      @return  The number of whole OSC clocks in that period
+    */
+    uInt32 clock(Int32 cycles)
+    {
+        if (cycles <= 0)
+            return 0;
+
+        uInt32 wholeClocks;
+
+        // Nearly every call covers only a few hundred cycles, which fits
+        // into 32-bit arithmetic; fall back to 64-bit for long gaps
+        if (uInt32(cycles) < kMaxFastCycles)
+        {
+            uInt32 phase = uInt32(cycles) * kCycleStep + myPhase;
+            wholeClocks = phase / kPeriod;
+            myPhase = phase - wholeClocks * kPeriod;
+        }
+        else
+        {
+            uInt64 phase = uInt64(cycles) * kCycleStep + myPhase;
+            wholeClocks = uInt32(phase / kPeriod);
+            myPhase = uInt32(phase - uInt64(wholeClocks) * kPeriod);
+        }
+
+        return wholeClocks;
+    }
+
+    /**
+      Get/set the fractional OSC clock numerator (for state saving).
+    */
+    uInt32 phase() const { return myPhase; }
+    void setPhase(uInt32 phase) { myPhase = phase % kPeriod; }
+
+    private:
+    enum : uInt32 {
+        kCycleStep     = 2400,    // OSC clock numerator added per CPU cycle
+        kPeriod        = 143183,  // one whole OSC clock
+        kMaxFastCycles = (0xffffffff - kPeriod) / kCycleStep
+    };
+
+    // Fractional OSC clocks unused during the last update, in 1/kPeriod units
+    uInt32 myPhase;
+};
+
+#endif
@@ -0,0 +1,624 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <deque>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "OSystem.hxx"
+#include "Settings.hxx"
+#include "Console.hxx"
+#include "Event.hxx"
+#include "EventHandler.hxx"
+#include "M6532.hxx"
+#include "TIA.hxx"
+#include "Sound.hxx"
+#include "StateManager.hxx"
+
+#include "NetplayManager.hxx"
+
+static_assert(sizeof(sockaddr_in) <= 16, "Peer address too small");
+
+// Packets: 'S', the state size and the state, sent by the host until the
+// guest answers; or 'I', the newest frame, the first frame the sender is
+// missing the input of the receiver for (its acknowledgement), the number
+// of inputs and the inputs of that many frames up to the newest one.
+// Every input packet repeats all inputs the receiver hasn't acknowledged,
+// so any number of lost packets is made up for by the next one.
+static const uInt8 kStatePacket = 'S';
+static const uInt8 kInputPacket = 'I';
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static void putInt(uInt8* dest, uInt32 value)
+{
+    dest[0] = uInt8(value);
+    dest[1] = uInt8(value >> 8);
+    dest[2] = uInt8(value >> 16);
+    dest[3] = uInt8(value >> 24);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static uInt32 getInt(const uInt8* src)
+{
+    return uInt32(src[0]) | (uInt32(src[1]) << 8) |
+        (uInt32(src[2]) << 16) | (uInt32(src[3]) << 24);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static int openSocket(uInt32 address, uInt32 port)
+{
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
+        return -1;
+
+    sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(address);
+    local.sin_port = htons(uInt16(port));
+
+    if (bind(fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0 ||
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK) != 0)
+    {
+        ::close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+NetplayManager::NetplayManager(OSystem& osystem)
+    : myOSystem(osystem),
+    myMode(kOff),
+    myPlayer(0),
+    myLocalMask(0),
+    myMaxRollback(1),
+    mySocket(-1),
+    myFrame(0),
+    myConfirmed(0),
+    myRollbackFrame(0),
+    myPeerConfirmed(0),
+    myStateSize(0),
+    myPeerQuit(false),
+    myRollbacks(0),
+    myMispredictions(0),
+    myResimFrames(0),
+    myResimTicks(0),
+    myMaxDepth(0),
+    myStalls(0),
+    myPacketsSent(0),
+    myPacketsReceived(0)
+{
+    memset(myPeerAddress, 0, sizeof(myPeerAddress));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+NetplayManager::~NetplayManager()
+{
+    close();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool NetplayManager::start(int player)
+{
+    close();
+
+    if (!myOSystem.hasConsole() || player < 0 || player > 1)
+        return false;
+
+    const Settings& settings = myOSystem.settings();
+    const string& peer = settings.getString("netpeer");
+    uInt32 port = uInt32(settings.getInt("netport"));
+    bool loopback = peer == "loopback";
+
+    // The stand-in always plays the guest
+    if (peer.empty() || (loopback && player != 0))
+        return false;
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+
+    if (loopback)
+    {
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(uInt16(port + 1));
+    }
+    else
+    {
+        // "host:port"
+        string::size_type colon = peer.rfind(':');
+        addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+
+        addrinfo* result = nullptr;
+        if (colon == string::npos ||
+            getaddrinfo(peer.substr(0, colon).c_str(), peer.substr(colon + 1).c_str(),
+                        &hints, &result) != 0 || result == nullptr)
+        {
+            myOSystem.logMessage("Netplay: can't resolve peer '" + peer + "'", 0);
+            return false;
+        }
+        memcpy(&address, result->ai_addr, sizeof(address));
+        freeaddrinfo(result);
+    }
+    memcpy(myPeerAddress, &address, sizeof(address));
+
+    mySocket = openSocket(loopback ? INADDR_LOOPBACK : INADDR_ANY, port);
+    if (mySocket < 0)
+    {
+        myOSystem.logMessage("Netplay: can't open socket", 0);
+        return false;
+    }
+
+    if (loopback)
+    {
+        int fd = openSocket(INADDR_LOOPBACK, port + 1);
+        if (fd < 0)
+        {
+            myOSystem.logMessage("Netplay: can't open loopback peer socket", 0);
+            close();
+            return false;
+        }
+        myPeerQuit = false;
+        myPeerThread = std::thread(&NetplayManager::runLoopbackPeer, this, fd, port,
+                                   uInt32(settings.getInt("netdelay")) * 1000);
+    }
+
+    myPlayer = player;
+    myLocalMask = player == 0 ?
+        StateManager::kInputLeftJoystick | StateManager::kInputSwitches :
+        StateManager::kInputRightJoystick;
+    myMaxRollback = uInt32(BSPF::clamp(settings.getInt("netrollback"), 1, int(kMaxRollback)));
+
+    for (Input& in : myInputs)
+        in.localFrame = in.remoteFrame = ~0u;
+    myFrame = myConfirmed = myRollbackFrame = myPeerConfirmed = 0;
+
+    myRollbacks = myMispredictions = myResimFrames = myResimTicks = 0;
+    myMaxDepth = 0;
+    myStalls = myPacketsSent = myPacketsReceived = 0;
+
+    // The guest starts from whatever the host sends
+    if (player == 0 && !saveFrame(0))
+    {
+        close();
+        return false;
+    }
+
+    myMode = kConnecting;
+
+    return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void NetplayManager::stop()
+{
+    if (myMode == kRunning)
+    {
+        // Both sides should end up in the same state, so wait for the
+        // input of all frames emulated so far
+        uInt64 deadline = myOSystem.getTicks() + kDrainMicros;
+        while (myConfirmed < myFrame && myOSystem.getTicks() < deadline)
+        {
+            sendInput(myFrame - 1);
+            receive(5000);
+        }
+
+        if (myRollbackFrame < myFrame)
+            rollback();
+    }
+
+    close();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool NetplayManager::update(Event& event)
+{
+    if (myMode == kConnecting)
+    {
+        if (myPlayer == 0)
+            sendState();
+        receive(kStallMicros);
+
+        if (myMode != kRunning)
+            return false;
+    }
+    else if (myMode != kRunning)
+        return false;
+
+    // The local input is taken once per frame, even if the frame has to
+    // wait for the peer
+    Input& current = input(myFrame);
+    if (current.localFrame != myFrame)
+    {
+        current.localFrame = myFrame;
+        current.local = StateManager::packInput(event) & myLocalMask;
+    }
+
+    sendInput(myFrame);
+    receive(0);
+
+    // Never get further ahead of the peer than a rollback can go back
+    uInt64 deadline = myOSystem.getTicks() + kStallMicros;
+    while (myFrame + 1 > myConfirmed + myMaxRollback)
+    {
+        uInt64 now = myOSystem.getTicks();
+        if (now >= deadline)
+        {
+            ++myStalls;
+            return false;
+        }
+        receive(uInt32(deadline - now));
+    }
+
+    if (myRollbackFrame < myFrame)
+        rollback();
+
+    if (!saveFrame(myFrame))
+        return false;
+
+    current.used = current.remoteFrame == myFrame ? current.remote : predictedInput();
+    StateManager::unpackInput(current.local | current.used, event);
+
+    myRollbackFrame = ++myFrame;
+
+    return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string NetplayManager::stats() const
+{
+    ostringstream buf;
+    buf << "mode=" << (myMode == kRunning ? "running" :
+                       myMode == kConnecting ? "connecting" : "off")
+        << " player=" << myPlayer
+        << " frames=" << myFrame
+        << " confirmed=" << myConfirmed
+        << " rollbacks=" << myRollbacks
+        << " mispredictions=" << myMispredictions
+        << " avgDepth=" << (myRollbacks > 0 ? double(myResimFrames) / myRollbacks : 0.0)
+        << " maxDepth=" << myMaxDepth
+        << " resimFrames=" << myResimFrames
+        << " resimMicros=" << myResimTicks
+        << " stalls=" << myStalls
+        << " sent=" << myPacketsSent
+        << " received=" << myPacketsReceived;
+
+    return buf.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 NetplayManager::loopbackInput(uInt32 frame)
+{
+    // A new joystick direction and fire button every 10 frames
+    uInt32 hash = (frame / 10 + 1) * 2654435761u;
+    return ((hash >> 27) << 5) & StateManager::kInputRightJoystick;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 NetplayManager::predictedInput() const
+{
+    return myConfirmed > 0 ? myInputs[(myConfirmed - 1) % kRingSize].remote : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void NetplayManager::receive(uInt32 micros)
+{
+    if (micros > 0)
+    {
+        pollfd pfd;
+        pfd.fd = mySocket;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, int((micros + 999) / 1000)) <= 0)
+            return;
+    }
+
+    uInt8 packet[65536];
+    for (;;)
+    {
+        ssize_t size = recv(mySocket, packet, sizeof(packet), 0);
+        if (size <= 0)
+            break;
+
+        ++myPacketsReceived;
+        handlePacket(packet, uInt32(size));
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void NetplayManager::handlePacket(const uInt8* data, uInt32 size)
+{
+    if (size >= 5 && data[0] == kStatePacket)
+    {
+        // Only the guest starts from a state sent by the peer
+        uInt32 stateSize = getInt(data + 1);
+        if (myPlayer != 1 || myMode != kConnecting || stateSize != size - 5)
+            return;
+
+        myState.setData(data + 5, stateSize);
+        if (myOSystem.console().load(myState))
+            myMode = kRunning;
+    }
+    else if (size >= 10 && data[0] == kInputPacket)
+    {
+        uInt32 newest = getInt(data + 1);
+        uInt32 acked = getInt(data + 5);
+        uInt32 count = data[9];
+        if (size != 10 + count * 4 || count > newest + 1)
+            return;
+
+        // The first input tells the host the guest has started
+        if (myMode == kConnecting)
+        {
+            if (myPlayer != 0)
+                return;
+            myMode = kRunning;
+        }
+
+        for (uInt32 i = 0; i < count; ++i)
+        {
+            uInt32 frame = newest - (count - 1) + i;
+            if (frame < myConfirmed || frame >= myFrame + kRingSize / 2)
+                continue;
+
+            Input& in = input(frame);
+            if (in.remoteFrame == frame)
+                continue;
+
+            in.remoteFrame = frame;
+            in.remote = getInt(data + 10 + i * 4) & ~myLocalMask;
+
+            // Emulated with the wrong input already
+            if (frame < myFrame && in.remote != in.used)
+            {
+                ++myMispredictions;
+                myRollbackFrame = std::min(myRollbackFrame, frame);
+            }
+        }
+
+        while (input(myConfirmed).remoteFrame == myConfirmed)
+            ++myConfirmed;
+
+        // Packets may arrive out of order
+        if (acked > myPeerConfirmed && acked <= myFrame + 1)
+            myPeerConfirmed = acked;
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void NetplayManager::sendInput(uInt32 newest)
+{
+    // Neither side gets more than twice the rollback ahead of the other,
+    // so the inputs not acknowledged yet are still in the ring
+    uInt8 packet[10 + kRingSize * 4];
+    uInt32 first = std::max(myPeerConfirmed, newest + 1 > kRingSize ? newest + 1 - kRingSize : 0);
+    uInt32 count = newest + 1 > first ? newest + 1 - first : 0;
+
+    packet[0] = kInputPacket;
+    putInt(packet + 1, newest);
+    putInt(packet + 5, myConfirmed);
+    packet[9] = uInt8(count);
+    for (uInt32 i = 0; i < count; ++i)
+        putInt(packet + 10 + i * 4, input(first + i).local);
+
+    if (sendto(mySocket, packet, 10 + count * 4, 0,
+               reinterpret_cast<const sockaddr*>(myPeerAddress), sizeof(sockaddr_in)) > 0)
+        ++myPacketsSent;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void NetplayManager::sendState()
+{
+    uInt8 packet[65536];
+    if (5 + myStateSize > sizeof(packet))
+        return;
+
+    packet[0] = kStatePacket;
+    putInt(packet + 1, myStateSize);
+    memcpy(packet + 5, mySnapshots.get(), myStateSize);
+
+    if (sendto(mySocket, packet, 5 + myStateSize, 0,
+               reinterpret_cast<const sockaddr*>(myPeerAddress), sizeof(sockaddr_in)) > 0)
+        ++myPacketsSent;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void NetplayManager::rollback()
+{
+    uInt64 startTicks = myOSystem.getTicks();
+    uInt32 depth = myFrame - myRollbackFrame;
+
+    if (!loadFrame(myRollbackFrame))
+    {
+        myOSystem.logMessage("Netplay: rollback failed, out of sync", 0);
+        myRollbackFrame = myFrame;
+        return;
+    }
+
+    // Nothing emulated again is presented or heard
+    Event& event = myOSystem.eventHandler().event();
+    myOSystem.sound().suppressWrites(true);
+    for (uInt32 frame = myRollbackFrame; frame < myFrame; ++frame)
+    {
+        if (frame > myRollbackFrame)
+            saveFrame(frame);
+
+        Input& in = input(frame);
+        in.used = in.remoteFrame == frame ? in.remote : predictedInput();
+        emulateFrame(in.local | in.used, event);
+    }
+    myOSystem.sound().suppressWrites(false);
+
+    myRollbackFrame = myFrame;
+
+    ++myRollbacks;
+    myResimFrames += depth;
+    myMaxDepth = std::max(myMaxDepth, depth);
+    myResimTicks += myOSystem.getTicks() - startTicks;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool NetplayManager::saveFrame(uInt32 frame)
+{
+    myState.reset();
+    if (!myOSystem.console().save(myState))
+        return false;
+
+    // All states of one cart type have the same size
+    uInt32 size = myState.size();
+    if (size != myStateSize)
+    {
+        mySnapshots = make_ptr<uInt8[]>(size * (myMaxRollback + 1));
+        myStateSize = size;
+    }
+    memcpy(mySnapshots.get() + (frame % (myMaxRollback + 1)) * size,
+           myState.data(), size);
+
+    return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool NetplayManager::loadFrame(uInt32 frame)
+{
+    if (myStateSize == 0)
+        return false;
+
+    myState.setData(mySnapshots.get() + (frame % (myMaxRollback + 1)) * myStateSize,
+                    myStateSize);
+
+    return myOSystem.console().load(myState);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void NetplayManager::emulateFrame(uInt32 input, Event& event)
+{
+    StateManager::unpackInput(input, event);
+    myOSystem.console().riot().update();
+    myOSystem.console().tia().update();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void NetplayManager::close()
+{
+    if (myPeerThread.joinable())
+    {
+        myPeerQuit = true;
+        myPeerThread.join();
+    }
+
+    if (mySocket >= 0)
+    {
+        ::close(mySocket);
+        mySocket = -1;
+    }
+
+    myMode = kOff;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void NetplayManager::runLoopbackPeer(int fd, uInt32 port, uInt32 delayMicros)
+{
+    // Answers the state and every input packet of the host with its own
+    // input up to the same frame, from the first one the host is missing,
+    // 'delayMicros' later
+    struct Reply {
+        uInt64 time;
+        uInt32 newest;
+        uInt32 first;
+    };
+    std::deque<Reply> replies;
+    bool started = false;
+    uInt32 answered = 0;
+
+    sockaddr_in host;
+    memset(&host, 0, sizeof(host));
+    host.sin_family = AF_INET;
+    host.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    host.sin_port = htons(uInt16(port));
+
+    uInt8 packet[65536];
+    while (!myPeerQuit)
+    {
+        uInt64 now = myOSystem.getTicks();
+        int timeout = replies.empty() ? 5 :
+            int(replies.front().time > now ? (replies.front().time - now + 999) / 1000 : 0);
+
+        pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        poll(&pfd, 1, timeout);
+
+        ssize_t size;
+        while ((size = recv(fd, packet, sizeof(packet), 0)) > 0)
+        {
+            now = myOSystem.getTicks();
+            if (packet[0] == kStatePacket && !started)
+            {
+                started = true;
+                replies.push_back({ now + delayMicros, 0, 0 });
+            }
+            else if (packet[0] == kInputPacket && started && size >= 10)
+            {
+                // Answered again while the host misses any input, even
+                // if nothing new came in
+                uInt32 newest = getInt(packet + 1);
+                uInt32 acked = getInt(packet + 5);
+                if (newest > answered || acked <= answered)
+                {
+                    answered = std::max(answered, newest);
+                    replies.push_back({ now + delayMicros, newest, acked });
+                }
+            }
+        }
+
+        now = myOSystem.getTicks();
+        while (!replies.empty() && replies.front().time <= now)
+        {
+            // The stand-in ignores the input of the host, so it claims
+            // to have all of it
+            uInt32 newest = replies.front().newest;
+            uInt32 first = std::max(replies.front().first,
+                                    newest + 1 > kRingSize ? newest + 1 - kRingSize : 0);
+            uInt32 count = newest + 1 > first ? newest + 1 - first : 0;
+            replies.pop_front();
+
+            packet[0] = kInputPacket;
+            putInt(packet + 1, newest);
+            putInt(packet + 5, newest + 1);
+            packet[9] = uInt8(count);
+            for (uInt32 i = 0; i < count; ++i)
+                putInt(packet + 10 + i * 4, loopbackInput(first + i));
+
+            sendto(fd, packet, 10 + count * 4, 0,
+                   reinterpret_cast<const sockaddr*>(&host), sizeof(host));
+        }
+    }
+
+    ::close(fd);
+}
@@ -0,0 +1,210 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef NETPLAY_MANAGER_HXX
+#define NETPLAY_MANAGER_HXX
+
+#include <atomic>
+#include <thread>
+
+class OSystem;
+class Event;
+
+#include "Serializer.hxx"
+
+/**
+  This class lets two emulator instances play together over UDP, with
+  rollback to hide the network latency.
+
+  Player 0 (the host) owns the left joystick and the console switches,
+  player 1 (the guest) the right joystick.  The host sends its console
+  state to the guest once, and from then on both sides only exchange
+  the input word (see StateManager::packInput()) of every frame.
+
+  Emulation never waits for the input of the peer.  Until it arrives,
+  the peer is predicted to hold its last known input.  The state at the
+  start of each of the last 'netrollback' frames is kept in a ring; when
+  the real input of the peer differs from the prediction, the console
+  goes back to the state of that frame and silently emulates the frames
+  up to the current one again.  Only if the peer falls more than
+  'netrollback' frames behind does emulation halt for it.
+
+  Setting 'netpeer' to "loopback" starts a stand-in guest on a thread,
+  which answers every frame of the host after 'netdelay' ms with a
+  scripted input (see loopbackInput()).
+*/
+class NetplayManager
+{
+    public:
+    NetplayManager(OSystem& osystem);
+    ~NetplayManager();
+
+    public:
+      /**
+        Open the socket and connect to the peer from the 'netpeer' and
+        'netport' settings.  The host sends the current state to the guest;
+        both halt until the connection is made.
+
+        @param player  0 to play as the host, 1 as the guest
+
+        @return  False if the socket could not be set up
+      */
+    bool start(int player);
+
+    /**
+      Wait for the outstanding input of the peer, correct the current
+      state if needed, and close the connection.
+    */
+    void stop();
+
+    /**
+      Close the connection right away, e.g. when the console goes away.
+    */
+    void close();
+
+    /**
+      Answers whether a connection is open (or being made).
+    */
+    bool isActive() const { return myMode != kOff; }
+
+    /**
+      Exchange input with the peer, roll back if a prediction turned out
+      wrong, and replace the input of the coming frame with the local
+      input and that of the peer.  This must be called before the input
+      reaches the controllers.
+
+      @param event  The event object the controllers read
+
+      @return  False if the frame must not be emulated yet (not connected,
+               or too far ahead of the peer)
+    */
+    bool update(Event& event);
+
+    /**
+      Answers a description of the connection and the cost of the
+      rollbacks so far.
+    */
+    string stats() const;
+
+    /**
+      The input the loopback stand-in plays as player 1 in the given frame.
+    */
+    static uInt32 loopbackInput(uInt32 frame);
+
+    private:
+    enum Mode {
+        kOff,
+        kConnecting,
+        kRunning
+    };
+
+    enum {
+        kRingSize = 64,         // input entries; covers twice the max. rollback
+        kMaxRollback = 30,
+        kStallMicros = 20000,   // wait for the peer this long before halting
+        kDrainMicros = 1000000  // wait for the peer this long when stopping
+    };
+
+    struct Input {
+        uInt32 localFrame;      // frame 'local' belongs to
+        uInt32 local;
+        uInt32 remoteFrame;     // frame 'remote' was received for
+        uInt32 remote;
+        uInt32 used;            // the remote input the frame was emulated with
+    };
+
+    Input& input(uInt32 frame) { return myInputs[frame % kRingSize]; }
+
+    // The remote input to assume for a frame not received yet
+    uInt32 predictedInput() const;
+
+    // Receive all pending packets; wait up to 'micros' for the first one
+    void receive(uInt32 micros);
+    void handlePacket(const uInt8* data, uInt32 size);
+
+    // Send the local inputs the peer hasn't acknowledged up to the given
+    // frame, or the state to start from
+    void sendInput(uInt32 newest);
+    void sendState();
+
+    // Go back to myRollbackFrame and emulate up to the current frame again
+    void rollback();
+
+    // Save/restore the state at the start of a frame to/from the ring
+    bool saveFrame(uInt32 frame);
+    bool loadFrame(uInt32 frame);
+
+    // Emulate one frame with the given input word
+    void emulateFrame(uInt32 input, Event& event);
+
+    // The stand-in guest, run on myPeerThread
+    void runLoopbackPeer(int fd, uInt32 port, uInt32 delayMicros);
+
+    private:
+      // The parent OSystem object
+    OSystem& myOSystem;
+
+    Mode myMode;
+    int myPlayer;
+    uInt32 myLocalMask;         // bits of the input word owned by this side
+    uInt32 myMaxRollback;
+
+    // The socket, and the address of the peer (a sockaddr_in)
+    int mySocket;
+    uInt8 myPeerAddress[16];
+
+    // The next frame to be emulated, the first frame the remote input is
+    // missing for, and the first frame to emulate again (or myFrame)
+    uInt32 myFrame;
+    uInt32 myConfirmed;
+    uInt32 myRollbackFrame;
+
+    // The first frame the peer is missing the local input for, as far as
+    // it has acknowledged
+    uInt32 myPeerConfirmed;
+
+    Input myInputs[kRingSize];
+
+    // States at the start of the last myMaxRollback + 1 frames
+    Serializer myState;
+    BytePtr mySnapshots;
+    uInt32 myStateSize;
+
+    // Stand-in peer
+    std::thread myPeerThread;
+    std::atomic<bool> myPeerQuit;
+
+    // Metrics
+    uInt64 myRollbacks;
+    uInt64 myMispredictions;
+    uInt64 myResimFrames;
+    uInt64 myResimTicks;
+    uInt32 myMaxDepth;
+    uInt64 myStalls;
+    uInt64 myPacketsSent;
+    uInt64 myPacketsReceived;
+
+    private:
+      // Following constructors and assignment operators not supported
+    NetplayManager() = delete;
+    NetplayManager(const NetplayManager&) = delete;
+    NetplayManager(NetplayManager&&) = delete;
+    NetplayManager& operator=(const NetplayManager&) = delete;
+    NetplayManager& operator=(NetplayManager&&) = delete;
+};
+
+#endif
@@ -18,6 +18,7 @@
 //============================================================================
 
 #include <cassert>
+#include <mutex>
 #include <sstream>
 #include <fstream>
 
@@ -59,6 +60,11 @@
 #include "Version.hxx"
 
 #include "TIA.hxx"
+#include "M6532.hxx"
+#include "MT24LC256.hxx"
+#include "ConsoleArena.hxx"
+#include "FramePipeline.hxx"
+#include "SharedContext.hxx"
 #include "OSystem.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -92,19 +98,25 @@ OSystem::OSystem()
 
     mySettings = make_ptr<Settings>(*this); ////MediaFactory::createSettings(*this);
     myRandom = make_ptr<Random>(*this);
+    myConsoleArena = make_ptr<ConsoleArena>(ConsoleArena::consoleSize());
 
     myPalette = NULL;
+    myPaletteVersion = 0;
+    myHeadless = false;
     lastJoystickInput = 0x0;
     lastSoundCycle = 0;
 
-    selectTriggered = selectReleased = false;
-    resetTriggered = resetReleased = false;
+    inputBase = 0;
+    frameCycles = 76 * 262;
+    inputApplied = inputMidFrame = 0;
+
+    runAheadFrames = 0;
+    frameTicks = runAheadTicks = frameCount = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 OSystem::~OSystem()
 {
-    freePalette();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -163,8 +175,10 @@ bool OSystem::create()
     // a real serial port on the system
     ////mySerialPort = MediaFactory::createSerialPort();
 
-    // Re-initialize random seed
-    myRandom->initSeed();
+    // Re-initialize random seed; a fixed seed makes emulation reproducible
+    myRandom->setSeed(uInt32(mySettings->getInt("seed")));
+
+    runAheadFrames = mySettings->getInt("runahead");
 
     // Create PNG handler
     ////myPNGLib = make_ptr<PNGLibrary>(*myFrameBuffer);
@@ -335,6 +349,10 @@ string OSystem::createConsole(const Rom& rom, const string& md5sum,
     try
     {
         closeConsole();
+
+        // The old console goes first, so that the new one can take over
+        // its arena
+        myConsole.reset();
         myConsole = openConsole(myRomFile, myRomMD5, type, id);
     }
     catch (const runtime_error& e)
@@ -474,15 +492,23 @@ string OSystem::getROMInfo(const Rom& romfile)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void OSystem::logMessage(const string& message, uInt8 level)
 {
+    // The console is shared by all instances, which may log from
+    // different threads
+    static std::mutex consoleLock;
+
     if (level == 0)
     {
+        std::lock_guard<std::mutex> guard(consoleLock);
         cout << message << endl << std::flush;
         myLogMessages += message + "\n";
     }
     else if (level <= uInt8(mySettings->getInt("loglevel")))
     {
         if (mySettings->getBool("logtoconsole"))
+        {
+            std::lock_guard<std::mutex> guard(consoleLock);
             cout << message << endl << std::flush;
+        }
         myLogMessages += message + "\n";
     }
 }
@@ -493,11 +519,10 @@ unique_ptr<Console> OSystem::openConsole(const Rom& romfile,
 {
     unique_ptr<Console> console;
 
-    // Open the cartridge image and read it in
-    const uInt8* image = NULL;
-    uInt32 size = 0;
+    // Open the cartridge image, shared with the ROM file
+    RomImage image = openROM(romfile, md5);
 
-    if ((image = openROM(romfile, md5, size)) != nullptr)
+    if (!image.empty())
     {
       // Get a valid set of properties, including any entered on the commandline
       // For initial creation of the Cart, we're only concerned with the BS type
@@ -517,7 +542,7 @@ unique_ptr<Console> OSystem::openConsole(const Rom& romfile,
         string cartmd5 = md5;
         type = props.get(Cartridge_Type);
         unique_ptr<Cartridge> cart =
-            Cartridge::create(image, size, cartmd5, type, id, *this, *mySettings);
+            Cartridge::create(image, cartmd5, type, id, *this, *mySettings);
 
           // It's possible that the cart created was from a piece of the image,
           // and that the md5 (and hence the cart) has changed
@@ -570,23 +595,21 @@ void OSystem::closeConsole()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-const uInt8* OSystem::openROM(const Rom& rom, string& md5, uInt32& size)
+RomImage OSystem::openROM(const Rom& rom, string& md5)
 {
   // This method has a documented side-effect:
-  // It not only loads a ROM and creates an array with its contents,
-  // but also adds a properties entry if the one for the ROM doesn't
-  // contain a valid name
+  // It not only loads a ROM and shares the image of it, but also adds
+  // a properties entry if the one for the ROM doesn't contain a valid name
 
-    size = rom.getImageSize();
-    const uInt8* image = (const uInt8*) rom.getImage();
+    const RomImage& image = rom.getRomImage();
 
-    if (NULL == image) return NULL;
+    if (image.empty()) return image;
 
     // If we get to this point, we know we have a valid file to open
     // Now we make sure that the file has a valid properties entry
     // To save time, only generate an MD5 if we really need one
     if (md5 == "")
-        md5 = MD5::hash(image, size);
+        md5 = MD5::hash(image.data(), image.size());
 
       // Some games may not have a name, since there may not
       // be an entry in stella.pro.  In that case, we use the rom name
@@ -726,9 +749,7 @@ void OSystem::showMessage(const std::string& message, int positionInfo, bool for
 
 void OSystem::setPalette(const uInt32* palette)
 {
-    freePalette();
-
-    myPalette = new uInt32[256];
+    uInt32 colors[256];
 
     #ifdef SWAP_RGB
 
@@ -740,23 +761,18 @@ void OSystem::setPalette(const uInt32* palette)
         uint8_t b = (p & 0x000000ff) >> 0;
         uint32_t c = (r >> 0) + (g << 8) + (b << 16);
 
-        myPalette[i] = c;
+        colors[i] = c;
     }
 
     #else
 
-        memcpy(myPalette, palette, 256*sizeof(uInt32));
+        memcpy(colors, palette, 256*sizeof(uInt32));
 
     #endif
-}
 
-void OSystem::freePalette()
-{
-    if (NULL != myPalette)
-    {
-        delete [] myPalette;
-        myPalette = NULL;
-    }
+    // The instances showing the same palette share it
+    myPalette = SharedContext::instance().palette(colors);
+    ++myPaletteVersion;
 }
 
 void OSystem::enablePhosphor(bool enable, int blend)
@@ -771,21 +787,89 @@ void OSystem::setSound(uInt16 addr, uInt8 value, Int32 cycle)
 
 void OSystem::processInputs()
 {
-    if (resetTriggered) {
-        resetTriggered = false;
-        myEventHandler->handleEvent(Event::ConsoleReset, 1);
-        resetReleased = true;
-    } else if (resetReleased) {
-        resetReleased = false;
-        myEventHandler->handleEvent(Event::ConsoleReset, 0);
-    } else if (selectTriggered) {
-        selectTriggered = false;
-        myEventHandler->handleEvent(Event::ConsoleSelect, 1);
-        selectReleased = true;
-    } else if (selectReleased) {
-        selectReleased = false;
-        myEventHandler->handleEvent(Event::ConsoleSelect, 0);
+    // Switches pressed by a command in the last frame are let go now
+    for (Event::Type event : inputPulses)
+        myEventHandler->handleEvent(event, 0);
+    inputPulses.clear();
+
+    // Movies and netplay take the input of whole frames, so everything
+    // queued goes in before the frame
+    if (myStateManager->takesFrameInput())
+    {
+        InputQueue::Entry entry;
+        while (inputQueue.peek(entry))
+        {
+            inputQueue.pop();
+            applyInput(entry);
+        }
+        inputBase = 0;
+    }
+}
+
+bool OSystem::queueInput(Event::Type event, int state, bool pulse)
+{
+    InputQueue::Entry entry = { event, state != 0 ? 1 : 0, getTicks(), pulse };
+    return inputQueue.push(entry);
+}
+
+void OSystem::applyInput(const InputQueue::Entry& entry)
+{
+    myEventHandler->handleEvent(entry.event, entry.state);
+    if (entry.pulse)
+        inputPulses.push_back(entry.event);
+
+    inputApplied++;
+}
+
+void OSystem::emulateFrame()
+{
+    TIA& tia = myConsole->tia();
+    bool finished = false;
+
+    // The first event waiting goes in at the start of the frame, and the
+    // ones after it at their distance in time from it, so input comes as
+    // early as before and several events within a frame all count.
+    // Events more than a frame away wait for the next one.
+    InputQueue::Entry entry;
+    if (!myStateManager->takesFrameInput() && inputQueue.peek(entry))
+    {
+        double frameMicros = 1000000.0 / myConsole->getFramerate();
+        if (inputBase == 0)
+            inputBase = entry.time;
+
+        do
+        {
+            uInt32 cycle = entry.time > inputBase ?
+                uInt32(double(entry.time - inputBase) * frameCycles / frameMicros) : 0;
+            if (cycle >= frameCycles)
+                break;
+
+            if (cycle > 0)
+            {
+                if (tia.updateToCycle(cycle))
+                {
+                    finished = true;
+                    break;
+                }
+                inputMidFrame++;
+            }
+
+            inputQueue.pop();
+            applyInput(entry);
+
+            // Latch the new state of the controllers and switches
+            myConsole->riot().update();
+        }
+        while (inputQueue.peek(entry));
+
+        inputBase = inputQueue.size() > 0 ? inputBase + uInt64(frameMicros) : 0;
     }
+
+    if (!finished)
+        tia.update();
+
+    if (myConsole->system().cycles() > 0)
+        frameCycles = myConsole->system().cycles();
 }
 
 int OSystem::updateInput(int joystickInput, int flags)
@@ -844,7 +928,7 @@ int OSystem::updateInput(int joystickInput, int flags)
 int OSystem::updateAudio(void* buffer, int bufferSize, int flags)
 {
     EventHandler::State state = eventHandler().state();
-    if (EventHandler::S_EMULATE != state)
+    if (EventHandler::S_EMULATE != state || myStateManager->isHalted())
     {
         return 0;
     }
@@ -864,14 +948,45 @@ int OSystem::updateVideo(emu_update_info_t* updateInfo, int flags)
 
     TIA& tia = console().tia();
 
-    tia.update();
+    // While rewinding, the frame of the current state has been emulated
+    // already; netplay may have to wait for the peer
+    if (!myStateManager->isHalted())
+    {
+        uInt64 startTicks = getTicks();
+
+        emulateFrame();
+
+        uInt64 endTicks = getTicks();
+        frameTicks += endTicks - startTicks;
+        frameCount++;
+
+        if (runAheadFrames > 0)
+        {
+            runAhead();
+            runAheadTicks += getTicks() - endTicks;
+        }
+    }
 
     if (eventHandler().frying())
     {
         console().fry();
     }
 
-    if (NULL != updateInfo)
+    if (NULL != updateInfo && (flags & EMU_VIDEO_FLAG_COLORS) != 0)
+    {
+        if (!framePipeline)
+        {
+            framePipeline = make_ptr<FramePipeline>();
+            framePipeline->setThreaded(mySettings->getBool("pipeline"));
+        }
+
+        // Post-processed on a thread of its own, the frame shown is the
+        // one before; there is none for the very first frame
+        framePipeline->push(tia, myPalette);
+        if (!framePipeline->latest(*updateInfo))
+            return 0;
+    }
+    else if (NULL != updateInfo)
     {
         updateInfo->video_buffer = tia.currentFrameBuffer();
         updateInfo->video_width = (int) tia.width();
@@ -883,6 +998,121 @@ int OSystem::updateVideo(emu_update_info_t* updateInfo, int flags)
     return 1; // 1 := updated
 }
 
+void OSystem::runAhead()
+{
+    // Emulate the frames the current input will lead to, and show the last
+    // of them; then go back, as if they had never happened.  This hides
+    // as many frames of the game's own input lag.
+    runAheadState.reset();
+    if (!myConsole->save(runAheadState))
+    {
+        return;
+    }
+
+    // The EEPROM of a SaveKey/AtariVox is not part of the console state,
+    // so it is taken back separately
+    MT24LC256* eeproms[2] = {
+        myConsole->leftController().eeprom(),
+        myConsole->rightController().eeprom()
+    };
+    for (MT24LC256* eeprom : eeproms)
+        if (eeprom) eeprom->checkpoint();
+
+    mySound->suppressWrites(true);
+    for (int i = 0; i < runAheadFrames; i++)
+    {
+        myConsole->riot().update();
+        myConsole->tia().update();
+    }
+    mySound->suppressWrites(false);
+
+    runAheadState.reset();
+    myConsole->load(runAheadState);
+
+    for (MT24LC256* eeprom : eeproms)
+        if (eeprom) eeprom->rollback();
+}
+
+std::string OSystem::memoryInfo()
+{
+    // The parts of the console in the arena, and the larger ones beside it
+    if (!myConsole) return "";
+
+    ostringstream buf;
+    if (myConsole->arena())
+        buf << myConsole->arena()->info() << " ";
+    else
+        buf << "arena=0 ";
+
+    int imageSize = 0;
+    myConsole->cartridge().getImage(imageSize);
+    buf << "cart=" << imageSize
+        << " pipeline=" << (framePipeline ? framePipeline->size() : 0);
+
+    return buf.str();
+}
+
+std::string OSystem::benchmarkClone()
+{
+    // Compares branching off the current state by cloning the console
+    // with the save/load round trip into an arena (as used for rewinding
+    // and running ahead)
+    if (!myConsole) return "";
+
+    const int numClones = 200;
+    const int numRoundTrips = 20000;
+
+    ostringstream buf;
+    Serializer state;
+
+    // Check that a clone emulates the same next frame as the console
+    // itself; the frame is emulated on the console and then taken back
+    unique_ptr<Console> clone = myConsole->clone();
+    if (!clone || !myConsole->save(state))
+    {
+        return "failed";
+    }
+
+    mySound->suppressWrites(true);
+    clone->tia().update();
+    myConsole->tia().update();
+    bool identical = 0 == memcmp(clone->tia().currentFrameBuffer(),
+                                 myConsole->tia().currentFrameBuffer(),
+                                 160 * myConsole->tia().height());
+    mySound->suppressWrites(false);
+
+    state.reset();
+    myConsole->load(state);
+    clone = nullptr;
+
+    uInt64 start = getTicks();
+    for (int i = 0; i < numClones; i++)
+    {
+        clone = myConsole->clone();
+    }
+    uInt64 cloneTicks = std::max<uInt64>(getTicks() - start, 1);
+    clone = nullptr;
+
+    start = getTicks();
+    for (int i = 0; i < numRoundTrips; i++)
+    {
+        state.reset();
+        myConsole->save(state);
+        state.reset();
+        myConsole->load(state);
+    }
+    uInt64 roundTripTicks = std::max<uInt64>(getTicks() - start, 1);
+
+    buf << "identical=" << (identical ? "yes" : "no")
+        << " stateBytes=" << state.size()
+        << " clonesPerSecond=" << uInt64(numClones * 1000000.0 / cloneTicks)
+        << " cloneMicros=" << double(cloneTicks) / numClones
+        << " roundTripsPerSecond=" << uInt64(numRoundTrips * 1000000.0 / roundTripTicks)
+        << " roundTripMicros=" << double(roundTripTicks) / numRoundTrips;
+
+    return buf.str();
+}
+
 shared_ptr<FBSurface> OSystem::allocateSurface(int w, int h, const uInt32* data)
 {
     shared_ptr<FBSurface> surface = make_ptr<FBSurface>();
@@ -907,13 +1137,96 @@ std::string OSystem::getAttribute(const std::string& key)
         const ConsoleInfo& info = myConsole->about();
         value = info.CartName;
     }
+    else if (0 == key.compare("audio.capture"))
+    {
+        const AudioCapture& capture = static_cast<SoundBuffer&>(*mySound).capture();
+        ostringstream buf;
+        buf << (capture.isActive() ? "active" : "inactive")
+            << " bytes=" << capture.getBytesCaptured()
+            << " dropped=" << capture.getBytesDropped();
+        value = buf.str();
+    }
+    else if (0 == key.compare("rewind.info"))
+    {
+        value = myStateManager->rewindManager().stats();
+    }
+    else if (0 == key.compare("movie.info"))
+    {
+        value = myStateManager->movieInfo();
+    }
+    else if (0 == key.compare("netplay.info"))
+    {
+        value = myStateManager->netplayManager().stats();
+    }
+    else if (0 == key.compare("clone.benchmark"))
+    {
+        value = benchmarkClone();
+    }
+    else if (0 == key.compare("pipeline.info"))
+    {
+        if (framePipeline)
+            value = framePipeline->info();
+    }
+    else if (0 == key.compare("runahead.info"))
+    {
+        ostringstream buf;
+        buf << "frames=" << runAheadFrames
+            << " frameMicros="
+            << (frameCount > 0 ? double(frameTicks) / frameCount : 0.0)
+            << " runAheadMicros="
+            << (frameCount > 0 ? double(runAheadTicks) / frameCount : 0.0);
+        value = buf.str();
+    }
+    else if (0 == key.compare("input.info"))
+    {
+        ostringstream buf;
+        buf << "queued=" << inputQueue.size()
+            << " applied=" << inputApplied
+            << " midFrame=" << inputMidFrame
+            << " dropped=" << inputQueue.dropped()
+            << " frameCycles=" << frameCycles;
+        value = buf.str();
+    }
+    else if (0 == key.compare("memory.info"))
+    {
+        value = memoryInfo();
+    }
+    else if (0 == key.compare("shared.info"))
+    {
+        value = SharedContext::instance().info();
+    }
 
     return value;
 }
 
-void OSystem::input(int keyCode, int state)
+bool OSystem::input(int keyCode, int state)
 {
-    ;
+    switch (keyCode)
+    {
+        case VKEY_CONSOLE_RESET:
+            return queueInput(Event::ConsoleReset, state, false);
+        case VKEY_CONSOLE_SELECT:
+            return queueInput(Event::ConsoleSelect, state, false);
+        default:
+            break;
+    }
+
+    bool one = (keyCode & VKEY_JOYSTICK_ONE) != 0;
+    switch (keyCode & ~VKEY_JOYSTICK_ONE)
+    {
+        case VKEY_JOYSTICK_FIRE:
+            return queueInput(one ? Event::JoystickOneFire : Event::JoystickZeroFire, state, false);
+        case VKEY_JOYSTICK_LEFT:
+            return queueInput(one ? Event::JoystickOneLeft : Event::JoystickZeroLeft, state, false);
+        case VKEY_JOYSTICK_RIGHT:
+            return queueInput(one ? Event::JoystickOneRight : Event::JoystickZeroRight, state, false);
+        case VKEY_JOYSTICK_UP:
+            return queueInput(one ? Event::JoystickOneUp : Event::JoystickZeroUp, state, false);
+        case VKEY_JOYSTICK_DOWN:
+            return queueInput(one ? Event::JoystickOneDown : Event::JoystickZeroDown, state, false);
+        default:
+            return false;
+    }
 }
 
 int OSystem::execCommand(int command, int param)
@@ -921,12 +1234,47 @@ int OSystem::execCommand(int command, int param)
     switch (command)
     {
         case 3: // COMMAND_RESET
-            resetReleased = false;
-            resetTriggered = true;
-            break;
+            return queueInput(Event::ConsoleReset, 1, true) ? 1 : 0;
         case 8: // COMMAND_SELECT
-            selectReleased = false;
-            selectTriggered = true;
+            return queueInput(Event::ConsoleSelect, 1, true) ? 1 : 0;
+        case 9: // COMMAND_AUDIO_CAPTURE_START (param: 0 = wav, 1 = raw)
+            return mySound->startCapture(mySettings->getString("capturefile"),
+                                         param == 1) ? 1 : 0;
+        case 10: // COMMAND_AUDIO_CAPTURE_STOP
+            mySound->stopCapture();
+            break;
+        case 11: // COMMAND_AUDIO_FORMAT (param: see EMU_AUDIO_FORMAT)
+            return mySound->setFormat(param & EMU_AUDIO_FORMAT_RATE_MASK,
+                                      (param >> EMU_AUDIO_FORMAT_CHANNELS_SHIFT) & 0xf,
+                                      (param & EMU_AUDIO_FORMAT_FLOAT) ? 32 : 16) ? 1 : 0;
+        case 12: // COMMAND_REWIND_STEP
+            return myStateManager->rewindState() ? 1 : 0;
+        case 13: // COMMAND_REWIND_RESUME
+            if (myStateManager->isRewinding())
+                myStateManager->toggleRewindMode();
+            break;
+        case 14: // COMMAND_RUNAHEAD (param: number of frames, 0 = off)
+            if (param < 0 || param > 4)
+                return 0;
+            runAheadFrames = param;
+            mySettings->setValue("runahead", param);
+            frameTicks = runAheadTicks = frameCount = 0;
+            break;
+        case 15: // COMMAND_MOVIE_RECORD (toggle)
+            return myStateManager->toggleRecordMode() ? 1 : 0;
+        case 16: // COMMAND_MOVIE_PLAY (param: 0 = real time, 1 = replay unthrottled)
+            if (param == 1)
+                return myStateManager->replayMovie();
+            return myStateManager->startPlayback() ? 1 : 0;
+        case 17: // COMMAND_NETPLAY_START (param: 0 = host, 1 = guest)
+            return myStateManager->startNetplay(param) ? 1 : 0;
+        case 18: // COMMAND_NETPLAY_STOP
+            myStateManager->stopNetplay();
+            break;
+        case 19: // COMMAND_PIPELINE (param: 1 = post-process frames on a second thread)
+            mySettings->setValue("pipeline", param != 0);
+            if (framePipeline)
+                framePipeline->setThreaded(param != 0);
             break;
         default: {
             return 0;
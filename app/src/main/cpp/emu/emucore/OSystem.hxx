@@ -23,7 +23,9 @@
 ////class CheatManager;
 ////class CommandMenu;
 class Console;
+class ConsoleArena;
 ////class Debugger;
+class FramePipeline;
 ////class Launcher;
 ////class Menu;
 class Properties;
@@ -43,6 +45,8 @@ class StateManager;
 ////#include "PNGLibrary.hxx"
 #include "bspf.hxx"
 #include "EventHandler.hxx"
+#include "InputQueue.hxx"
+#include "Serializer.hxx"
 
 struct TimingInfo {
     uInt64 start;
@@ -117,6 +121,13 @@ class OSystem
     */
     PropertiesSet& propSet() const { return *myPropSet; }
 
+    /**
+      Get the memory the subsystems of the console are created in.
+
+      @return The arena
+    */
+    ConsoleArena& consoleArena() const { return *myConsoleArena; }
+
     /**
       Get the console of the system.  The console won't always exist,
       so we should test if it's available.
@@ -447,6 +458,10 @@ class OSystem
     // Pointer to the PropertiesSet object
     unique_ptr<PropertiesSet> myPropSet;
 
+    // The memory the console's subsystems are created in, reused by
+    // every console loaded (it must outlive the console)
+    unique_ptr<ConsoleArena> myConsoleArena;
+
     // Pointer to the (currently defined) Console object
     unique_ptr<Console> myConsole;
 
@@ -545,18 +560,17 @@ class OSystem
     void closeConsole();
 
     /**
-      Open the given ROM and return an array containing its contents.
+      Open the given ROM and return its image, shared rather than copied.
       Also, the properties database is updated with a valid ROM name
       for this ROM (if necessary).
 
       @param rom    The file node of the ROM to open (contains path)
       @param md5    The md5 calculated from the ROM file
                     (will be recalculated if necessary)
-      @param size   The amount of data read into the image array
 
-      @return  Unique pointer to the array
+      @return  The image of the ROM (empty if there is none)
     */
-    const uInt8* openROM(const Rom& rom, string& md5, uInt32& size);
+    RomImage openROM(const Rom& rom, string& md5);
 
     /**
       Gets all possible info about the given console.
@@ -597,26 +611,55 @@ class OSystem
         //int update(int joystickInput, emu_update_info_t* updateInfo, int flags=0x0);
         void showMessage(const std::string& message, int positionInfo = 0, bool force = false);
         void setPalette(const uInt32* palette);
+        uInt32 paletteVersion() const { return myPaletteVersion; }
+        void setHeadless(bool headless) { myHeadless = headless; }
+        bool headless() const { return myHeadless; }
         void enablePhosphor(bool enable, int blend);
         shared_ptr<FBSurface> allocateSurface(int w, int h, const uInt32* data = NULL);
         uint32_t mapRGB(uint8_t r, uint8_t g, uint8_t b) const;
         void setSound(uInt16 addr, uInt8 value, Int32 cycle);
         std::string getAttribute(const std::string& key);
         int execCommand(int command, int param);
-        void input(int keyCode, int state);
+        bool input(int keyCode, int state);
 
     private:
         int lastJoystickInput;
         Int32 lastSoundCycle;
-        uInt32* myPalette;
-
-        bool resetTriggered;
-        bool resetReleased;
-        bool selectTriggered;
-        bool selectReleased;
+        const uInt32* myPalette;
+        uInt32 myPaletteVersion; // counts setPalette() calls
+        bool myHeadless; // no frontend of its own (batch, sweep, pool)
+
+        // Input events pushed by the user interface at any time, applied
+        // at the cycle of the frame matching when they happened; switches
+        // pressed by a command are released with the next frame
+        InputQueue inputQueue;
+        vector<Event::Type> inputPulses;
+        uInt64 inputBase;
+        uInt32 frameCycles;
+        uInt32 inputApplied;
+        uInt32 inputMidFrame;
+
+        // Number of frames to run ahead of the emulated state, and the
+        // state to return to afterwards
+        int runAheadFrames;
+        Serializer runAheadState;
+
+        // Time spent emulating frames and running ahead, in microseconds
+        uInt64 frameTicks;
+        uInt64 runAheadTicks;
+        uInt64 frameCount;
+
+        // Turns the frames into colours for callers asking for them;
+        // created on the first such request
+        unique_ptr<FramePipeline> framePipeline;
 
-        void freePalette();
         void processInputs();
+        bool queueInput(Event::Type event, int state, bool pulse);
+        void applyInput(const InputQueue::Entry& entry);
+        void emulateFrame();
+        void runAhead();
+        std::string benchmarkClone();
+        std::string memoryInfo();
 };
 
 #endif
@@ -278,7 +278,7 @@ void Paddles::update()
       // We're in auto mode, where a single axis is used for one paddle only
         myCharge[myMPaddleID] = BSPF::clamp(myCharge[myMPaddleID] -
             (myEvent.get(myAxisMouseMotion) * MOUSE_SENSITIVITY),
-            TRIGMIN, TRIGRANGE);
+            TRIGMIN, TRIGRANGE.load());
         if (myEvent.get(Event::MouseButtonLeftValue) ||
             myEvent.get(Event::MouseButtonRightValue))
             myDigitalPinState[ourButtonPin[myMPaddleID]] = false;
@@ -291,7 +291,7 @@ void Paddles::update()
         {
             myCharge[myMPaddleIDX] = BSPF::clamp(myCharge[myMPaddleIDX] -
                 (myEvent.get(Event::MouseAxisXValue) * MOUSE_SENSITIVITY),
-                TRIGMIN, TRIGRANGE);
+                TRIGMIN, TRIGRANGE.load());
             if (myEvent.get(Event::MouseButtonLeftValue))
                 myDigitalPinState[ourButtonPin[myMPaddleIDX]] = false;
         }
@@ -299,7 +299,7 @@ void Paddles::update()
         {
             myCharge[myMPaddleIDY] = BSPF::clamp(myCharge[myMPaddleIDY] -
                 (myEvent.get(Event::MouseAxisYValue) * MOUSE_SENSITIVITY),
-                TRIGMIN, TRIGRANGE);
+                TRIGMIN, TRIGRANGE.load());
             if (myEvent.get(Event::MouseButtonRightValue))
                 myDigitalPinState[ourButtonPin[myMPaddleIDY]] = false;
         }
@@ -415,10 +415,10 @@ void Paddles::setPaddleRange(int range)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-int Paddles::TRIGRANGE = Paddles::TRIGMAX;
-int Paddles::DIGITAL_SENSITIVITY = -1;
-int Paddles::DIGITAL_DISTANCE = -1;
-int Paddles::MOUSE_SENSITIVITY = -1;
+std::atomic<int> Paddles::TRIGRANGE(Paddles::TRIGMAX);
+std::atomic<int> Paddles::DIGITAL_SENSITIVITY(-1);
+std::atomic<int> Paddles::DIGITAL_DISTANCE(-1);
+std::atomic<int> Paddles::MOUSE_SENSITIVITY(-1);
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const Controller::DigitalPin Paddles::ourButtonPin[2] = { Four, Three };
@@ -20,6 +20,8 @@
 #ifndef PADDLES_HXX
 #define PADDLES_HXX
 
+#include <atomic>
+
 #include "bspf.hxx"
 #include "Control.hxx"
 #include "Event.hxx"
@@ -130,12 +132,14 @@ class Paddles : public Controller
     // to paddle resistance
     static const int TRIGMIN = 1;
     static const int TRIGMAX = 4096;
-    static int TRIGRANGE;  // This one is variable for the upper range
+    static std::atomic<int> TRIGRANGE;  // This one is variable for the upper range
 
+    // The sensitivities are shared by all consoles, which may be created
+    // on different threads
     static const int MAX_DIGITAL_SENSE = 20;
     static const int MAX_MOUSE_SENSE = 20;
-    static int DIGITAL_SENSITIVITY, DIGITAL_DISTANCE;
-    static int MOUSE_SENSITIVITY;
+    static std::atomic<int> DIGITAL_SENSITIVITY, DIGITAL_DISTANCE;
+    static std::atomic<int> MOUSE_SENSITIVITY;
 
     // Lookup table for associating paddle buttons with controller pins
     // Yes, this is hideously complex
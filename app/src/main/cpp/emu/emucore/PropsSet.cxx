@@ -26,9 +26,60 @@
 
 #include "DefProps.hxx"
 #include "Props.hxx"
+#include "SharedContext.hxx"
 
 #include "PropsSet.hxx"
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Answers the built-in entry of the ROM with the given MD5 (in hex), or
+// the null pointer if there is none
+static const DefPropsEntry* findDefProps(const string& md5)
+{
+    if (md5.size() != 32)
+        return nullptr;
+
+    uInt8 key[16];
+    for (int i = 0; i < 32; ++i)
+    {
+        char c = md5[i];
+        int nibble = (c >= '0' && c <= '9') ? c - '0' :
+                     (c >= 'a' && c <= 'f') ? c - 'a' + 10 :
+                     (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+        if (nibble < 0)
+            return nullptr;
+
+        key[i >> 1] = (i & 1) ? (key[i >> 1] | nibble) : uInt8(nibble << 4);
+    }
+
+    // See DefProps.hxx for the perfect hash
+    uInt32 h0 = key[0] | (key[1] << 8) | (key[2] << 16) | (uInt32(key[3]) << 24);
+    uInt32 h1 = key[4] | (key[5] << 8) | (key[6] << 16) | (uInt32(key[7]) << 24);
+    uInt32 slot = (h1 ^ (DefPropsDisplace[h0 % DEF_PROPS_BUCKETS] * 0x9E3779B1u)) %
+        DEF_PROPS_SIZE;
+
+    const DefPropsEntry& entry = DefProps[slot];
+    return memcmp(entry.md5, key, sizeof(key)) == 0 ? &entry : nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Sets the properties of a built-in entry
+static void setDefProps(const DefPropsEntry& entry, Properties& properties)
+{
+    static const char* hex = "0123456789abcdef";
+    char md5[33];
+    for (int i = 0; i < 16; ++i)
+    {
+        md5[i * 2] = hex[entry.md5[i] >> 4];
+        md5[i * 2 + 1] = hex[entry.md5[i] & 0x0f];
+    }
+    md5[32] = 0;
+    properties.set(Cartridge_MD5, md5);
+
+    for (uInt32 f = entry.fields; f < (&entry + 1)->fields; ++f)
+        properties.set(PropertyType(DefPropsFields[f] >> 24),
+                       DefPropsPool + (DefPropsFields[f] & 0xffffff));
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 PropertiesSet::PropertiesSet(const string& propsfile)
 {
@@ -38,11 +89,20 @@ PropertiesSet::PropertiesSet(const string& propsfile)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PropertiesSet::load(const string& filename)
 {
+  // Every file is only read once per process
+    myExternalProps = SharedContext::instance().properties(filename);
+    if (myExternalProps)
+        return;
+
+    myExternalProps = make_shared<PropsList>();
+
     ifstream in(filename);
 
     Properties prop;
     while (in >> prop)
         insert(prop);
+
+    SharedContext::instance().setProperties(filename, myExternalProps);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -53,9 +113,12 @@ bool PropertiesSet::save(const string& filename) const
         return false;
 
       // Only save those entries in the external list
-    for (const auto& i : myExternalProps)
+    for (const auto& i : *myExternalProps)
         out << i.second;
 
+    // Instances reading the file from now on get what was saved
+    SharedContext::instance().setProperties(filename, myExternalProps);
+
     return true;
 }
 
@@ -78,8 +141,8 @@ bool PropertiesSet::getMD5(const string& md5, Properties& properties,
     if (!useDefaults)
     {
       // Check external list
-        auto ext = myExternalProps.find(md5);
-        if (ext != myExternalProps.end())
+        auto ext = myExternalProps->find(md5);
+        if (ext != myExternalProps->end())
         {
             properties = ext->second;
             found = true;
@@ -95,28 +158,14 @@ bool PropertiesSet::getMD5(const string& md5, Properties& properties,
         }
     }
 
-    // Otherwise, search the internal database using binary search
+    // Otherwise, look the MD5 up in the internal database
     if (!found)
     {
-        int low = 0, high = DEF_PROPS_SIZE - 1;
-        while (low <= high)
+        const DefPropsEntry* entry = findDefProps(md5);
+        if (entry != nullptr)
         {
-            int i = (low + high) / 2;
-            int cmp = BSPF::compareIgnoreCase(md5, DefProps[i][Cartridge_MD5]);
-
-            if (cmp == 0)  // found it
-            {
-                for (int p = 0; p < LastPropType; ++p)
-                    if (DefProps[i][p][0] != 0)
-                        properties.set(PropertyType(p), DefProps[i][p]);
-
-                found = true;
-                break;
-            }
-            else if (cmp < 0)
-                high = i - 1; // look at lower range
-            else
-                low = i + 1;  // look at upper range
+            setDefProps(*entry, properties);
+            found = true;
         }
     }
 
@@ -160,12 +209,12 @@ void PropertiesSet::insert(const Properties& properties, bool save)
         return;
     else if (getMD5(md5, defaultProps, true) && defaultProps == properties)
     {
-        myExternalProps.erase(md5);
+        externalProps().erase(md5);
         return;
     }
 
     // The status of 'save' determines which list to save to
-    PropsList& list = save ? myExternalProps : myTempProps;
+    PropsList& list = save ? externalProps() : myTempProps;
 
     auto ret = list.emplace(md5, properties);
     if (ret.second == false)
@@ -180,7 +229,16 @@ void PropertiesSet::insert(const Properties& properties, bool save)
 void PropertiesSet::removeMD5(const string& md5)
 {
   // We only remove from the external list
-    myExternalProps.erase(md5);
+    externalProps().erase(md5);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PropertiesSet::PropsList& PropertiesSet::externalProps()
+{
+    if (!myExternalProps.unique())
+        myExternalProps = make_shared<PropsList>(*myExternalProps);
+
+    return *myExternalProps;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -194,7 +252,7 @@ void PropertiesSet::print() const
   // This isn't fast, but I suspect this method isn't used too often (or at all)
 
   // First insert all external props
-    PropsList list = myExternalProps;
+    PropsList list = *myExternalProps;
 
     // Now insert all the built-in ones
     // Note that if we try to insert a duplicate, the insertion will fail
@@ -204,11 +262,9 @@ void PropertiesSet::print() const
     for (int i = 0; i < DEF_PROPS_SIZE; ++i)
     {
         properties.setDefaults();
-        for (int p = 0; p < LastPropType; ++p)
-            if (DefProps[i][p][0] != 0)
-                properties.set(PropertyType(p), DefProps[i][p]);
+        setDefProps(DefProps[i], properties);
 
-        list.insert(make_pair(DefProps[i][Cartridge_MD5], properties));
+        list.insert(make_pair(properties.get(Cartridge_MD5), properties));
     }
 
     // Now, print the resulting list
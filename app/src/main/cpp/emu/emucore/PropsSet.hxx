@@ -41,6 +41,9 @@ class OSystem;
 */
 class PropertiesSet
 {
+    public:
+    using PropsList = std::map<string, Properties>;
+
     public:
       /**
         Create a properties set object from the specified properties file.
@@ -118,10 +121,14 @@ class PropertiesSet
     void print() const;
 
     private:
-    using PropsList = std::map<string, Properties>;
+      // Get the external properties for changing them, copying them
+      // first while they are shared
+    PropsList& externalProps();
 
-    // The properties read from an external 'stella.pro' file
-    PropsList myExternalProps;
+    private:
+    // The properties read from an external 'stella.pro' file; shared
+    // with the other instances using the same file (see SharedContext)
+    shared_ptr<PropsList> myExternalProps;
 
     // The properties temporarily inserted by the program, which should
     // be discarded when the program ends
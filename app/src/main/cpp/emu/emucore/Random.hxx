@@ -24,22 +24,27 @@
 
 #include "bspf.hxx"
 #include "OSystem.hxx"
+#include "Serializable.hxx"
 
 /**
   This is a quick-and-dirty random number generator.  It is based on
   information in Chapter 7 of "Numerical Recipes in C".  It's a simple
   linear congruential generator.
 
+  Normally the generator is seeded from the system clock.  Once a fixed
+  seed is set, every (re)seed uses that instead, so that emulation is
+  fully reproducible.  The generator is part of the emulation state.
+
   @author  Bradford W. Mott
   @version $Id: Random.hxx 3239 2015-12-29 19:22:46Z stephena $
 */
-class Random
+class Random : public Serializable
 {
     public:
       /**
         Create a new random number generator
       */
-    Random(const OSystem& osystem) : myOSystem(osystem) { initSeed(); }
+    Random(const OSystem& osystem) : myOSystem(osystem), mySeed(0) { initSeed(); }
 
     /**
       Re-initialize the random number generator with a new seed,
@@ -47,9 +52,26 @@ class Random
     */
     void initSeed()
     {
-        myValue = uInt32(myOSystem.getTicks());
+        myValue = mySeed != 0 ? mySeed : uInt32(myOSystem.getTicks());
+    }
+
+    /**
+      Use a fixed seed for all following re-initializations, and
+      re-initialize with it.
+
+      @param seed  The seed to use, or 0 to seed from the system clock
+    */
+    void setSeed(uInt32 seed)
+    {
+        mySeed = seed;
+        initSeed();
     }
 
+    /**
+      Answer the fixed seed (0 if seeded from the system clock)
+    */
+    uInt32 seed() const { return mySeed; }
+
     /**
       Answer the next random number from the random number generator
 
@@ -60,10 +82,64 @@ class Random
         return (myValue = (myValue * 2416 + 374441) % 1771875);
     }
 
+    /**
+      Saves the current state of this generator to the given Serializer.
+
+      @param out  The serializer device to save to.
+      @return  The result of the save.  True on success, false on failure.
+    */
+    bool save(Serializer& out) const override
+    {
+        try
+        {
+            out.putString(name());
+            out.putInt(myValue);
+        }
+        catch (...)
+        {
+            cerr << "ERROR: Random::save" << endl;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+      Loads the current state of this generator from the given Serializer.
+
+      @param in  The Serializer device to load from.
+      @return  The result of the load.  True on success, false on failure.
+    */
+    bool load(Serializer& in) override
+    {
+        try
+        {
+            if (in.getString() != name())
+                return false;
+
+            myValue = in.getInt();
+        }
+        catch (...)
+        {
+            cerr << "ERROR: Random::load" << endl;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+      Get a descriptor for the device name (used in error checking).
+
+      @return The name of the object
+    */
+    string name() const override { return "Random"; }
+
     private:
       // Set the OSystem we're using
     const OSystem& myOSystem;
 
+    // Fixed seed, or 0 to seed from the system clock
+    uInt32 mySeed;
+
     // Indicates the next random number
     uInt32 myValue;
 
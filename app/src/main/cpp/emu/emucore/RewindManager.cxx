@@ -0,0 +1,338 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "OSystem.hxx"
+#include "Settings.hxx"
+#include "Console.hxx"
+
+#include "RewindManager.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RewindManager::RewindManager(OSystem& osystem)
+    : myOSystem(osystem),
+    myCapacity(0),
+    myHead(0),
+    myUsed(0),
+    myKeyframeSize(0),
+    myDeltaCount(0),
+    myInterval(1),
+    myFrameCount(0),
+    myBufferSize(0),
+    myTotalSnapshots(0),
+    myTotalTicks(0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::setup()
+{
+    uInt32 capacity = uInt32(myOSystem.settings().getInt("rewindbuffer")) * 1024;
+    if (capacity != myCapacity)
+    {
+        myRing = capacity > 0 ? make_ptr<uInt8[]>(capacity) : nullptr;
+        myCapacity = capacity;
+    }
+    myInterval = uInt32(myOSystem.settings().getInt("rewindinterval"));
+
+    myTotalSnapshots = myTotalTicks = 0;
+    clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::clear()
+{
+    myEntries.clear();
+    myHead = myUsed = 0;
+    myDeltaCount = 0;
+    myFrameCount = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::addState()
+{
+    if (!enabled() || !myOSystem.hasConsole() || ++myFrameCount < myInterval)
+        return false;
+
+    myFrameCount = 0;
+
+    uInt64 startTicks = myOSystem.getTicks();
+
+    myState.reset();
+    if (!myOSystem.console().save(myState))
+        return false;
+
+    const uInt8* state = myState.data();
+    uInt32 stateSize = myState.size();
+
+    if (maxPackedSize(stateSize) > myCapacity)
+        return false;
+
+    uInt32 offset = allocate(maxPackedSize(stateSize));
+
+    // Start a new group when the current one is full, or its keyframe
+    // has just been dropped to make room
+    bool keyframe = myEntries.empty() || stateSize != myKeyframeSize ||
+        myDeltaCount + 1 >= kKeyframeInterval;
+
+    uInt32 size;
+    if (keyframe)
+    {
+        if (stateSize != myKeyframeSize)
+        {
+            myKeyframe = make_ptr<uInt8[]>(stateSize);
+            myKeyframeSize = stateSize;
+        }
+        memcpy(myKeyframe.get(), state, stateSize);
+        myDeltaCount = 0;
+
+        size = pack(state, stateSize, myRing.get() + offset);
+    }
+    else
+    {
+        if (stateSize > myBufferSize)
+        {
+            myBuffer = make_ptr<uInt8[]>(stateSize);
+            myBufferSize = stateSize;
+        }
+        uInt8* delta = myBuffer.get();
+        const uInt8* ref = myKeyframe.get();
+        for (uInt32 i = 0; i < stateSize; ++i)
+            delta[i] = state[i] ^ ref[i];
+        ++myDeltaCount;
+
+        size = pack(delta, stateSize, myRing.get() + offset);
+    }
+
+    Entry entry;
+    entry.offset = offset;
+    entry.size = size;
+    entry.stateSize = stateSize;
+    entry.keyframe = keyframe;
+    myEntries.push_back(entry);
+
+    myHead = offset + size;
+    myUsed += size;
+
+    myTotalTicks += myOSystem.getTicks() - startTicks;
+    ++myTotalSnapshots;
+
+    return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::rewindState()
+{
+    if (myEntries.size() < 2 || !myOSystem.hasConsole())
+        return false;
+
+    // The newest snapshot is the current state, so drop it and reuse
+    // its space for the snapshots taken after resuming
+    const Entry newest = myEntries.back();
+    myEntries.pop_back();
+    myHead = newest.offset;
+    myUsed -= newest.size;
+
+    if (newest.keyframe)
+    {
+        if (!restoreKeyframe())
+        {
+            clear();
+            return false;
+        }
+    }
+    else
+        --myDeltaCount;
+
+    const Entry& entry = myEntries.back();
+    const uInt8* packed = myRing.get() + entry.offset;
+
+    if (entry.keyframe)
+        myState.setData(myKeyframe.get(), myKeyframeSize);
+    else
+    {
+        uInt8* state = myBuffer.get();
+        const uInt8* ref = myKeyframe.get();
+        if (!unpack(packed, entry.size, state, entry.stateSize))
+        {
+            clear();
+            return false;
+        }
+        for (uInt32 i = 0; i < entry.stateSize; ++i)
+            state[i] ^= ref[i];
+
+        myState.setData(state, entry.stateSize);
+    }
+
+    myFrameCount = 0;
+
+    return myOSystem.console().load(myState);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string RewindManager::stats() const
+{
+    uInt32 frames = size() * myInterval;
+    float framerate = myOSystem.hasConsole() ?
+        myOSystem.console().getFramerate() : 60.0f;
+
+    ostringstream buf;
+    buf << "snapshots=" << size()
+        << " frames=" << frames
+        << " bytes=" << myUsed
+        << " capacity=" << myCapacity
+        << " bytesPerMinute="
+        << (frames > 0 ? uInt64(double(myUsed) / frames * framerate * 60) : 0)
+        << " saveMicros="
+        << (myTotalSnapshots > 0 ? double(myTotalTicks) / myTotalSnapshots : 0.0);
+
+    return buf.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 RewindManager::allocate(uInt32 size)
+{
+    if (myHead + size > myCapacity)
+    {
+      // Wrap around; whatever is left behind the head is the oldest data,
+      // and would be overwritten out of order otherwise
+        while (!myEntries.empty() && myEntries.front().offset >= myHead)
+            dropOldest();
+
+        myHead = 0;
+    }
+
+    while (!myEntries.empty() &&
+        myEntries.front().offset < myHead + size &&
+        myEntries.front().offset + myEntries.front().size > myHead)
+        dropOldest();
+
+    return myHead;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::dropOldest()
+{
+    do
+    {
+        myUsed -= myEntries.front().size;
+        myEntries.pop_front();
+    }
+    while (!myEntries.empty() && !myEntries.front().keyframe);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::restoreKeyframe()
+{
+    // Find the keyframe, counting the deltas stored after it
+    uInt32 deltas = 0;
+    auto it = myEntries.rbegin();
+    while (it != myEntries.rend() && !it->keyframe)
+    {
+        ++deltas;
+        ++it;
+    }
+    if (it == myEntries.rend())
+        return false;
+
+    if (it->stateSize != myKeyframeSize)
+    {
+        myKeyframe = make_ptr<uInt8[]>(it->stateSize);
+        myKeyframeSize = it->stateSize;
+    }
+    if (!unpack(myRing.get() + it->offset, it->size,
+        myKeyframe.get(), myKeyframeSize))
+        return false;
+
+    myDeltaCount = deltas;
+
+    return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 RewindManager::pack(const uInt8* src, uInt32 size, uInt8* dest)
+{
+  // Control byte 0x00 - 0x7f: the next 1 - 128 bytes are literals
+  //              0x80 - 0xff: repeat the next byte 2 - 129 times
+    uInt8* out = dest;
+    uInt32 i = 0;
+
+    while (i < size)
+    {
+        uInt8 value = src[i];
+        uInt32 run = 1;
+        while (i + run < size && run < 129 && src[i + run] == value)
+            ++run;
+
+        if (run >= 2)
+        {
+            *out++ = uInt8(0x80 + run - 2);
+            *out++ = value;
+            i += run;
+        }
+        else
+        {
+          // Collect literals up to the next run which is worth packing
+            uInt8* control = out++;
+            uInt32 count = 0;
+            while (i < size && count < 128)
+            {
+                if (i + 2 < size && src[i + 1] == src[i] && src[i + 2] == src[i])
+                    break;
+                *out++ = src[i++];
+                ++count;
+            }
+            *control = uInt8(count - 1);
+        }
+    }
+
+    return uInt32(out - dest);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::unpack(const uInt8* src, uInt32 srcSize,
+                           uInt8* dest, uInt32 size)
+{
+    const uInt8* end = src + srcSize;
+    uInt32 pos = 0;
+
+    while (src < end)
+    {
+        uInt8 control = *src++;
+        uInt32 count;
+
+        if (control < 0x80)
+        {
+            count = control + 1;
+            if (count > size - pos || count > uInt32(end - src))
+                return false;
+
+            memcpy(dest + pos, src, count);
+            src += count;
+        }
+        else
+        {
+            count = control - 0x80 + 2;
+            if (count > size - pos || src == end)
+                return false;
+
+            memset(dest + pos, *src++, count);
+        }
+        pos += count;
+    }
+
+    return pos == size;
+}
@@ -0,0 +1,159 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef REWIND_MANAGER_HXX
+#define REWIND_MANAGER_HXX
+
+#include <deque>
+
+class OSystem;
+
+#include "Serializer.hxx"
+
+/**
+  This class keeps a history of console states, which can be stepped
+  back through one snapshot at a time.
+
+  A snapshot of the whole console is taken at the start of every frame
+  (or every 'rewindinterval' frames).  Every kKeyframeInterval snapshots
+  a keyframe is stored; all snapshots in between are stored as the XOR
+  of the state against that keyframe.  Since most of the state does not
+  change from frame to frame, the delta is mostly zeros, and both are
+  run-length packed.
+
+  The packed snapshots live in a single ring of 'rewindbuffer' KB which
+  is allocated once; when it is full, the oldest keyframe and the deltas
+  depending on it are dropped.
+*/
+class RewindManager
+{
+    public:
+    RewindManager(OSystem& osystem);
+
+    public:
+      /**
+        (Re)allocate the ring from the current settings and drop all
+        snapshots.
+      */
+    void setup();
+
+    /**
+      Answers whether rewinding is enabled (i.e. the ring is allocated).
+    */
+    bool enabled() const { return myCapacity > 0; }
+
+    /**
+      Called once per frame; snapshots the console every 'rewindinterval'
+      frames.
+
+      @return  True if a snapshot was added
+    */
+    bool addState();
+
+    /**
+      Drop the newest snapshot and restore the one before it.
+
+      @return  False if there is no older snapshot
+    */
+    bool rewindState();
+
+    /**
+      Drop all snapshots, keeping the ring allocated.
+    */
+    void clear();
+
+    /**
+      Answers the number of snapshots in the ring.
+    */
+    uInt32 size() const { return uInt32(myEntries.size()); }
+
+    /**
+      Answers a description of the memory used by the ring and the average
+      cost of taking a snapshot.
+    */
+    string stats() const;
+
+    private:
+    struct Entry {
+        uInt32 offset;    // position of the packed data in the ring
+        uInt32 size;      // size of the packed data
+        uInt32 stateSize; // size of the unpacked console state
+        bool keyframe;    // packed as is, or as XOR against the last keyframe
+    };
+
+    enum {
+        kKeyframeInterval = 60
+    };
+
+    // Reserve a contiguous area for a new entry, dropping old entries
+    uInt32 allocate(uInt32 size);
+
+    // Drop the oldest keyframe and all entries depending on it
+    void dropOldest();
+
+    // Unpack the keyframe of the group the newest entry belongs to
+    bool restoreKeyframe();
+
+    // Run-length pack/unpack 'size' bytes
+    static uInt32 pack(const uInt8* src, uInt32 size, uInt8* dest);
+    static bool unpack(const uInt8* src, uInt32 srcSize,
+                       uInt8* dest, uInt32 size);
+
+    // Worst case size of packing 'size' bytes
+    static uInt32 maxPackedSize(uInt32 size) { return size + size / 128 + 1; }
+
+    private:
+      // The parent OSystem object
+    OSystem& myOSystem;
+
+    // Ring holding the packed snapshots
+    BytePtr myRing;
+    uInt32 myCapacity;
+    uInt32 myHead;
+    uInt32 myUsed;
+    std::deque<Entry> myEntries;
+
+    // Unpacked keyframe of the newest group, and the number of deltas
+    // stored against it
+    BytePtr myKeyframe;
+    uInt32 myKeyframeSize;
+    uInt32 myDeltaCount;
+
+    // Snapshot every myInterval frames
+    uInt32 myInterval;
+    uInt32 myFrameCount;
+
+    // Serializer the console state is saved into/restored from, and
+    // the buffer a delta is unpacked into
+    Serializer myState;
+    BytePtr myBuffer;
+    uInt32 myBufferSize;
+
+    // Cost of taking the snapshots
+    uInt64 myTotalSnapshots;
+    uInt64 myTotalTicks;
+
+    private:
+      // Following constructors and assignment operators not supported
+    RewindManager() = delete;
+    RewindManager(const RewindManager&) = delete;
+    RewindManager(RewindManager&&) = delete;
+    RewindManager& operator=(const RewindManager&) = delete;
+    RewindManager& operator=(RewindManager&&) = delete;
+};
+
+#endif
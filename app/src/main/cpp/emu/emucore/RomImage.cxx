@@ -0,0 +1,51 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "RomImage.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomImage::RomImage(const uInt8* data, uInt32 size, uInt32 padding)
+    : mySize(size),
+    myPadding(padding)
+{
+    if (size + padding == 0)
+        return;
+
+    myData = shared_ptr<uInt8>(new uInt8[size + padding], std::default_delete<uInt8[]>());
+    if (data != nullptr)
+        memcpy(myData.get(), data, size);
+    else
+        memset(myData.get(), 0, size);
+    memset(myData.get() + size, 0, padding);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomImage::RomImage(const RomImage& image, uInt32 offset, uInt32 size)
+    : myData(image.myData, image.myData.get() + offset),
+    mySize(size),
+    myPadding(offset + size == image.mySize ? image.myPadding : 0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8* RomImage::writable()
+{
+    if (shared())
+        *this = RomImage(myData.get(), mySize, myPadding);
+
+    return myData.get();
+}
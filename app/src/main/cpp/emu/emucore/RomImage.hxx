@@ -0,0 +1,99 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef ROM_IMAGE_HXX
+#define ROM_IMAGE_HXX
+
+#include "bspf.hxx"
+
+/**
+  An immutable ROM image, shared by reference count by everything holding
+  it: the bytes are copied once when the ROM is loaded, and from then on
+  the Rom of the OSystem, the cartridge and its clones all read the same
+  ones.  Copying a RomImage only shares the bytes.
+
+  A holder wanting to change the bytes (i.e. to patch the ROM) gets them
+  through writable(), which makes a copy of its own first if anyone else
+  holds them.  This is meant for the thread owning the console; holders
+  on other threads only ever read.
+*/
+class RomImage
+{
+    public:
+    // The number of zero bytes following a copied image, so that carts
+    // reading a bit past the end of the ROM needn't pad it themselves
+    enum { kPadding = 256 };
+
+    /**
+      Create an empty image.
+    */
+    RomImage() : mySize(0), myPadding(0) { }
+
+    /**
+      Create an image from a copy of the given bytes (zeros if there are
+      none), followed by 'padding' zero bytes.
+    */
+    RomImage(const uInt8* data, uInt32 size, uInt32 padding = kPadding);
+
+    /**
+      Create an image of a piece of another one, sharing its bytes.
+    */
+    RomImage(const RomImage& image, uInt32 offset, uInt32 size);
+
+    RomImage(const RomImage&) = default;
+    RomImage& operator=(const RomImage&) = default;
+
+    public:
+    const uInt8* data() const { return myData.get(); }
+    uInt32 size() const { return mySize; }
+    bool empty() const { return mySize == 0; }
+
+    const uInt8& operator[](uInt32 index) const { return myData.get()[index]; }
+
+    /**
+      The number of zero bytes known to follow the image.
+    */
+    uInt32 padding() const { return myPadding; }
+
+    /**
+      A pointer into the image for the page tables of System, which only
+      ever read through it.
+    */
+    uInt8* peekBase(uInt32 offset) const { return myData.get() + offset; }
+
+    /**
+      Whether anyone else holds the bytes of the image.
+    */
+    bool shared() const { return myData.use_count() > 1; }
+
+    /**
+      Get write access to the bytes, copying them first if they are shared.
+
+      @return  A pointer to the bytes, which may have moved
+    */
+    uInt8* writable();
+
+    private:
+    // The bytes, pointing into the allocation they share (which can be
+    // the one of a larger image)
+    shared_ptr<uInt8> myData;
+
+    uInt32 mySize;
+    uInt32 myPadding;
+};
+
+#endif
@@ -84,6 +84,11 @@ class SaveKey : public Controller
     */
     void systemCyclesReset() override;
 
+    /**
+      Returns the EEPROM holding the saved data.
+    */
+    MT24LC256* eeprom() const override { return myEEPROM.get(); }
+
     private:
       // The EEPROM used in the SaveKey
     unique_ptr<MT24LC256> myEEPROM;
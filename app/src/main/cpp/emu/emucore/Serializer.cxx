@@ -18,7 +18,6 @@
 //============================================================================
 
 #include <fstream>
-#include <sstream>
 
 ////#include "FSNode.hxx"
 #include "Serializer.hxx"
@@ -28,7 +27,14 @@ using std::ios_base;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Serializer::Serializer(const string& filename, bool readonly)
-    : myStream(nullptr)
+    : myStream(nullptr),
+    myIsMemory(false),
+    myBuffer(nullptr),
+    myData(nullptr),
+    myCapacity(0),
+    mySize(0),
+    myWritePos(0),
+    myReadPos(0)
 {
     if (readonly)
     {
@@ -68,137 +74,87 @@ Serializer::Serializer(const string& filename, bool readonly)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Serializer::Serializer()
-    : myStream(nullptr)
+Serializer::Serializer(uInt32 capacity)
+    : myStream(nullptr),
+    myIsMemory(true),
+    myBuffer(nullptr),
+    myData(nullptr),
+    myCapacity(0),
+    mySize(0),
+    myWritePos(0),
+    myReadPos(0)
 {
-    myStream = make_ptr<stringstream>(ios::in | ios::out | ios::binary);
-
-    // For some reason, Windows and possibly OSX needs to store something in
-    // the stream before it is used for the first time
-    if (myStream)
-    {
-        myStream->exceptions(ios_base::failbit | ios_base::badbit | ios_base::eofbit);
-        putBool(true);
-        reset();
-    }
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::reset()
-{
-    myStream->clear();
-    myStream->seekg(ios_base::beg);
-    myStream->seekp(ios_base::beg);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt8 Serializer::getByte() const
-{
-    char buf;
-    myStream->read(&buf, 1);
-
-    return buf;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::getByteArray(uInt8* array, uInt32 size) const
-{
-    myStream->read(reinterpret_cast<char*>(array), size);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt16 Serializer::getShort() const
-{
-    uInt16 val = 0;
-    myStream->read(reinterpret_cast<char*>(&val), sizeof(uInt16));
-
-    return val;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::getShortArray(uInt16* array, uInt32 size) const
-{
-    myStream->read(reinterpret_cast<char*>(array), sizeof(uInt16)*size);
+  // The arena is otherwise allocated on first write
+    if (capacity > 0)
+        grow(capacity);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 Serializer::getInt() const
+Serializer::Serializer(uInt8* buffer, uInt32 capacity)
+    : myStream(nullptr),
+    myIsMemory(true),
+    myBuffer(nullptr),
+    myData(buffer),
+    myCapacity(buffer != nullptr ? capacity : 0),
+    mySize(0),
+    myWritePos(0),
+    myReadPos(0)
 {
-    uInt32 val = 0;
-    myStream->read(reinterpret_cast<char*>(&val), sizeof(uInt32));
-
-    return val;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::getIntArray(uInt32* array, uInt32 size) const
-{
-    myStream->read(reinterpret_cast<char*>(array), sizeof(uInt32)*size);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-string Serializer::getString() const
+void Serializer::reset()
 {
-    int len = getInt();
-    string str;
-    str.resize(len);
-    myStream->read(&str[0], len);
-
-    return str;
-}
+    if (myIsMemory)
+    {
+        myReadPos = myWritePos = 0;
+        return;
+    }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Serializer::getBool() const
-{
-    return getByte() == TruePattern;
+    myStream->clear();
+    myStream->seekg(ios_base::beg);
+    myStream->seekp(ios_base::beg);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putByte(uInt8 value)
+void Serializer::setData(const uInt8* data, uInt32 size)
 {
-    myStream->write(reinterpret_cast<char*>(&value), 1);
-}
+    if (!myIsMemory)
+        return;
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putByteArray(const uInt8* array, uInt32 size)
-{
-    myStream->write(reinterpret_cast<const char*>(array), size);
+    myReadPos = myWritePos = 0;
+    write(data, size);
+    myWritePos = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putShort(uInt16 value)
+void Serializer::grow(uInt32 required)
 {
-    myStream->write(reinterpret_cast<char*>(&value), sizeof(uInt16));
-}
+  // Caller-owned memory cannot be enlarged
+    if (myData != nullptr && myBuffer == nullptr)
+        throw runtime_error("Serializer: write past end of buffer");
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putShortArray(const uInt16* array, uInt32 size)
-{
-    myStream->write(reinterpret_cast<const char*>(array), sizeof(uInt16)*size);
-}
+    uInt32 capacity = std::max(myCapacity * 2, 4096u);
+    while (capacity < required)
+        capacity *= 2;
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putInt(uInt32 value)
-{
-    myStream->write(reinterpret_cast<char*>(&value), sizeof(uInt32));
-}
+    unique_ptr<uInt8[]> buffer = make_ptr<uInt8[]>(capacity);
+    if (mySize > 0)
+        memcpy(buffer.get(), myData, mySize);
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putIntArray(const uInt32* array, uInt32 size)
-{
-    myStream->write(reinterpret_cast<const char*>(array), sizeof(uInt32)*size);
+    myBuffer = std::move(buffer);
+    myData = myBuffer.get();
+    myCapacity = capacity;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putString(const string& str)
+void Serializer::writeStream(const void* data, uInt32 size)
 {
-    int len = int(str.length());
-    putInt(len);
-    myStream->write(str.data(), len);
+    myStream->write(reinterpret_cast<const char*>(data), size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putBool(bool b)
+void Serializer::readStream(void* data, uInt32 size) const
 {
-    putByte(b ? TruePattern : FalsePattern);
+    myStream->read(reinterpret_cast<char*>(data), size);
 }
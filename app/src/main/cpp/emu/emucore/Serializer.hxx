@@ -36,6 +36,13 @@
   All bytes, shorts and ints should be cast to their appropriate data type upon
   method return.
 
+  The in-memory variant writes into a contiguous, growable byte arena
+  instead of an iostream, so that a complete console state can be saved
+  and restored cheaply (i.e. every frame).  The serialized data can be
+  accessed directly through data() and size().  It can also write into
+  caller-owned memory of a fixed size, in which case a write past the end
+  throws instead of growing the arena.
+
   @author  Stephen Anthony
   @version $Id: Serializer.hxx 3239 2015-12-29 19:22:46Z stephena $
 */
@@ -54,20 +61,45 @@ class Serializer
         was correctly initialized.
       */
     Serializer(const string& filename, bool readonly = false);
-    Serializer();
+    explicit Serializer(uInt32 capacity = 0);
+
+    /**
+      Creates an in-memory Serializer which writes straight into the given
+      buffer.  The buffer is not owned and never grown; writing more than
+      capacity bytes throws.
+    */
+    Serializer(uInt8* buffer, uInt32 capacity);
 
     public:
       /**
         Answers whether the serializer is currently initialized for reading
         and writing.
       */
-    explicit operator bool() const { return myStream != nullptr; }
+    explicit operator bool() const { return myStream != nullptr || myIsMemory; }
 
     /**
       Resets the read/write location to the beginning of the stream.
+      For in-memory streams, the allocated capacity is kept.
     */
     void reset();
 
+    /**
+      Answers the serialized data of an in-memory stream (nullptr for files).
+      The pointer is valid until the next write which enlarges the arena.
+    */
+    const uInt8* data() const { return myData; }
+
+    /**
+      Answers the number of bytes of serialized data in an in-memory stream.
+    */
+    uInt32 size() const { return mySize; }
+
+    /**
+      Replaces the contents of an in-memory stream with the given data
+      and resets the read/write location.
+    */
+    void setData(const uInt8* data, uInt32 size);
+
     /**
       Reads a byte value (unsigned 8-bit) from the current input stream.
 
@@ -186,10 +218,70 @@ class Serializer
     */
     void putBool(bool b);
 
+    /**
+      Describes the fixed layout of a block of device state, which is saved
+      and restored with a single copy: all 32-bit fields come first, then
+      all 16-bit fields, then all 8-bit fields (bools are stored as 0/1),
+      so that the struct holding them has no hidden padding.  The fields
+      are stored in native byte order like all other values.
+    */
+    struct Layout {
+        uInt32 tag;     // Identifies the device and layout version (makeTag)
+        uInt16 ints;    // Number of 32-bit fields
+        uInt16 shorts;  // Number of 16-bit fields
+        uInt16 bytes;   // Number of 8-bit fields, including padding
+
+        constexpr uInt32 size() const { return 4 * ints + 2 * shorts + bytes; }
+    };
+
+    static constexpr uInt32 makeTag(char a, char b, char c, uInt8 version)
+    {
+        return uInt32(uInt8(a)) | (uInt32(uInt8(b)) << 8) |
+            (uInt32(uInt8(c)) << 16) | (uInt32(version) << 24);
+    }
+
+    /**
+      Writes a block of device state, preceded by the tag of its layout.
+
+      @param layout  The layout of the block
+      @param block   The block to write (layout.size() bytes)
+    */
+    void putBlock(const Layout& layout, const void* block);
+
+    /**
+      Reads a block of device state written by putBlock().
+
+      @param layout  The layout of the block
+      @param block   The location to store the block (layout.size() bytes)
+
+      @result False if the block was written with another layout
+    */
+    bool getBlock(const Layout& layout, void* block) const;
+
     private:
-      // The stream to send the serialized data to.
+      // Write/read raw bytes to/from the arena or the stream
+    void write(const void* data, uInt32 size);
+    void read(void* data, uInt32 size) const;
+
+    // Fallbacks for file streams and arena growth
+    void writeStream(const void* data, uInt32 size);
+    void readStream(void* data, uInt32 size) const;
+    void grow(uInt32 required);
+
+    private:
+      // The stream to send the serialized data to (file streams only)
     unique_ptr<iostream> myStream;
 
+    // Arena holding the serialized data of in-memory streams; myData points
+    // either into myBuffer or to the caller-owned memory
+    bool myIsMemory;
+    unique_ptr<uInt8[]> myBuffer;
+    uInt8* myData;
+    uInt32 myCapacity;
+    uInt32 mySize;
+    uInt32 myWritePos;
+    mutable uInt32 myReadPos;
+
     enum {
         TruePattern = 0xfe,
         FalsePattern = 0x01
@@ -203,4 +295,169 @@ class Serializer
     Serializer& operator=(Serializer&&) = delete;
 };
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Serializer::write(const void* data, uInt32 size)
+{
+    if (!myIsMemory)
+    {
+        writeStream(data, size);
+        return;
+    }
+
+    if (myWritePos + size > myCapacity)
+        grow(myWritePos + size);
+
+    memcpy(myData + myWritePos, data, size);
+    myWritePos += size;
+    mySize = myWritePos;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Serializer::read(void* data, uInt32 size) const
+{
+    if (!myIsMemory)
+    {
+        readStream(data, size);
+        return;
+    }
+
+    if (size > mySize - myReadPos)
+        throw runtime_error("Serializer: read past end of data");
+
+    memcpy(data, myData + myReadPos, size);
+    myReadPos += size;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline uInt8 Serializer::getByte() const
+{
+    uInt8 val;
+    read(&val, 1);
+
+    return val;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Serializer::getByteArray(uInt8* array, uInt32 size) const
+{
+    read(array, size);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline uInt16 Serializer::getShort() const
+{
+    uInt16 val = 0;
+    read(&val, sizeof(uInt16));
+
+    return val;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Serializer::getShortArray(uInt16* array, uInt32 size) const
+{
+    read(array, sizeof(uInt16)*size);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline uInt32 Serializer::getInt() const
+{
+    uInt32 val = 0;
+    read(&val, sizeof(uInt32));
+
+    return val;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Serializer::getIntArray(uInt32* array, uInt32 size) const
+{
+    read(array, sizeof(uInt32)*size);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline string Serializer::getString() const
+{
+    uInt32 len = getInt();
+    string str;
+    str.resize(len);
+    if (len > 0)
+        read(&str[0], len);
+
+    return str;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline bool Serializer::getBool() const
+{
+    return getByte() == TruePattern;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Serializer::putByte(uInt8 value)
+{
+    write(&value, 1);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Serializer::putByteArray(const uInt8* array, uInt32 size)
+{
+    write(array, size);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Serializer::putShort(uInt16 value)
+{
+    write(&value, sizeof(uInt16));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Serializer::putShortArray(const uInt16* array, uInt32 size)
+{
+    write(array, sizeof(uInt16)*size);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Serializer::putInt(uInt32 value)
+{
+    write(&value, sizeof(uInt32));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Serializer::putIntArray(const uInt32* array, uInt32 size)
+{
+    write(array, sizeof(uInt32)*size);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Serializer::putString(const string& str)
+{
+    uInt32 len = uInt32(str.length());
+    putInt(len);
+    write(str.data(), len);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Serializer::putBool(bool b)
+{
+    putByte(b ? TruePattern : FalsePattern);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Serializer::putBlock(const Layout& layout, const void* block)
+{
+    write(&layout.tag, sizeof(uInt32));
+    write(block, layout.size());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline bool Serializer::getBlock(const Layout& layout, void* block) const
+{
+    uInt32 tag;
+    read(&tag, sizeof(uInt32));
+    if (tag != layout.tag)
+        return false;
+
+    read(block, layout.size());
+    return true;
+}
+
 #endif
@@ -75,8 +75,11 @@ Settings::Settings(OSystem& osystem)
     // Sound options
     setInternal("sound", "true");
     setInternal("fragsize", "512");
-    setInternal("freq", "31400");
+    setInternal("freq", "44100");
+    setInternal("hwchannels", "1");
+    setInternal("sampleformat", "s16");
     setInternal("volume", "100");
+    setInternal("capturefile", "");
 
     // Input event options
     setInternal("keymap", "");
@@ -129,6 +132,17 @@ Settings::Settings(OSystem& osystem)
 
     // Misc options
     setInternal("autoslot", "false");
+    setInternal("rewindbuffer", "0");
+    setInternal("rewindinterval", "1");
+    setInternal("runahead", "0");
+    setInternal("pipeline", "false");
+    setInternal("consolepool", "0");
+    setInternal("seed", "0");
+    setInternal("moviefile", "");
+    setInternal("netpeer", "");
+    setInternal("netport", "6502");
+    setInternal("netrollback", "8");
+    setInternal("netdelay", "50");
     setInternal("loglevel", "1");
     setInternal("logtoconsole", "0");
     setInternal("tiadriven", "false");
@@ -159,9 +173,6 @@ Settings::Settings(OSystem& osystem)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Settings::loadConfig()
 {
-    string line, key, value;
-    string::size_type equalPos, garbage;
-
     ifstream in(myOSystem.configFile());
     if (!in || !in.is_open())
     {
@@ -169,6 +180,22 @@ void Settings::loadConfig()
         return;
     }
 
+    loadFromStream(in);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Settings::loadPrefs(const string& prefs)
+{
+    istringstream in(prefs);
+    loadFromStream(in);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Settings::loadFromStream(istream& in)
+{
+    string line, key, value;
+    string::size_type equalPos, garbage;
+
     while (getline(in, line))
     {
       // Strip all whitespace and tabs from the line
@@ -286,7 +313,11 @@ void Settings::validate()
     if (i < 0 || i > 100)    setInternal("volume", "100");
     i = getInt("freq");
     if (!(i == 11025 || i == 22050 || i == 31400 || i == 44100 || i == 48000))
-        setInternal("freq", "31400");
+        setInternal("freq", "44100");
+    i = getInt("hwchannels");
+    if (i != 1 && i != 2)  setInternal("hwchannels", "1");
+    s = getString("sampleformat");
+    if (s != "s16" && s != "f32")  setInternal("sampleformat", "s16");
 #endif
 
     i = getInt("joydeadzone");
@@ -305,6 +336,27 @@ void Settings::validate()
     if (i < 1)        setInternal("msense", "1");
     else if (i > 20)  setInternal("msense", "15");
 
+    i = getInt("rewindbuffer");
+    if (i < 0)           setInternal("rewindbuffer", "0");
+    else if (i > 65536)  setInternal("rewindbuffer", "65536");
+
+    i = getInt("rewindinterval");
+    if (i < 1)        setInternal("rewindinterval", "1");
+    else if (i > 60)  setInternal("rewindinterval", "60");
+
+    i = getInt("runahead");
+    if (i < 0 || i > 4)  setInternal("runahead", "0");
+
+    i = getInt("consolepool");
+    if (i < 0 || i > 16)  setInternal("consolepool", "0");
+
+    i = getInt("netport");
+    if (i < 1024 || i > 65534)  setInternal("netport", "6502");
+
+    i = getInt("netrollback");
+    if (i < 1)        setInternal("netrollback", "1");
+    else if (i > 30)  setInternal("netrollback", "30");
+
     i = getInt("ssinterval");
     if (i < 1)        setInternal("ssinterval", "2");
     else if (i > 10)  setInternal("ssinterval", "10");
@@ -362,7 +414,10 @@ void Settings::usage() const
         << "  -sound        <1|0>          Enable sound generation\n"
         << "  -fragsize     <number>       The size of sound fragments (must be a power of two)\n"
         << "  -freq         <number>       Set sound sample output frequency (11025|22050|31400|44100|48000)\n"
+        << "  -hwchannels   <1|2>          Number of interleaved output channels\n"
+        << "  -sampleformat <s16|f32>      Generate signed 16-bit or 32-bit float samples\n"
         << "  -volume       <number>       Set the volume (0 - 100)\n"
+        << "  -capturefile  <file>         Record the sound output to this file\n"
         << endl
 #endif
         << "  -tia.zoom     <zoom>         Use the specified zoom level (windowed mode) for TIA image\n"
@@ -402,6 +457,17 @@ void Settings::usage() const
         << "  -saport       <lr|rl>        How to assign virtual ports to multiple Stelladaptor/2600-daptors\n"
         << "  -ctrlcombo    <1|0>          Use key combos involving the Control key (Control-Q for quit may be disabled!)\n"
         << "  -autoslot     <1|0>          Automatically switch to next save slot when state saving\n"
+        << "  -rewindbuffer <number>       Memory in KB to keep states for rewinding in (0 disables rewind)\n"
+        << "  -rewindinterval <number>     Number of frames between rewind states (1-60)\n"
+        << "  -runahead     <number>       Show the frame this many frames ahead (0-4) to hide input lag\n"
+        << "  -pipeline     <1|0>          Convert frames to colours on a second core while emulating the next\n"
+        << "  -consolepool  <number>       Keep the consoles of this many ROMs resident for quick switching (0-16)\n"
+        << "  -seed         <number>       Fixed random seed for reproducible emulation (0 uses the clock)\n"
+        << "  -moviefile    <file>         Record movies to/play movies back from this file\n"
+        << "  -netpeer      <host:port>    Netplay peer address, or 'loopback' for a local stand-in guest\n"
+        << "  -netport      <number>       Local UDP port for netplay\n"
+        << "  -netrollback  <number>       Max. frames netplay predicts the peer's input for (1-30)\n"
+        << "  -netdelay     <number>       Latency in ms of the loopback stand-in guest\n"
         << "  -stats        <1|0>          Overlay console info during emulation\n"
         << "  -fastscbios   <1|0>          Disable Supercharger BIOS progress loading bars\n"
         << "  -snapsavedir  <path>         The directory to save snapshot files to\n"
@@ -50,6 +50,12 @@ class Settings
       */
     string loadCommandLine(int argc, char** argv);
 
+    /**
+      This method should be called to apply the preferences handed over
+      by the frontend, given as 'key = value' lines as in the rc file.
+    */
+    void loadPrefs(const string& prefs);
+
     /**
       This method should be called *after* settings have been read,
       to validate (and change, if necessary) any improper settings.
@@ -100,6 +106,11 @@ class Settings
     */
     virtual void saveConfig();
 
+    /**
+      Parse 'key = value' lines from the given stream.
+    */
+    void loadFromStream(istream& in);
+
     // Trim leading and following whitespace from a string
     static string trim(string& str)
     {
@@ -0,0 +1,267 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "SharedContext.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SharedContext& SharedContext::instance()
+{
+    static SharedContext context;
+    return context;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SharedContext::SharedContext()
+    : myArchiveClock(0)
+{
+  // Fill the polynomials
+    polyInit(myPoly4, 4, 4, 3);
+    polyInit(myPoly5, 5, 5, 3);
+    polyInit(myPoly9, 9, 9, 5);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uInt32* SharedContext::palette(const uInt32* colors)
+{
+    string key(reinterpret_cast<const char*>(colors), 256 * sizeof(uInt32));
+
+    std::lock_guard<std::mutex> guard(myLock);
+
+    unique_ptr<uInt32[]>& palette = myPalettes[key];
+    if (!palette)
+    {
+        palette = make_ptr<uInt32[]>(256);
+        memcpy(palette.get(), colors, 256 * sizeof(uInt32));
+    }
+
+    return palette.get();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<const SharedContext::UserPalette>
+    SharedContext::userPalette(const string& filename)
+{
+    ifstream in(filename, std::ios::binary);
+    if (!in)
+        return nullptr;
+
+    string data((std::istreambuf_iterator<char>(in)),
+        std::istreambuf_iterator<char>());
+
+    // Make sure the file contains enough data for the NTSC, PAL and SECAM
+    // palettes.  This means 128 colours each for NTSC and PAL, at 3 bytes
+    // per pixel and 8 colours for SECAM at 3 bytes per pixel
+    const uInt32 size = 128 * 3 * 2 + 8 * 3;
+    if (data.size() < size)
+    {
+        cerr << "ERROR: invalid palette file " << filename << endl;
+        return nullptr;
+    }
+    data.resize(size);
+
+    std::lock_guard<std::mutex> guard(myLock);
+
+    std::weak_ptr<const UserPalette>& shared = myUserPalettes[data];
+    shared_ptr<const UserPalette> palette = shared.lock();
+    if (palette)
+        return palette;
+
+    shared_ptr<UserPalette> user = make_shared<UserPalette>();
+    memset(user.get(), 0, sizeof(UserPalette));
+
+    const uInt8* pixbuf = reinterpret_cast<const uInt8*>(data.data());
+    for (int i = 0; i < 128; i++, pixbuf += 3)  // NTSC palette
+        user->ntsc[(i << 1)] = (int(pixbuf[0]) << 16) + (int(pixbuf[1]) << 8) + int(pixbuf[2]);
+    for (int i = 0; i < 128; i++, pixbuf += 3)  // PAL palette
+        user->pal[(i << 1)] = (int(pixbuf[0]) << 16) + (int(pixbuf[1]) << 8) + int(pixbuf[2]);
+
+    uInt32 secam[16];  // All 8 24-bit pixels, plus 8 colorloss pixels
+    for (int i = 0; i < 8; i++, pixbuf += 3)    // SECAM palette
+    {
+        secam[(i << 1)] = (int(pixbuf[0]) << 16) + (int(pixbuf[1]) << 8) + int(pixbuf[2]);
+        secam[(i << 1) + 1] = 0;
+    }
+    uInt32* ptr = user->secam;
+    for (int i = 0; i < 16; ++i)
+    {
+        uInt32* s = secam;
+        for (int j = 0; j < 16; ++j)
+            *ptr++ = *s++;
+    }
+
+    // Forget the palettes nobody uses any more
+    for (auto i = myUserPalettes.begin(); i != myUserPalettes.end(); )
+    {
+        if (i->second.expired())
+            i = myUserPalettes.erase(i);
+        else
+            ++i;
+    }
+    myUserPalettes[data] = user;
+
+    return user;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<PropertiesSet::PropsList>
+    SharedContext::properties(const string& filename)
+{
+    std::lock_guard<std::mutex> guard(myLock);
+
+    auto i = myProperties.find(filename);
+    return i != myProperties.end() ? i->second : nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SharedContext::setProperties(const string& filename,
+    const shared_ptr<PropertiesSet::PropsList>& properties)
+{
+    std::lock_guard<std::mutex> guard(myLock);
+
+    myProperties[filename] = properties;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<const ZipArchive> SharedContext::zipArchive(const string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return nullptr;
+
+    shared_ptr<const ZipArchive> archive = zipArchive(fd, 0, 0, path);
+    close(fd);
+
+    return archive;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<const ZipArchive> SharedContext::zipArchive(int fd, uInt64 offset,
+    uInt64 length)
+{
+    return zipArchive(fd, offset, length, "");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<const ZipArchive> SharedContext::zipArchive(int fd, uInt64 offset,
+    uInt64 length, const string& path)
+{
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+        return nullptr;
+
+    // The same file is the same archive, by whatever path or descriptor
+    // it is reached
+    ostringstream buf;
+    buf << info.st_dev << ":" << info.st_ino << ":" << offset << ":" << length;
+    string key = buf.str();
+
+    {
+        std::lock_guard<std::mutex> guard(myLock);
+
+        auto i = myArchives.find(key);
+        if (i != myArchives.end())
+        {
+            if (i->second.fileSize == uInt64(info.st_size) &&
+                i->second.fileTime == Int64(info.st_mtime))
+            {
+                i->second.lastUsed = ++myArchiveClock;
+                return i->second.archive;
+            }
+            myArchives.erase(i);
+        }
+    }
+
+    shared_ptr<const ZipArchive> archive = ZipArchive::open(fd, offset, length);
+    if (!archive)
+    {
+        if (path != "")
+            cerr << "ERROR: invalid zip archive " << path << endl;
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> guard(myLock);
+
+    // Holders of the archives dropped keep them open until they are done
+    if (myArchives.size() >= kMaxArchives)
+    {
+        auto oldest = myArchives.begin();
+        for (auto i = myArchives.begin(); i != myArchives.end(); ++i)
+            if (i->second.lastUsed < oldest->second.lastUsed)
+                oldest = i;
+        myArchives.erase(oldest);
+    }
+
+    myArchives[key] = { archive, uInt64(info.st_size), Int64(info.st_mtime),
+                        ++myArchiveClock };
+
+    return archive;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string SharedContext::info()
+{
+    std::lock_guard<std::mutex> guard(myLock);
+
+    uInt32 userPalettes = 0, properties = 0;
+    for (const auto& i : myUserPalettes)
+        if (!i.second.expired())
+            ++userPalettes;
+    for (const auto& i : myProperties)
+        properties += uInt32(i.second->size());
+
+    uInt32 archiveEntries = 0;
+    for (const auto& i : myArchives)
+        archiveEntries += uInt32(i.second.archive->entries().size());
+
+    uInt32 bytes = sizeof(SharedContext) +
+        uInt32(myPalettes.size()) * 256 * sizeof(uInt32) +
+        userPalettes * sizeof(UserPalette);
+
+    ostringstream buf;
+    buf << "palettes=" << myPalettes.size()
+        << " userPalettes=" << userPalettes
+        << " propertyFiles=" << myProperties.size()
+        << " properties=" << properties
+        << " archives=" << myArchives.size()
+        << " archiveEntries=" << archiveEntries
+        << " bytes=" << bytes;
+
+    return buf.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SharedContext::polyInit(uInt8* poly, int size, int f0, int f1)
+{
+    int mask = (1 << size) - 1, x = mask;
+
+    for (int i = 0; i < mask; i++)
+    {
+        int bit0 = ((size - f0) ? (x >> (size - f0)) : x) & 0x01;
+        int bit1 = ((size - f1) ? (x >> (size - f1)) : x) & 0x01;
+        poly[i] = x & 1;
+        // calculate next bit
+        x = (x >> 1) | ((bit0 ^ bit1) << (size - 1));
+    }
+}
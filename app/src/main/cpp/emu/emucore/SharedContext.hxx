@@ -0,0 +1,176 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef SHARED_CONTEXT_HXX
+#define SHARED_CONTEXT_HXX
+
+#include <map>
+#include <mutex>
+
+#include "bspf.hxx"
+#include "PropsSet.hxx"
+#include "ZipArchive.hxx"
+
+/**
+  This class holds the data which every emulator instance needs, but
+  which never changes once it has been built: the TIA sound polynomials,
+  the palettes handed to the frontend, the user palettes, the properties
+  read from files and the zip archives ROMs are loaded from.  It exists
+  once per process; the instances only keep pointers into it, so that
+  running many consoles costs their mutable state and little else.
+*/
+class SharedContext
+{
+    public:
+      /**
+        Get the context of the process, creating it on first use.
+      */
+    static SharedContext& instance();
+
+    public:
+      // The colours of a user palette file, for NTSC, PAL and SECAM
+    struct UserPalette {
+        uInt32 ntsc[256];
+        uInt32 pal[256];
+        uInt32 secam[256];
+    };
+
+    enum {
+        POLY4_SIZE = 0x000f,
+        POLY5_SIZE = 0x001f,
+        POLY9_SIZE = 0x01ff
+    };
+
+    /**
+      Get the bit patterns of the TIA sound polynomials, one bit per byte.
+    */
+    const uInt8* poly4() const { return myPoly4; }
+    const uInt8* poly5() const { return myPoly5; }
+    const uInt8* poly9() const { return myPoly9; }
+
+    /**
+      Get a palette with the given colours.  Everyone asking for the same
+      colours gets the same palette, which lives as long as the process.
+
+      @param colors  The 256 colours of the palette
+      @return  The shared copy of the colours
+    */
+    const uInt32* palette(const uInt32* colors);
+
+    /**
+      Get the user palette in the given file, read the first time it is
+      asked for.  Files with the same contents share one palette.
+
+      @param filename  The palette file
+      @return  The palette, or the null pointer if there is no valid one
+    */
+    shared_ptr<const UserPalette> userPalette(const string& filename);
+
+    /**
+      Get the properties last read from or saved to the given file.
+
+      @param filename  The properties file
+      @return  The properties, or the null pointer if the file hasn't
+               been read yet
+    */
+    shared_ptr<PropertiesSet::PropsList> properties(const string& filename);
+
+    /**
+      Remember the properties read from or saved to the given file.  The
+      list must not be changed any more; whoever wants to change it
+      copies it first.
+
+      @param filename    The properties file
+      @param properties  The properties of the file
+    */
+    void setProperties(const string& filename,
+        const shared_ptr<PropertiesSet::PropsList>& properties);
+
+    /**
+      Get the zip archive in the given file, opened the first time it is
+      asked for and again only once the file has changed.
+
+      @param path  The archive file
+      @return  The archive, or the null pointer if it can't be read
+    */
+    shared_ptr<const ZipArchive> zipArchive(const string& path);
+
+    /**
+      Get the zip archive in a piece of the given file, i.e. an asset
+      within an application package, like zipArchive(path).  The
+      descriptor can be closed once this returns.
+    */
+    shared_ptr<const ZipArchive> zipArchive(int fd, uInt64 offset, uInt64 length);
+
+    /**
+      Answers the amount of data shared, as a string of key=value pairs.
+    */
+    string info();
+
+    private:
+    SharedContext();
+
+    // Fill a polynomial bit pattern
+    static void polyInit(uInt8* poly, int size, int f0, int f1);
+
+    // Get the archive opened from the descriptor, from the cache if the
+    // file hasn't changed since
+    shared_ptr<const ZipArchive> zipArchive(int fd, uInt64 offset, uInt64 length,
+        const string& path);
+
+    private:
+      // An archive opened, and the size and time of change of its file then
+    struct CachedArchive {
+        shared_ptr<const ZipArchive> archive;
+        uInt64 fileSize;
+        Int64 fileTime;
+        uInt64 lastUsed;
+    };
+
+    // The number of archives kept open
+    enum { kMaxArchives = 8 };
+
+    private:
+    uInt8 myPoly4[POLY4_SIZE];
+    uInt8 myPoly5[POLY5_SIZE];
+    uInt8 myPoly9[POLY9_SIZE];
+
+    // Guards the tables below, which are filled as the instances need them
+    std::mutex myLock;
+
+    // The palettes, keyed by their colours
+    std::map<string, unique_ptr<uInt32[]>> myPalettes;
+
+    // The user palettes in use, keyed by the contents of their file
+    std::map<string, std::weak_ptr<const UserPalette>> myUserPalettes;
+
+    // The properties of each properties file
+    std::map<string, shared_ptr<PropertiesSet::PropsList>> myProperties;
+
+    // The archives opened last, keyed by their file and piece of it
+    std::map<string, CachedArchive> myArchives;
+    uInt64 myArchiveClock;
+
+    private:
+      // Following constructors and assignment operators not supported
+    SharedContext(const SharedContext&) = delete;
+    SharedContext(SharedContext&&) = delete;
+    SharedContext& operator=(const SharedContext&) = delete;
+    SharedContext& operator=(SharedContext&&) = delete;
+};
+
+#endif
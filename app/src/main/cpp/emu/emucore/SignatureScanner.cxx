@@ -0,0 +1,115 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <deque>
+
+#include "SignatureScanner.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SignatureScanner::SignatureScanner(const Signature* signatures, uInt32 count)
+{
+    // Build the trie of the signatures; state 0 is the root, and a
+    // missing transition is 0 until the failure links fill it in
+    myNext.assign(256, 0);
+    vector<vector<uInt16>> ending(1);
+
+    for (uInt32 s = 0; s < count; ++s)
+    {
+        uInt32 state = 0;
+        for (uInt32 i = 0; i < signatures[s].size; ++i)
+        {
+            uInt8 byte = signatures[s].bytes[i];
+            if (myNext[state * 256 + byte] == 0)
+            {
+                myNext[state * 256 + byte] = uInt16(ending.size());
+                myNext.resize(myNext.size() + 256, 0);
+                ending.emplace_back();
+            }
+            state = myNext[state * 256 + byte];
+        }
+        ending[state].push_back(uInt16(s));
+        mySizes.push_back(signatures[s].size);
+    }
+
+    // Breadth first, complete the transitions along the failure links;
+    // a state also ends every signature its failure state ends
+    vector<uInt16> failure(ending.size(), 0);
+    std::deque<uInt32> queue;
+    for (uInt32 byte = 0; byte < 256; ++byte)
+        if (myNext[byte] != 0)
+            queue.push_back(myNext[byte]);
+
+    while (!queue.empty())
+    {
+        uInt32 state = queue.front();
+        queue.pop_front();
+
+        const vector<uInt16>& inherited = ending[failure[state]];
+        ending[state].insert(ending[state].end(), inherited.begin(), inherited.end());
+
+        for (uInt32 byte = 0; byte < 256; ++byte)
+        {
+            uInt16& next = myNext[state * 256 + byte];
+            uInt16 fallback = myNext[failure[state] * 256 + byte];
+            if (next != 0)
+            {
+                failure[next] = fallback;
+                queue.push_back(next);
+            }
+            else
+                next = fallback;
+        }
+    }
+
+    for (const auto& matches : ending)
+    {
+        myFirstMatch.push_back(uInt32(myMatches.size()));
+        myMatches.insert(myMatches.end(), matches.begin(), matches.end());
+    }
+    myFirstMatch.push_back(uInt32(myMatches.size()));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SignatureScanner::scan(const uInt8* image, uInt32 size, uInt32* hits) const
+{
+    uInt32 count = uInt32(mySizes.size());
+
+    // Where the next match of each signature may start
+    vector<uInt32> allowed(count, 0);
+    for (uInt32 s = 0; s < count; ++s)
+        hits[s] = 0;
+
+    // No match may take in the last byte
+    uInt32 end = size > 0 ? size - 1 : 0;
+
+    uInt32 state = 0;
+    for (uInt32 i = 0; i < end; ++i)
+    {
+        state = myNext[state * 256 + image[i]];
+
+        for (uInt32 m = myFirstMatch[state]; m < myFirstMatch[state + 1]; ++m)
+        {
+            uInt32 s = myMatches[m];
+            uInt32 start = i + 1 - mySizes[s];
+            if (start >= allowed[s])
+            {
+                ++hits[s];
+                allowed[s] = start + mySizes[s] + 1;
+            }
+        }
+    }
+}
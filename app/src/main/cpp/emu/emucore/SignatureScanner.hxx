@@ -0,0 +1,75 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef SIGNATURE_SCANNER_HXX
+#define SIGNATURE_SCANNER_HXX
+
+#include "bspf.hxx"
+
+/**
+  This class counts the occurrences of a set of byte signatures in an
+  image, all of them in a single pass.  The signatures are compiled into
+  an Aho-Corasick automaton with a transition for every byte value, so
+  scanning costs one table lookup per byte of the image, no matter how
+  many signatures there are.
+
+  The counts are the ones Cartridge::searchForBytes arrives at: matches
+  of the same signature don't overlap (the byte after a match is skipped
+  too), and no match takes in the last byte of the image.
+*/
+class SignatureScanner
+{
+    public:
+    struct Signature {
+        uInt8 bytes[8];
+        uInt32 size;
+    };
+
+    /**
+      Compile the signatures; their index is the one of their count.
+    */
+    SignatureScanner(const Signature* signatures, uInt32 count);
+
+    public:
+    /**
+      Count the occurrences of every signature in the image.
+
+      @param hits  The counts, one per signature
+    */
+    void scan(const uInt8* image, uInt32 size, uInt32* hits) const;
+
+    private:
+    // The state after each state and byte, 256 entries per state
+    vector<uInt16> myNext;
+
+    // The signatures ending in each state, myMatches[myFirstMatch[state]]
+    // up to myMatches[myFirstMatch[state + 1]]
+    vector<uInt32> myFirstMatch;
+    vector<uInt16> myMatches;
+
+    vector<uInt32> mySizes;
+
+    private:
+      // Following constructors and assignment operators not supported
+    SignatureScanner() = delete;
+    SignatureScanner(const SignatureScanner&) = delete;
+    SignatureScanner(SignatureScanner&&) = delete;
+    SignatureScanner& operator=(const SignatureScanner&) = delete;
+    SignatureScanner& operator=(SignatureScanner&&) = delete;
+};
+
+#endif
@@ -0,0 +1,294 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "SlotFile.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SlotFile::SlotFile()
+    : myFile(-1),
+    myMapping(nullptr),
+    myMappingSize(0),
+    myRecordSize(0),
+    mySlots(0),
+    myDirty(0),
+    myQuit(false)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SlotFile::~SlotFile()
+{
+    close();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SlotFile::open(const string& filename, uInt32 slots, uInt32 dataSize)
+{
+    close();
+
+    if (slots == 0 || slots > kMaxSlots)
+        return false;
+
+    // A missing file is only created when there is something to save
+    int fd = ::open(filename.c_str(), O_RDWR);
+    if (fd < 0 && (errno != ENOENT || dataSize == 0))
+        return false;
+
+    // Only one instance maps the file at a time; the lock is released
+    // with the descriptor, also when the process dies
+    if (fd >= 0 && flock(fd, LOCK_EX | LOCK_NB) != 0)
+    {
+        cerr << "ERROR: SlotFile: '" << filename << "' is in use" << endl;
+        ::close(fd);
+        return false;
+    }
+
+    uInt32 page = uInt32(sysconf(_SC_PAGESIZE));
+    uInt32 needed = (sizeof(Record) + dataSize + page - 1) / page * page;
+
+    // File header: magic, record size, number of records
+    uInt32 header[3] = { 0, 0, 0 };
+    struct stat st;
+    bool valid = fd >= 0 && fstat(fd, &st) == 0 &&
+        pread(fd, header, sizeof(header), 0) == ssize_t(sizeof(header)) &&
+        header[0] == kFileMagic && header[1] >= page && header[1] % page == 0 &&
+        header[2] == slots && st.st_size == off_t(header[1]) * (slots + 1);
+
+    // Anything but an empty file is left alone
+    if (!valid && header[0] != 0)
+    {
+        cerr << "ERROR: SlotFile: '" << filename << "' is not a slot file for "
+             << slots << " slots, not overwriting it" << endl;
+        ::close(fd);
+        return false;
+    }
+
+    uInt32 recordSize = header[1];
+    if (!valid || recordSize < needed)
+    {
+        int rebuilt = dataSize > 0 ?
+            rebuild(filename, fd, slots, valid ? recordSize : 0, needed) : -1;
+        if (fd >= 0)
+            ::close(fd);
+        if (rebuilt < 0)
+            return false;
+
+        fd = rebuilt;
+        recordSize = needed;
+    }
+
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;
+#endif
+    uInt32 mappingSize = recordSize * (slots + 1);
+    void* mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, flags, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    myFilename = filename;
+    myFile = fd;
+    myMapping = static_cast<uInt8*>(mapping);
+    myMappingSize = mappingSize;
+    myRecordSize = recordSize;
+    mySlots = slots;
+
+    myDirty = 0;
+    myQuit = false;
+    myFlushThread = std::thread(&SlotFile::run, this);
+
+    return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int SlotFile::rebuild(const string& filename, int fd, uInt32 slots,
+                      uInt32 oldRecordSize, uInt32 recordSize)
+{
+    // The file is laid out under another name and then renamed into
+    // place, so a crash leaves either the old or the new file behind.
+    // A temporary file nobody holds the lock of is left over by a crash.
+    string tempname = filename + ".tmp";
+    int temp = ::open(tempname.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (temp < 0 && errno == EEXIST)
+    {
+        int stale = ::open(tempname.c_str(), O_RDWR);
+        if (stale >= 0 && flock(stale, LOCK_EX | LOCK_NB) == 0)
+            unlink(tempname.c_str());
+        if (stale >= 0)
+            ::close(stale);
+
+        temp = ::open(tempname.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    }
+    if (temp < 0)
+    {
+        cerr << "ERROR: SlotFile: can't create '" << tempname << "'" << endl;
+        return -1;
+    }
+
+    // Allocate the blocks now, so that writing to the mapping never has to
+    off_t size = off_t(recordSize) * (slots + 1);
+    uInt32 header[3] = { kFileMagic, recordSize, slots };
+    bool ok = flock(temp, LOCK_EX | LOCK_NB) == 0 && ftruncate(temp, size) == 0 &&
+        pwrite(temp, header, sizeof(header), 0) == ssize_t(sizeof(header));
+    if (ok)
+        posix_fallocate(temp, 0, size);
+
+    // Keep the records of a file laid out for smaller states; each of
+    // them fits into the larger record as it is
+    if (ok && oldRecordSize > 0)
+    {
+        cerr << "SlotFile: growing records of '" << filename << "' from "
+             << oldRecordSize << " to " << recordSize << " bytes" << endl;
+
+        BytePtr record = make_ptr<uInt8[]>(oldRecordSize);
+        for (uInt32 slot = 0; slot < slots && ok; ++slot)
+        {
+            ok = pread(fd, record.get(), oldRecordSize, off_t(slot + 1) * oldRecordSize) ==
+                     ssize_t(oldRecordSize) &&
+                 pwrite(temp, record.get(), oldRecordSize, off_t(slot + 1) * recordSize) ==
+                     ssize_t(oldRecordSize);
+        }
+    }
+
+    if (!ok || fsync(temp) != 0 || rename(tempname.c_str(), filename.c_str()) != 0)
+    {
+        cerr << "ERROR: SlotFile: can't write '" << filename << "'" << endl;
+        ::close(temp);
+        unlink(tempname.c_str());
+        return -1;
+    }
+
+    return temp;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SlotFile::close()
+{
+    if (myFlushThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> guard(mySignalLock);
+            myQuit = true;
+        }
+        mySignal.notify_one();
+        myFlushThread.join();
+    }
+
+    if (myMapping != nullptr)
+    {
+        munmap(myMapping, myMappingSize);
+        myMapping = nullptr;
+    }
+    if (myFile >= 0)
+    {
+        ::close(myFile);
+        myFile = -1;
+    }
+
+    myFilename = EmptyString;
+    myMappingSize = myRecordSize = mySlots = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 SlotFile::capacity() const
+{
+    return myRecordSize > 0 ? myRecordSize - uInt32(sizeof(Record)) : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SlotFile::write(uInt32 slot, const uInt8* data, uInt32 size)
+{
+    if (myMapping == nullptr || slot >= mySlots || size > capacity())
+        return false;
+
+    // The record stays invalid until everything is in place
+    Record* r = record(slot);
+    r->magic = 0;
+    memcpy(r + 1, data, size);
+    r->size = size;
+    r->checksum = checksum(data, size);
+    r->magic = kRecordMagic;
+
+    myDirty |= 1u << slot;
+    {
+        std::lock_guard<std::mutex> guard(mySignalLock);
+    }
+    mySignal.notify_one();
+
+    return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SlotFile::read(uInt32 slot, const uInt8*& data, uInt32& size) const
+{
+    if (myMapping == nullptr || slot >= mySlots)
+        return false;
+
+    const Record* r = record(slot);
+    if (r->magic != kRecordMagic || r->size > capacity())
+        return false;
+
+    data = reinterpret_cast<const uInt8*>(r + 1);
+    size = r->size;
+
+    return r->checksum == checksum(data, size);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 SlotFile::checksum(const uInt8* data, uInt32 size)
+{
+    uInt32 hash = 2166136261u;
+    for (uInt32 i = 0; i < size; ++i)
+        hash = (hash ^ data[i]) * 16777619u;
+
+    return hash;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SlotFile::run()
+{
+    for (;;)
+    {
+        bool quit;
+        {
+            std::unique_lock<std::mutex> guard(mySignalLock);
+            mySignal.wait(guard, [this] { return myQuit || myDirty != 0; });
+            quit = myQuit;
+        }
+
+        // Records written again meanwhile are simply flushed once more
+        uInt32 dirty = myDirty.exchange(0);
+        for (uInt32 slot = 0; slot < mySlots; ++slot)
+        {
+            if (dirty & (1u << slot))
+                msync(record(slot), myRecordSize, MS_SYNC);
+        }
+
+        if (quit)
+            break;
+    }
+}
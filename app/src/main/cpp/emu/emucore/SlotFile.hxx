@@ -0,0 +1,151 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef SLOT_FILE_HXX
+#define SLOT_FILE_HXX
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "bspf.hxx"
+
+/**
+  This class keeps the state save slots of one ROM in a single
+  memory-mapped file.
+
+  The file holds a fixed number of records of the same size, each a
+  whole number of pages.  Writing a slot only copies the data into the
+  mapping; the records written are flushed to disk by a background
+  thread, so saving never waits for the disk.  Reading returns a pointer
+  straight into the mapping.
+
+  Every record carries the size and a checksum of its data, so that a
+  record torn by a crash in the middle of a flush reads as empty.
+*/
+class SlotFile
+{
+    public:
+    SlotFile();
+    ~SlotFile();
+
+    public:
+      /**
+        Map the given file, creating it if needed.  An existing file with
+        records too small for 'dataSize' bytes is rewritten with larger
+        records, keeping the slots it holds.  A file which isn't a slot
+        file for this number of slots is never overwritten, and a file
+        mapped by another instance is not opened.
+
+        @param filename  The file to map
+        @param slots     The number of records in the file
+        @param dataSize  The size of the data to be written, or 0 to only
+                         open an existing file
+
+        @return  False if the file could not be mapped
+      */
+    bool open(const string& filename, uInt32 slots, uInt32 dataSize);
+
+    /**
+      Flush all outstanding writes and unmap the file.
+    */
+    void close();
+
+    /**
+      The file currently mapped (empty if none).
+    */
+    const string& filename() const { return myFilename; }
+
+    /**
+      Answers the largest data size a record can hold.
+    */
+    uInt32 capacity() const;
+
+    /**
+      Copy the data into the given slot, and have it flushed in the
+      background.
+
+      @return  False if the slot doesn't exist or the data doesn't fit
+    */
+    bool write(uInt32 slot, const uInt8* data, uInt32 size);
+
+    /**
+      Get the data of the given slot.  The pointer is valid until the
+      slot is written, or the file is closed.
+
+      @return  False if the slot is empty or damaged
+    */
+    bool read(uInt32 slot, const uInt8*& data, uInt32& size) const;
+
+    private:
+    struct Record {
+        uInt32 magic;
+        uInt32 size;
+        uInt32 checksum;
+        uInt32 reserved;
+    };
+
+    enum : uInt32 {
+        kFileMagic = 0x534c4f54,    // 'SLOT'
+        kRecordMagic = 0x53544154,  // 'STAT'
+        kMaxSlots = 32
+    };
+
+    Record* record(uInt32 slot) const {
+        return reinterpret_cast<Record*>(myMapping + (slot + 1) * myRecordSize);
+    }
+
+    // Lay out a new file with the given record size next to 'filename',
+    // copy the records of 'fd' (if any) and rename it into place.  Answers
+    // the locked descriptor of the new file, or -1.
+    static int rebuild(const string& filename, int fd, uInt32 slots,
+                       uInt32 oldRecordSize, uInt32 recordSize);
+
+    // Checksum of the record data (32 bit FNV-1a)
+    static uInt32 checksum(const uInt8* data, uInt32 size);
+
+    // Flush the dirty records, until told to quit
+    void run();
+
+    private:
+      // Name, descriptor and mapping of the file; the first page holds
+      // the file header, followed by the records
+    string myFilename;
+    int myFile;
+    uInt8* myMapping;
+    uInt32 myMappingSize;
+    uInt32 myRecordSize;
+    uInt32 mySlots;
+
+    // One bit for each record waiting to be flushed
+    std::atomic<uInt32> myDirty;
+
+    std::thread myFlushThread;
+    std::mutex mySignalLock;
+    std::condition_variable mySignal;
+    bool myQuit;
+
+    private:
+      // Following constructors and assignment operators not supported
+    SlotFile(const SlotFile&) = delete;
+    SlotFile(SlotFile&&) = delete;
+    SlotFile& operator=(const SlotFile&) = delete;
+    SlotFile& operator=(SlotFile&&) = delete;
+};
+
+#endif
@@ -125,6 +125,35 @@ class Sound : public Serializable
 
         virtual void update(uint8_t* buffer, int bufferLen) = 0;
 
+        /**
+          Sets the format of the generated samples.  The change takes effect
+          with the next fragment.
+
+          @param sampleRate   Output frequency in Hz
+          @param numChannels  Number of interleaved output channels (1 or 2)
+          @param numBits      16 for signed 16-bit, 32 for 32-bit float samples
+          @return  True if the format is supported
+        */
+        virtual bool setFormat(int sampleRate, int numChannels, int numBits) { return false; }
+
+        /**
+          Start/stop recording the generated samples to a file.
+
+          @param filename  The file to write to
+          @param raw       Write headerless PCM instead of a WAV file
+          @return  True if the capture was started
+        */
+        virtual bool startCapture(const string& filename, bool raw) { return false; }
+        virtual void stopCapture() { }
+
+        /**
+          Discard all register writes, for frames which are emulated but
+          not meant to be heard (i.e. when rewinding).
+
+          @param state  Discard writes if true, queue them again if false
+        */
+        virtual void suppressWrites(bool state) { }
+
     protected:
           // The OSystem for this sound object
         OSystem& myOSystem;
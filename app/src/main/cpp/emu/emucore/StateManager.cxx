@@ -27,17 +27,34 @@
 #include "Switches.hxx"
 #include "System.hxx"
 #include "Serializable.hxx"
+#include "Sound.hxx"
+#include "TIA.hxx"
+#include "M6532.hxx"
+#include "Event.hxx"
+#include "EventHandler.hxx"
+#include "Random.hxx"
+#include "MD5.hxx"
 
 #include "StateManager.hxx"
 
-#define STATE_HEADER "03090100state"
-#define MOVIE_HEADER "03030000movie"
+#define STATE_HEADER "03090104state"
+#define MOVIE_HEADER "03090103movie"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 StateManager::StateManager(OSystem& osystem)
     : myOSystem(osystem),
     myCurrentSlot(0),
-    myActiveMode(kOffMode)
+    myActiveMode(kOffMode),
+    myRewindManager(osystem),
+    myNetplayManager(osystem),
+    myNetplayWaiting(false),
+    myStateSize(0),
+    myMovieSeed(0),
+    myMovieFrames(0),
+    myMovieWord(0),
+    myMovieRun(0),
+    myMovieRecord(0),
+    myReplayTicks(0)
 {
     reset();
 }
@@ -45,118 +62,207 @@ StateManager::StateManager(OSystem& osystem)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool StateManager::toggleRecordMode()
 {
-#if 0
     if (myActiveMode != kMovieRecordMode)  // Turn on movie record mode
     {
-        myActiveMode = kOffMode;
-
-        string moviefile = /*myOSystem.baseDir() +*/ "test.inp";
-        if (myMovieWriter.isOpen())
-            myMovieWriter.close();
-        if (!myMovieWriter.open(moviefile))
+        if (!myOSystem.hasConsole() || myActiveMode == kMoviePlaybackMode ||
+            myActiveMode == kNetplayMode)
             return false;
 
-          // Prepend the ROM md5 so this state file only works with that ROM
-        myMovieWriter.putString(myOSystem.console().properties().get(Cartridge_MD5));
-
-        if (!myOSystem.console().save(myMovieWriter))
+        myMovieState.reset();
+        if (!myOSystem.console().save(myMovieState))
             return false;
 
-          // Save controller types for this ROM
-          // We need to check this, since some controllers save more state than
-          // normal, and those states files wouldn't be compatible with normal
-          // controllers.
-        myMovieWriter.putString(
-            myOSystem.console().controller(Controller::Left).name());
-        myMovieWriter.putString(
-            myOSystem.console().controller(Controller::Right).name());
+        myMovieSeed = myOSystem.random().seed();
+        myMovieInput.clear();
+        myMovieDigest = myMovieResult = EmptyString;
+        myMovieFrames = myMovieRun = 0;
 
-          // If we get this far, we're really in movie record mode
         myActiveMode = kMovieRecordMode;
     }
     else  // Turn off movie record mode
     {
-        myActiveMode = kOffMode;
-        myMovieWriter.close();
-        return false;
+        if (myMovieRun > 0)
+            myMovieInput.push_back(myMovieWord | ((myMovieRun - 1) << kMovieInputBits));
+
+        myMovieDigest = stateDigest();
+
+        const string& moviefile = myOSystem.settings().getString("moviefile");
+        if (!saveMovie(moviefile))
+            myOSystem.logMessage("Couldn't save movie to '" + moviefile + "'", 0);
+
+        stopMovie();
     }
 
     return myActiveMode == kMovieRecordMode;
-#endif
-    return false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool StateManager::toggleRewindMode()
+bool StateManager::startPlayback()
 {
-  // FIXME - For now, I'm going to use this to activate movie playback
-#if 0
-  // Close the writer, since we're about to re-open in read mode
-    myMovieWriter.close();
+    if (myActiveMode == kMovieRecordMode || myActiveMode == kNetplayMode ||
+        !loadMovie(myOSystem.settings().getString("moviefile")))
+        return false;
+
+    myActiveMode = kMoviePlaybackMode;
 
-    if (myActiveMode != kMoviePlaybackMode)  // Turn on movie playback mode
+    return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int StateManager::replayMovie()
+{
+    if (myActiveMode == kMovieRecordMode || myActiveMode == kNetplayMode ||
+        !loadMovie(myOSystem.settings().getString("moviefile")))
+        return -1;
+
+    uInt64 startTicks = myOSystem.getTicks();
+
+    Console& console = myOSystem.console();
+    Event& event = myOSystem.eventHandler().event();
+    uInt32 input;
+
+    // Nothing is presented or heard, so there's no need to throttle
+    myOSystem.sound().suppressWrites(true);
+    while (nextMovieInput(input))
     {
-        myActiveMode = kOffMode;
+        unpackInput(input, event);
+        console.riot().update();
+        console.tia().update();
+        ++myMovieFrames;
+    }
+    myOSystem.sound().suppressWrites(false);
 
-        string moviefile = /*myOSystem.baseDir() + */ "test.inp";
-        if (myMovieReader.isOpen())
-            myMovieReader.close();
-        if (!myMovieReader.open(moviefile))
-            return false;
+    myMovieResult = stateDigest() == myMovieDigest ? "match" : "mismatch";
+    myReplayTicks = myOSystem.getTicks() - startTicks;
 
-          // Check the ROM md5
-        if (myMovieReader.getString() !=
-            myOSystem.console().properties().get(Cartridge_MD5))
-            return false;
+    stopMovie();
 
-        if (!myOSystem.console().load(myMovieReader))
-            return false;
+    return int(myMovieFrames);
+}
 
-          // Check controller types
-        const string& left = myMovieReader.getString();
-        const string& right = myMovieReader.getString();
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::startNetplay(int player)
+{
+    if (myActiveMode == kMovieRecordMode || myActiveMode == kMoviePlaybackMode ||
+        !myNetplayManager.start(player))
+        return false;
 
-        if (left != myOSystem.console().controller(Controller::Left).name() ||
-            right != myOSystem.console().controller(Controller::Right).name())
-            return false;
+    // Going back in time is up to the netplay rollback now
+    myRewindManager.clear();
+    myActiveMode = kNetplayMode;
+    myNetplayWaiting = true;
+
+    return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::stopNetplay()
+{
+    if (myActiveMode != kNetplayMode)
+        return;
+
+    myNetplayManager.stop();
+    myNetplayWaiting = false;
+    stopMovie();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::updateInput(Event& event)
+{
+    if (myActiveMode == kNetplayMode)
+    {
+        myNetplayWaiting = !myNetplayManager.update(event);
+        return;
+    }
+
+    if (myActiveMode != kMoviePlaybackMode)
+        return;
 
-          // If we get this far, we're really in movie record mode
-        myActiveMode = kMoviePlaybackMode;
+    uInt32 input;
+    if (nextMovieInput(input))
+    {
+        unpackInput(input, event);
+        ++myMovieFrames;
     }
-    else  // Turn off movie playback mode
+    else
     {
-        myActiveMode = kOffMode;
-        myMovieReader.close();
-        return false;
+        myMovieResult = stateDigest() == myMovieDigest ? "match" : "mismatch";
+        stopMovie();
     }
+}
 
-    return myActiveMode == kMoviePlaybackMode;
-#endif
-    return false;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string StateManager::movieInfo() const
+{
+    ostringstream buf;
+    buf << "mode=" << (myActiveMode == kMovieRecordMode ? "record" :
+                       myActiveMode == kMoviePlaybackMode ? "playback" : "off")
+        << " frames=" << myMovieFrames
+        << " records=" << myMovieInput.size()
+        << " bytes=" << (myMovieState.size() + myMovieInput.size() * 4)
+        << " result=" << (myMovieResult.empty() ? "none" : myMovieResult)
+        << " replayMicros=" << myReplayTicks;
+
+    return buf.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::toggleRewindMode()
+{
+    if (myActiveMode == kRewindPlaybackMode)
+        myActiveMode = kRewindRecordMode;
+    else if (myActiveMode == kRewindRecordMode && myRewindManager.size() > 0)
+        myActiveMode = kRewindPlaybackMode;
+
+    return myActiveMode == kRewindPlaybackMode;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::rewindState()
+{
+    if (myActiveMode != kRewindRecordMode && myActiveMode != kRewindPlaybackMode)
+        return false;
+
+    myActiveMode = kRewindPlaybackMode;
+
+    if (!myRewindManager.rewindState())
+        return false;
+
+    // States are taken at the start of a frame, so emulate that frame to
+    // have something to show; it has been heard already
+    myOSystem.sound().suppressWrites(true);
+    myOSystem.console().tia().update();
+    myOSystem.sound().suppressWrites(false);
+
+    return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::update()
 {
-#if 0
     switch (myActiveMode)
     {
-        case kMovieRecordMode:
-            myOSystem.console().controller(Controller::Left).save(myMovieWriter);
-            myOSystem.console().controller(Controller::Right).save(myMovieWriter);
-            myOSystem.console().switches().save(myMovieWriter);
+        case kRewindRecordMode:
+            myRewindManager.addState();
             break;
 
-        case kMoviePlaybackMode:
-            myOSystem.console().controller(Controller::Left).load(myMovieReader);
-            myOSystem.console().controller(Controller::Right).load(myMovieReader);
-            myOSystem.console().switches().load(myMovieReader);
+        case kMovieRecordMode:
+        {
+            uInt32 input = packInput(myOSystem.eventHandler().event());
+            if (myMovieRun > 0 && (input != myMovieWord || myMovieRun == kMovieMaxRun))
+            {
+                myMovieInput.push_back(myMovieWord | ((myMovieRun - 1) << kMovieInputBits));
+                myMovieRun = 0;
+            }
+            myMovieWord = input;
+            ++myMovieRun;
+            ++myMovieFrames;
             break;
+        }
 
         default:
             break;
     }
-#endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -167,32 +273,29 @@ void StateManager::loadState(int slot)
         if (slot < 0) slot = myCurrentSlot;
 
         ostringstream buf;
-        buf << myOSystem.stateDir()
-            << myOSystem.console().properties().get(Cartridge_Name)
-            << ".st" << slot;
 
-        // Make sure the file can be opened in read-only mode
-        Serializer in(buf.str(), true);
-        if (!in)
+        // Read straight from the mapped slot file
+        const uInt8* data;
+        uInt32 size;
+        if (!openSlotFile(0) || !mySlotFile.read(uInt32(slot), data, size))
         {
-            buf.str("");
             buf << "Can't open/load from state file " << slot;
             myOSystem.showMessage(buf.str());
             return;
         }
+        mySnapshot.setData(data, size);
 
         // First test if we have a valid header
         // If so, do a complete state load using the Console
-        buf.str("");
         try
         {
-            if (in.getString() != STATE_HEADER)
+            if (mySnapshot.getString() != STATE_HEADER)
                 buf << "Incompatible state " << slot << " file";
-            else if (in.getString() != myOSystem.console().cartridge().name())
+            else if (mySnapshot.getString() != myOSystem.console().cartridge().name())
                 buf << "State " << slot << " file doesn't match current ROM";
             else
             {
-                if (myOSystem.console().load(in))
+                if (myOSystem.console().load(mySnapshot))
                     buf << "State " << slot << " loaded";
                 else
                     buf << "Invalid data in state " << slot << " file";
@@ -215,49 +318,31 @@ void StateManager::saveState(int slot)
         if (slot < 0) slot = myCurrentSlot;
 
         ostringstream buf;
-        buf << myOSystem.stateDir()
-            << myOSystem.console().properties().get(Cartridge_Name)
-            << ".st" << slot;
 
-        // Make sure the file can be opened for writing
-        Serializer out(buf.str());
-        if (!out)
+        // Save into the arena, then copy into the mapped slot file; the
+        // disk is written in the background
+        mySnapshot.reset();
+        if (!saveState(mySnapshot))
         {
-            buf.str("");
-            buf << "Can't open/save to state file " << slot;
+            buf << "Error saving state " << slot;
             myOSystem.showMessage(buf.str());
             return;
         }
 
-        try
+        if (!openSlotFile(mySnapshot.size()) ||
+            !mySlotFile.write(uInt32(slot), mySnapshot.data(), mySnapshot.size()))
         {
-          // Add header so that if the state format changes in the future,
-          // we'll know right away, without having to parse the rest of the file
-            out.putString(STATE_HEADER);
-
-            // Sanity check; prepend the cart type/name
-            out.putString(myOSystem.console().cartridge().name());
-        }
-        catch (...)
-        {
-            buf << "Error saving state " << slot;
+            buf << "Can't open/save to state file " << slot;
             myOSystem.showMessage(buf.str());
             return;
         }
 
-        // Do a complete state save using the Console
-        buf.str("");
-        if (myOSystem.console().save(out))
+        buf << "State " << slot << " saved";
+        if (myOSystem.settings().getBool("autoslot"))
         {
-            buf << "State " << slot << " saved";
-            if (myOSystem.settings().getBool("autoslot"))
-            {
-                myCurrentSlot = (slot + 1) % 10;
-                buf << ", switching to slot " << slot;
-            }
+            myCurrentSlot = (slot + 1) % 10;
+            buf << ", switching to slot " << slot;
         }
-        else
-            buf << "Error saving state " << slot;
 
         myOSystem.showMessage(buf.str());
     }
@@ -329,25 +414,251 @@ bool StateManager::saveState(Serializer& out)
     return false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 StateManager::storeState(uInt8* buffer, uInt32 size)
+{
+    uInt32 required = stateSize();
+    if (buffer == nullptr || required == 0 || required > size)
+        return required;
+
+    Serializer out(buffer, size);
+    if (!saveState(out))
+        return 0;
+
+    return out.size();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 StateManager::stateSize()
+{
+    if (myStateSize == 0)
+    {
+        mySnapshot.reset();
+        if (saveState(mySnapshot))
+            myStateSize = mySnapshot.size();
+    }
+
+    return myStateSize;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::restoreState(const uInt8* data, uInt32 size)
+{
+    if (data == nullptr || size == 0)
+        return false;
+
+    mySnapshot.setData(data, size);
+
+    return loadState(mySnapshot);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::reset()
 {
-#if 0
-    myCurrentSlot = 0;
+    myNetplayManager.close();
+    myNetplayWaiting = false;
 
-    switch (myActiveMode)
+    myRewindManager.setup();
+    myActiveMode = myRewindManager.enabled() ? kRewindRecordMode : kOffMode;
+    myStateSize = 0;
+
+    // The slot file is opened by the first slot load/save of the console
+    mySlotFile.close();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::openSlotFile(uInt32 size)
+{
+    // Instances without a frontend never touch the slots of the user
+    if (myOSystem.headless())
+        return false;
+
+    ostringstream buf;
+    buf << myOSystem.stateDir()
+        << myOSystem.console().properties().get(Cartridge_Name)
+        << ".slots";
+
+    if (mySlotFile.filename() == buf.str() && mySlotFile.capacity() >= size)
+        return true;
+
+    return mySlotFile.open(buf.str(), 10, size);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::stopMovie()
+{
+    // Release whatever the movie was holding down
+    unpackInput(0, myOSystem.eventHandler().event());
+
+    myRewindManager.clear();
+    myActiveMode = myRewindManager.enabled() ? kRewindRecordMode : kOffMode;
+
+    restoreSeed();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::restoreSeed()
+{
+    myOSystem.random().setSeed(uInt32(myOSystem.settings().getInt("seed")));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::saveMovie(const string& filename)
+{
+    if (filename.empty())
+        return false;
+
+    Serializer out(filename);
+    if (!out)
+        return false;
+
+    try
     {
-        case kMovieRecordMode:
-            myMovieWriter.close();
-            break;
+        out.putString(MOVIE_HEADER);
 
-        case kMoviePlaybackMode:
-            myMovieReader.close();
-            break;
+        // The movie only works with the ROM it was recorded on
+        out.putString(myOSystem.console().properties().get(Cartridge_MD5));
+        out.putInt(myMovieSeed);
 
-        default:
-            break;
+        out.putInt(myMovieState.size());
+        out.putByteArray(myMovieState.data(), myMovieState.size());
+
+        out.putInt(myMovieFrames);
+        out.putString(myMovieDigest);
+        out.putInt(uInt32(myMovieInput.size()));
+        if (!myMovieInput.empty())
+            out.putIntArray(myMovieInput.data(), uInt32(myMovieInput.size()));
+    }
+    catch (...)
+    {
+        cerr << "ERROR: StateManager::saveMovie" << endl;
+        return false;
+    }
+
+    return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::loadMovie(const string& filename)
+{
+    if (filename.empty() || !myOSystem.hasConsole())
+        return false;
+
+    Serializer in(filename, true);
+    if (!in)
+        return false;
+
+    try
+    {
+        if (in.getString() != MOVIE_HEADER ||
+            in.getString() != myOSystem.console().properties().get(Cartridge_MD5))
+            return false;
+
+        myMovieSeed = in.getInt();
+
+        uInt32 size = in.getInt();
+        BytePtr state = make_ptr<uInt8[]>(size);
+        in.getByteArray(state.get(), size);
+        myMovieState.setData(state.get(), size);
+
+        uInt32 frames = in.getInt();
+        myMovieDigest = in.getString();
+        myMovieInput.resize(in.getInt());
+        if (!myMovieInput.empty())
+            in.getIntArray(myMovieInput.data(), uInt32(myMovieInput.size()));
+
+        // Sanity check; the records must add up to the recorded frames
+        uInt64 total = 0;
+        for (uInt32 record : myMovieInput)
+            total += (record >> kMovieInputBits) + 1;
+        if (total != frames)
+            return false;
+
+        // Restoring the state also restores the random generator; the
+        // seed is needed in case the console gets recreated
+        myOSystem.random().setSeed(myMovieSeed);
+        if (!myOSystem.console().load(myMovieState))
+        {
+            restoreSeed();
+            return false;
+        }
+
+        myMovieResult = EmptyString;
+        myMovieFrames = myMovieRun = myMovieRecord = 0;
+    }
+    catch (...)
+    {
+        cerr << "ERROR: StateManager::loadMovie" << endl;
+        return false;
     }
-    myActiveMode = kOffMode;
-#endif
+
+    return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::nextMovieInput(uInt32& input)
+{
+    if (myMovieRun == 0)
+    {
+        if (myMovieRecord >= myMovieInput.size())
+            return false;
+
+        uInt32 record = myMovieInput[myMovieRecord++];
+        myMovieWord = record & kMovieInputMask;
+        myMovieRun = (record >> kMovieInputBits) + 1;
+    }
+
+    --myMovieRun;
+    input = myMovieWord;
+
+    return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string StateManager::stateDigest()
+{
+    Serializer state;
+    if (!myOSystem.console().save(state))
+        return EmptyString;
+
+    return MD5::hash(state.data(), state.size());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// The events making up the input word, one bit each
+static const Event::Type ourMovieEvents[] = {
+    Event::JoystickZeroUp, Event::JoystickZeroDown,
+    Event::JoystickZeroLeft, Event::JoystickZeroRight, Event::JoystickZeroFire,
+    Event::JoystickOneUp, Event::JoystickOneDown,
+    Event::JoystickOneLeft, Event::JoystickOneRight, Event::JoystickOneFire,
+    Event::ConsoleSelect, Event::ConsoleReset,
+    Event::ConsoleColor, Event::ConsoleBlackWhite,
+    Event::ConsoleLeftDiffA, Event::ConsoleLeftDiffB,
+    Event::ConsoleRightDiffA, Event::ConsoleRightDiffB
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 StateManager::packInput(const Event& event)
+{
+    static_assert(sizeof(ourMovieEvents) / sizeof(ourMovieEvents[0]) <= kMovieInputBits,
+                  "Movie input word too small");
+    static_assert((kInputLeftJoystick | kInputRightJoystick | kInputSwitches) ==
+                  (1u << sizeof(ourMovieEvents) / sizeof(ourMovieEvents[0])) - 1,
+                  "Input word players don't match the events");
+
+    uInt32 input = 0;
+    for (uInt32 i = 0; i < sizeof(ourMovieEvents) / sizeof(ourMovieEvents[0]); ++i)
+    {
+        if (event.get(ourMovieEvents[i]) != 0)
+            input |= 1 << i;
+    }
+
+    return input;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::unpackInput(uInt32 input, Event& event)
+{
+    for (uInt32 i = 0; i < sizeof(ourMovieEvents) / sizeof(ourMovieEvents[0]); ++i)
+        event.set(ourMovieEvents[i], (input >> i) & 1);
 }
@@ -20,9 +20,15 @@
 #ifndef STATE_MANAGER_HXX
 #define STATE_MANAGER_HXX
 
+#include <vector>
+
 class OSystem;
+class Event;
 
 #include "Serializer.hxx"
+#include "RewindManager.hxx"
+#include "NetplayManager.hxx"
+#include "SlotFile.hxx"
 
 /**
   This class provides an interface to all things related to emulation state.
@@ -46,23 +52,125 @@ class StateManager
       */
     bool isActive() const { return myActiveMode != kOffMode; }
 
+    /**
+      Answers whether emulation is halted on a rewound state
+    */
+    bool isRewinding() const { return myActiveMode == kRewindPlaybackMode; }
+
+    /**
+      Answers whether the coming frame must not be emulated, because
+      emulation is halted on a rewound state or waits for the netplay peer
+    */
+    bool isHalted() const { return isRewinding() || myNetplayWaiting; }
+
+    /**
+      Answers whether the input is taken once per frame (a movie being
+      recorded or played back, netplay), so it must not change within one
+    */
+    bool takesFrameInput() const {
+        return myActiveMode == kMovieRecordMode ||
+               myActiveMode == kMoviePlaybackMode || myActiveMode == kNetplayMode;
+    }
+
+    /**
+      Start recording a movie of the current console, or stop recording
+      and write it to the 'moviefile'.  A movie consists of the initial
+      state and seed, followed by the input of every frame.
+
+      @return  True if movie record mode is now active
+    */
     bool toggleRecordMode();
+
+    /**
+      Start playing back the movie in the 'moviefile' in real time.
+
+      @return  False if the movie could not be loaded
+    */
+    bool startPlayback();
+
+    /**
+      Replay the movie in the 'moviefile' as fast as possible and without
+      sound, and check the resulting state against the recorded one.
+      Emulation continues from the end of the movie.
+
+      @return  The number of frames replayed, or -1 if the movie could not
+               be loaded
+    */
+    int replayMovie();
+
+    /**
+      Start netplay with the peer from the 'netpeer' setting; rewinding
+      and movies are off while it is running.
+
+      @param player  0 to play as the host, 1 as the guest
+
+      @return  False if the connection could not be set up
+    */
+    bool startNetplay(int player);
+
+    /**
+      Stop netplay, once the state is in sync with the peer.
+    */
+    void stopNetplay();
+
+    /**
+      The netplay connection
+    */
+    const NetplayManager& netplayManager() const { return myNetplayManager; }
+
+    /**
+      Replace the input of the coming frame with the one from the movie
+      being played back, or with the local and remote netplay input.
+      This must be called before the input reaches the controllers.
+
+      @param event  The event object the controllers read
+    */
+    void updateInput(Event& event);
+
+    /**
+      Answers a description of the movie being recorded or played back.
+    */
+    string movieInfo() const;
+
+    /**
+      Leave rewind playback and continue emulating (and recording) from
+      the rewound state, or halt emulation to step back through the
+      recorded states.
+
+      @return  True if rewind playback mode is now active
+    */
     bool toggleRewindMode();
 
+    /**
+      Step back one recorded state, entering rewind playback mode.
+      The frame following the state is emulated silently, so that the
+      framebuffer shows it.
+
+      @return  False if there is no older state
+    */
+    bool rewindState();
+
+    /**
+      The rewind history of the current console
+    */
+    RewindManager& rewindManager() { return myRewindManager; }
+
     /**
       Updates the state of the system based on the currently active mode
     */
     void update();
 
     /**
-      Load a state into the current system
+      Load a state into the current system.  The ten slots of a ROM are
+      kept in one memory-mapped file in the state directory.
 
       @param slot  The state 'slot' to load state from
     */
     void loadState(int slot = -1);
 
     /**
-      Save the current state from the system
+      Save the current state from the system.  Only memory is written
+      here; the slot file is flushed to disk in the background.
 
       @param slot  The state 'slot' to save into
     */
@@ -93,24 +201,103 @@ class StateManager
     */
     bool saveState(Serializer& out);
 
+    /**
+      Save the current state into a buffer owned by the caller, e.g. for
+      save slots or suspend snapshots kept in memory by the frontend.
+      The state is prefixed with the state header and the cart type, so
+      its size stays the same for all states of one cart type.
+
+      The state is serialized straight into the buffer, in one pass.
+
+      @param buffer  The buffer to save into, or the null pointer to
+                     query the size only
+      @param size    The size of the buffer
+
+      @return  The size of the state (nothing is written if it exceeds
+               'size'), or 0 on any save errors
+    */
+    uInt32 storeState(uInt8* buffer, uInt32 size);
+
+    /**
+      Answers the size of a state of the current cart, as stored by
+      storeState().  It is measured once per console.
+
+      @return  The size of the state, or 0 on any save errors
+    */
+    uInt32 stateSize();
+
+    /**
+      Load a state previously saved with storeState().
+
+      @param data  The saved state
+      @param size  The size of the saved state
+
+      @return  False on any load errors, else true
+    */
+    bool restoreState(const uInt8* data, uInt32 size);
+
     /**
       Resets manager to defaults
     */
     void reset();
 
+    /**
+      Map the input word (as recorded in movies and exchanged in netplay)
+      to and from the event object
+    */
+    static uInt32 packInput(const Event& event);
+    static void unpackInput(uInt32 input, Event& event);
+
+    // The bits of the input word belonging to each player
+    enum : uInt32 {
+        kInputLeftJoystick  = 0x0001f,
+        kInputRightJoystick = 0x003e0,
+        kInputSwitches      = 0x3fc00
+    };
+
     private:
     enum Mode {
         kOffMode,
         kMoviePlaybackMode,
         kMovieRecordMode,
         kRewindPlaybackMode,
-        kRewindRecordMode
+        kRewindRecordMode,
+        kNetplayMode
     };
 
     enum {
         kVersion = 001
     };
 
+    // Movie input records: the input word in the low bits, and the number
+    // of frames it was held for (minus one) in the high bits
+    enum : uInt32 {
+        kMovieInputBits = 18,
+        kMovieInputMask = (1 << kMovieInputBits) - 1,
+        kMovieMaxRun = 1 << (32 - kMovieInputBits)
+    };
+
+    // Write/read the current movie to/from the given file
+    bool saveMovie(const string& filename);
+    bool loadMovie(const string& filename);
+
+    // Get the input word of the next frame of the movie being played back
+    bool nextMovieInput(uInt32& input);
+
+    // Digest of the current console state, used to verify a replay
+    string stateDigest();
+
+    // Map the slot file of the current ROM, with room for 'size' bytes
+    // per slot (0 to only open an existing file); never for headless
+    // instances
+    bool openSlotFile(uInt32 size);
+
+    // Back to rewinding (if enabled) after a movie or netplay is finished
+    void stopMovie();
+
+    // Back to the seed from the settings, after a movie has used its own
+    void restoreSeed();
+
     // The parent OSystem object
     OSystem& myOSystem;
 
@@ -123,9 +310,42 @@ class StateManager
     // MD5 of the currently active ROM (either in movie or rewind mode)
     string myMD5;
 
-    // Serializer classes used to save/load the eventstream
-    Serializer myMovieWriter;
-    Serializer myMovieReader;
+    // History of states used for rewinding
+    RewindManager myRewindManager;
+
+    // Netplay connection, and whether the coming frame waits for it
+    NetplayManager myNetplayManager;
+    bool myNetplayWaiting;
+
+    // Save slots of the current ROM
+    SlotFile mySlotFile;
+
+    // Arena states are stored from/restored into
+    Serializer mySnapshot;
+
+    // Size of a state of the current cart (0 until measured)
+    uInt32 myStateSize;
+
+    // Initial state and seed of the movie being recorded or played back
+    Serializer myMovieState;
+    uInt32 myMovieSeed;
+
+    // Packed input records of the movie, and the digest of its final state
+    std::vector<uInt32> myMovieInput;
+    string myMovieDigest;
+
+    // Number of frames recorded or played back so far
+    uInt32 myMovieFrames;
+
+    // The input being recorded/played back, the frames left to record it
+    // for/play it back, and the next record to play back
+    uInt32 myMovieWord;
+    uInt32 myMovieRun;
+    uInt32 myMovieRecord;
+
+    // Outcome and duration of the last check against the recorded state
+    string myMovieResult;
+    uInt64 myReplayTicks;
 
     private:
       // Following constructors and assignment operators not supported
@@ -31,6 +31,7 @@
 System::System(const OSystem& osystem, M6502& m6502, M6532& m6532,
     TIA& mTIA, Cartridge& mCart)
     : myOSystem(osystem),
+    myRandom(osystem),
     myM6502(m6502),
     myM6532(m6532),
     myTIA(mTIA),
@@ -40,8 +41,8 @@ System::System(const OSystem& osystem, M6502& m6502, M6532& m6532,
     myDataBusLocked(false),
     mySystemInAutodetect(false)
 {
-  // Re-initialize random generator
-    randGenerator().initSeed();
+  // Initialize random generator, using the fixed seed (if any)
+    myRandom.setSeed(osystem.random().seed());
 
     // Initialize page access table
     PageAccess access(&myNullDevice, System::PA_READ);
@@ -207,6 +208,8 @@ bool System::save(Serializer& out) const
         out.putByte(myDataBusState);
 
         // Save the state of each device
+        if (!randGenerator().save(out))
+            return false;
         if (!myM6502.save(out))
             return false;
         if (!myM6532.save(out))
@@ -237,6 +240,8 @@ bool System::load(Serializer& in)
         myDataBusState = in.getByte();
 
         // Load the state of each device
+        if (!randGenerator().load(in))
+            return false;
         if (!myM6502.load(in))
             return false;
         if (!myM6532.load(in))
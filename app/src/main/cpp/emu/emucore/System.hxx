@@ -116,7 +116,7 @@ class System : public Serializable
 
       @return The random generator
     */
-    Random& randGenerator() const { return myOSystem.random(); }
+    Random& randGenerator() const { return myRandom; }
 
     /**
       Get the null device associated with the system.  Every system
@@ -382,6 +382,10 @@ class System : public Serializable
     private:
     const OSystem& myOSystem;
 
+    // Random generator of this system; every system has its own, so that
+    // consoles cloned from each other don't affect each other's numbers
+    mutable Random myRandom;
+
     // 6502 processor attached to the system
     M6502& myM6502;
 
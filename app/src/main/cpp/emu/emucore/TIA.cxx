@@ -48,8 +48,8 @@ TIA::TIA(Console& console, Sound& sound, Settings& settings)
     myStartScanline(0)
 {
   // Allocate buffers for two frame buffers
-    myCurrentFrameBuffer = make_ptr<uInt8[]>(160 * 320);
-    myPreviousFrameBuffer = make_ptr<uInt8[]>(160 * 320);
+    myCurrentFrameBuffer = ConsoleArena::createBytes(console.arena(), "frames", 160 * 320);
+    myPreviousFrameBuffer = ConsoleArena::createBytes(console.arena(), "frames", 160 * 320);
 
     // Compute all of the mask tables
     TIATables::computeAllTables();
@@ -248,96 +248,105 @@ void TIA::install(System& system, Device& device)
             mySystem->setPageAccess(i >> System::S_PAGE_SHIFT, access);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Layout of TIA::State: 23 ints, 6 shorts, 47 bytes and 1 byte padding
+static constexpr Serializer::Layout StateLayout = {
+    Serializer::makeTag('T', 'I', 'A', 1), 23, 6, 48
+};
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool TIA::save(Serializer& out) const
 {
-    const string& device = name();
+    static_assert(sizeof(State) == StateLayout.size(), "TIA::State layout");
 
     try
     {
-        out.putString(device);
-
-        out.putInt(myClockWhenFrameStarted);
-        out.putInt(myClockStartDisplay);
-        out.putInt(myClockStopDisplay);
-        out.putInt(myClockAtLastUpdate);
-        out.putInt(myClocksToEndOfScanLine);
-        out.putInt(myScanlineCountForLastFrame);
-        out.putInt(myVSYNCFinishClock);
-
-        out.putByte(myEnabledObjects);
-        out.putByte(myDisabledObjects);
-
-        out.putByte(myVSYNC);
-        out.putByte(myVBLANK);
-        out.putByte(myNUSIZ0);
-        out.putByte(myNUSIZ1);
-
-        out.putByteArray(myColor, 8);
-
-        out.putByte(myCTRLPF);
-        out.putByte(myPlayfieldPriorityAndScore);
-        out.putBool(myREFP0);
-        out.putBool(myREFP1);
-        out.putInt(myPF);
-        out.putByte(myGRP0);
-        out.putByte(myGRP1);
-        out.putByte(myDGRP0);
-        out.putByte(myDGRP1);
-        out.putBool(myENAM0);
-        out.putBool(myENAM1);
-        out.putBool(myENABL);
-        out.putBool(myDENABL);
-        out.putByte(myHMP0);
-        out.putByte(myHMP1);
-        out.putByte(myHMM0);
-        out.putByte(myHMM1);
-        out.putByte(myHMBL);
-        out.putBool(myVDELP0);
-        out.putBool(myVDELP1);
-        out.putBool(myVDELBL);
-        out.putBool(myRESMP0);
-        out.putBool(myRESMP1);
-        out.putShort(myCollision);
-        out.putInt(myCollisionEnabledMask);
-        out.putByte(myCurrentGRP0);
-        out.putByte(myCurrentGRP1);
-
-        out.putBool(myDumpEnabled);
-        out.putInt(myDumpDisabledCycle);
-
-        out.putShort(myPOSP0);
-        out.putShort(myPOSP1);
-        out.putShort(myPOSM0);
-        out.putShort(myPOSM1);
-        out.putShort(myPOSBL);
-
-        out.putInt(myMotionClockP0);
-        out.putInt(myMotionClockP1);
-        out.putInt(myMotionClockM0);
-        out.putInt(myMotionClockM1);
-        out.putInt(myMotionClockBL);
-
-        out.putInt(myStartP0);
-        out.putInt(myStartP1);
-        out.putInt(myStartM0);
-        out.putInt(myStartM1);
-
-        out.putByte(mySuppressP0);
-        out.putByte(mySuppressP1);
-
-        out.putBool(myHMP0mmr);
-        out.putBool(myHMP1mmr);
-        out.putBool(myHMM0mmr);
-        out.putBool(myHMM1mmr);
-        out.putBool(myHMBLmmr);
-
-        out.putInt(myCurrentHMOVEPos);
-        out.putInt(myPreviousHMOVEPos);
-        out.putBool(myHMOVEBlankEnabled);
-
-        out.putInt(myFrameCounter);
-        out.putInt(myPALFrameCounter);
+        State state;
+
+        state.clockWhenFrameStarted = myClockWhenFrameStarted;
+        state.clockStartDisplay = myClockStartDisplay;
+        state.clockStopDisplay = myClockStopDisplay;
+        state.clockAtLastUpdate = myClockAtLastUpdate;
+        state.clocksToEndOfScanLine = myClocksToEndOfScanLine;
+        state.scanlineCountForLastFrame = myScanlineCountForLastFrame;
+        state.VSYNCFinishClock = myVSYNCFinishClock;
+
+        state.enabledObjects = myEnabledObjects;
+        state.disabledObjects = myDisabledObjects;
+
+        state.VSYNC = myVSYNC;
+        state.VBLANK = myVBLANK;
+        state.NUSIZ0 = myNUSIZ0;
+        state.NUSIZ1 = myNUSIZ1;
+
+        memcpy(state.color, myColor, 8);
+
+        state.CTRLPF = myCTRLPF;
+        state.playfieldPriorityAndScore = myPlayfieldPriorityAndScore;
+        state.REFP0 = myREFP0;
+        state.REFP1 = myREFP1;
+        state.PF = myPF;
+        state.GRP0 = myGRP0;
+        state.GRP1 = myGRP1;
+        state.DGRP0 = myDGRP0;
+        state.DGRP1 = myDGRP1;
+        state.ENAM0 = myENAM0;
+        state.ENAM1 = myENAM1;
+        state.ENABL = myENABL;
+        state.DENABL = myDENABL;
+        state.HMP0 = myHMP0;
+        state.HMP1 = myHMP1;
+        state.HMM0 = myHMM0;
+        state.HMM1 = myHMM1;
+        state.HMBL = myHMBL;
+        state.VDELP0 = myVDELP0;
+        state.VDELP1 = myVDELP1;
+        state.VDELBL = myVDELBL;
+        state.RESMP0 = myRESMP0;
+        state.RESMP1 = myRESMP1;
+        state.collision = myCollision;
+        state.collisionEnabledMask = myCollisionEnabledMask;
+        state.currentGRP0 = myCurrentGRP0;
+        state.currentGRP1 = myCurrentGRP1;
+
+        state.dumpEnabled = myDumpEnabled;
+        state.dumpDisabledCycle = myDumpDisabledCycle;
+
+        state.POSP0 = myPOSP0;
+        state.POSP1 = myPOSP1;
+        state.POSM0 = myPOSM0;
+        state.POSM1 = myPOSM1;
+        state.POSBL = myPOSBL;
+
+        state.motionClockP0 = myMotionClockP0;
+        state.motionClockP1 = myMotionClockP1;
+        state.motionClockM0 = myMotionClockM0;
+        state.motionClockM1 = myMotionClockM1;
+        state.motionClockBL = myMotionClockBL;
+
+        state.startP0 = myStartP0;
+        state.startP1 = myStartP1;
+        state.startM0 = myStartM0;
+        state.startM1 = myStartM1;
+
+        state.suppressP0 = mySuppressP0;
+        state.suppressP1 = mySuppressP1;
+
+        state.HMP0mmr = myHMP0mmr;
+        state.HMP1mmr = myHMP1mmr;
+        state.HMM0mmr = myHMM0mmr;
+        state.HMM1mmr = myHMM1mmr;
+        state.HMBLmmr = myHMBLmmr;
+
+        state.currentHMOVEPos = myCurrentHMOVEPos;
+        state.previousHMOVEPos = myPreviousHMOVEPos;
+        state.HMOVEBlankEnabled = myHMOVEBlankEnabled;
+
+        state.frameCounter = myFrameCounter;
+        state.PALFrameCounter = myPALFrameCounter;
+        state.unused = 0;
+
+        out.putBlock(StateLayout, &state);
 
         // Save the sound sample stuff ...
         mySound.save(out);
@@ -354,102 +363,105 @@ bool TIA::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool TIA::load(Serializer& in)
 {
-    const string& device = name();
-
     try
     {
-        if (in.getString() != device)
+        State state;
+        if (!in.getBlock(StateLayout, &state))
             return false;
 
-        myClockWhenFrameStarted = in.getInt();
-        myClockStartDisplay = in.getInt();
-        myClockStopDisplay = in.getInt();
-        myClockAtLastUpdate = in.getInt();
-        myClocksToEndOfScanLine = in.getInt();
-        myScanlineCountForLastFrame = in.getInt();
-        myVSYNCFinishClock = in.getInt();
-
-        myEnabledObjects = in.getByte();
-        myDisabledObjects = in.getByte();
-
-        myVSYNC = in.getByte();
-        myVBLANK = in.getByte();
-        myNUSIZ0 = in.getByte();
-        myNUSIZ1 = in.getByte();
-
-        in.getByteArray(myColor, 8);
-
-        myCTRLPF = in.getByte();
-        myPlayfieldPriorityAndScore = in.getByte();
-        myREFP0 = in.getBool();
-        myREFP1 = in.getBool();
-        myPF = in.getInt();
-        myGRP0 = in.getByte();
-        myGRP1 = in.getByte();
-        myDGRP0 = in.getByte();
-        myDGRP1 = in.getByte();
-        myENAM0 = in.getBool();
-        myENAM1 = in.getBool();
-        myENABL = in.getBool();
-        myDENABL = in.getBool();
-        myHMP0 = in.getByte();
-        myHMP1 = in.getByte();
-        myHMM0 = in.getByte();
-        myHMM1 = in.getByte();
-        myHMBL = in.getByte();
-        myVDELP0 = in.getBool();
-        myVDELP1 = in.getBool();
-        myVDELBL = in.getBool();
-        myRESMP0 = in.getBool();
-        myRESMP1 = in.getBool();
-        myCollision = in.getShort();
-        myCollisionEnabledMask = in.getInt();
-        myCurrentGRP0 = in.getByte();
-        myCurrentGRP1 = in.getByte();
-
-        myDumpEnabled = in.getBool();
-        myDumpDisabledCycle = in.getInt();
-
-        myPOSP0 = in.getShort();
-        myPOSP1 = in.getShort();
-        myPOSM0 = in.getShort();
-        myPOSM1 = in.getShort();
-        myPOSBL = in.getShort();
-
-        myMotionClockP0 = in.getInt();
-        myMotionClockP1 = in.getInt();
-        myMotionClockM0 = in.getInt();
-        myMotionClockM1 = in.getInt();
-        myMotionClockBL = in.getInt();
-
-        myStartP0 = in.getInt();
-        myStartP1 = in.getInt();
-        myStartM0 = in.getInt();
-        myStartM1 = in.getInt();
-
-        mySuppressP0 = in.getByte();
-        mySuppressP1 = in.getByte();
-
-        myHMP0mmr = in.getBool();
-        myHMP1mmr = in.getBool();
-        myHMM0mmr = in.getBool();
-        myHMM1mmr = in.getBool();
-        myHMBLmmr = in.getBool();
-
-        myCurrentHMOVEPos = in.getInt();
-        myPreviousHMOVEPos = in.getInt();
-        myHMOVEBlankEnabled = in.getBool();
-
-        myFrameCounter = in.getInt();
-        myPALFrameCounter = in.getInt();
+        myClockWhenFrameStarted = state.clockWhenFrameStarted;
+        myClockStartDisplay = state.clockStartDisplay;
+        myClockStopDisplay = state.clockStopDisplay;
+        myClockAtLastUpdate = state.clockAtLastUpdate;
+        myClocksToEndOfScanLine = state.clocksToEndOfScanLine;
+        myScanlineCountForLastFrame = state.scanlineCountForLastFrame;
+        myVSYNCFinishClock = state.VSYNCFinishClock;
+
+        myEnabledObjects = state.enabledObjects;
+        myDisabledObjects = state.disabledObjects;
+
+        myVSYNC = state.VSYNC;
+        myVBLANK = state.VBLANK;
+        myNUSIZ0 = state.NUSIZ0;
+        myNUSIZ1 = state.NUSIZ1;
+
+        memcpy(myColor, state.color, 8);
+
+        myCTRLPF = state.CTRLPF;
+        myPlayfieldPriorityAndScore = state.playfieldPriorityAndScore;
+        myREFP0 = state.REFP0;
+        myREFP1 = state.REFP1;
+        myPF = state.PF;
+        myGRP0 = state.GRP0;
+        myGRP1 = state.GRP1;
+        myDGRP0 = state.DGRP0;
+        myDGRP1 = state.DGRP1;
+        myENAM0 = state.ENAM0;
+        myENAM1 = state.ENAM1;
+        myENABL = state.ENABL;
+        myDENABL = state.DENABL;
+        myHMP0 = state.HMP0;
+        myHMP1 = state.HMP1;
+        myHMM0 = state.HMM0;
+        myHMM1 = state.HMM1;
+        myHMBL = state.HMBL;
+        myVDELP0 = state.VDELP0;
+        myVDELP1 = state.VDELP1;
+        myVDELBL = state.VDELBL;
+        myRESMP0 = state.RESMP0;
+        myRESMP1 = state.RESMP1;
+        myCollision = state.collision;
+        myCollisionEnabledMask = state.collisionEnabledMask;
+        myCurrentGRP0 = state.currentGRP0;
+        myCurrentGRP1 = state.currentGRP1;
+
+        myDumpEnabled = state.dumpEnabled;
+        myDumpDisabledCycle = state.dumpDisabledCycle;
+
+        myPOSP0 = state.POSP0;
+        myPOSP1 = state.POSP1;
+        myPOSM0 = state.POSM0;
+        myPOSM1 = state.POSM1;
+        myPOSBL = state.POSBL;
+
+        myMotionClockP0 = state.motionClockP0;
+        myMotionClockP1 = state.motionClockP1;
+        myMotionClockM0 = state.motionClockM0;
+        myMotionClockM1 = state.motionClockM1;
+        myMotionClockBL = state.motionClockBL;
+
+        myStartP0 = state.startP0;
+        myStartP1 = state.startP1;
+        myStartM0 = state.startM0;
+        myStartM1 = state.startM1;
+
+        mySuppressP0 = state.suppressP0;
+        mySuppressP1 = state.suppressP1;
+
+        myHMP0mmr = state.HMP0mmr;
+        myHMP1mmr = state.HMP1mmr;
+        myHMM0mmr = state.HMM0mmr;
+        myHMM1mmr = state.HMM1mmr;
+        myHMBLmmr = state.HMBLmmr;
+
+        myCurrentHMOVEPos = state.currentHMOVEPos;
+        myPreviousHMOVEPos = state.previousHMOVEPos;
+        myHMOVEBlankEnabled = state.HMOVEBlankEnabled;
+
+        myFrameCounter = state.frameCounter;
+        myPALFrameCounter = state.PALFrameCounter;
 
         // Load the sound sample stuff ...
         mySound.load(in);
 
         // Reset TIA bits to be on
         enableBits(true);
-        toggleFixedColors(0);
         myAllowHMOVEBlanks = true;
+
+        // Only rebuild the priority encoder if fixed colors were on,
+        // it doesn't depend on any of the state loaded
+        if (myColorPtr != myColor)
+            toggleFixedColors(0);
     }
     catch (...)
     {
@@ -526,6 +538,28 @@ void TIA::update()
     endFrame();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIA::updateToCycle(uInt32 cycle)
+{
+    if (!myPartialFrameFlag)
+        startFrame();
+
+    myPartialFrameFlag = true;
+
+    // One instruction at a time, until the cycle or the end of the frame
+    while (myPartialFrameFlag && mySystem->cycles() < cycle)
+    {
+        if (!mySystem->m6502().execute(1))
+            break;
+    }
+
+    if (myPartialFrameFlag)
+        return false;
+
+    endFrame();
+    return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline void TIA::startFrame()
 {
@@ -1452,7 +1486,7 @@ bool TIA::poke(uInt16 addr, uInt8 value)
     // See if this is a poke to a PF register
     if (delay == -1)
     {
-        static uInt32 d[4] = { 4, 5, 2, 3 };
+        static const uInt32 d[4] = { 4, 5, 2, 3 };
         Int32 x = ((clock - myClockWhenFrameStarted) % 228);
         delay = d[(x / 3) & 3];
     }
@@ -1863,43 +1897,51 @@ bool TIA::poke(uInt16 addr, uInt8 value)
 
         case AUDC0:   // Audio control 0
         {
+            // Writes during autodetection are never heard, since the
+            // sound is reset afterwards; don't let them pile up
             myAUDC0 = value & 0x0f;
-            mySound.set(addr, value, mySystem->cycles());
+            if (!mySystem->autodetectMode())
+                mySound.set(addr, value, mySystem->cycles());
             break;
         }
 
         case AUDC1:   // Audio control 1
         {
             myAUDC1 = value & 0x0f;
-            mySound.set(addr, value, mySystem->cycles());
+            if (!mySystem->autodetectMode())
+                mySound.set(addr, value, mySystem->cycles());
             break;
         }
 
         case AUDF0:   // Audio frequency 0
         {
             myAUDF0 = value & 0x1f;
-            mySound.set(addr, value, mySystem->cycles());
+            if (!mySystem->autodetectMode())
+                mySound.set(addr, value, mySystem->cycles());
             break;
         }
 
         case AUDF1:   // Audio frequency 1
         {
             myAUDF1 = value & 0x1f;
-            mySound.set(addr, value, mySystem->cycles());
+            if (!mySystem->autodetectMode())
+                mySound.set(addr, value, mySystem->cycles());
             break;
         }
 
         case AUDV0:   // Audio volume 0
         {
             myAUDV0 = value & 0x0f;
-            mySound.set(addr, value, mySystem->cycles());
+            if (!mySystem->autodetectMode())
+                mySound.set(addr, value, mySystem->cycles());
             break;
         }
 
         case AUDV1:   // Audio volume 1
         {
             myAUDV1 = value & 0x0f;
-            mySound.set(addr, value, mySystem->cycles());
+            if (!mySystem->autodetectMode())
+                mySound.set(addr, value, mySystem->cycles());
             break;
         }
 
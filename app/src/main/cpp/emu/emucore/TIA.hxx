@@ -25,6 +25,7 @@ class Settings;
 class Sound;
 
 #include "bspf.hxx"
+#include "ConsoleArena.hxx"
 #include "Device.hxx"
 #include "System.hxx"
 #include "TIATables.hxx"
@@ -165,6 +166,16 @@ class TIA : public Device
     */
     void update();
 
+    /**
+      Emulate the current frame (starting a new one if needed) up to the
+      given CPU cycle of it, so that input can change in the middle of a
+      frame.  A later call to update() finishes the frame.
+
+      @param cycle  The cycle to stop at, counted from the start of the frame
+      @return  True if the frame was finished before reaching the cycle
+    */
+    bool updateToCycle(uInt32 cycle);
+
     /**
       Answers the current frame buffer
 
@@ -424,11 +435,12 @@ class TIA : public Device
     // Settings object the TIA is associated with
     Settings& mySettings;
 
-    // Pointer to the current frame buffer
-    BytePtr myCurrentFrameBuffer;
+    // Pointer to the current frame buffer (in the arena of the console,
+    // if it has one)
+    ConsoleArena::BytePtr myCurrentFrameBuffer;
 
     // Pointer to the previous frame buffer
-    BytePtr myPreviousFrameBuffer;
+    ConsoleArena::BytePtr myPreviousFrameBuffer;
 
     // Pointer to the next pixel that will be drawn in the current frame buffer
     uInt8* myFramePointer;
@@ -657,6 +669,47 @@ class TIA : public Device
     // Large jitter values will take multiple frames to recover from
     Int32 myJitterRecovery, myJitterRecoveryFactor;
 
+    // Fixed layout of the saved state (see Serializer::Layout)
+    struct State {
+        Int32 clockWhenFrameStarted;
+        Int32 clockStartDisplay;
+        Int32 clockStopDisplay;
+        Int32 clockAtLastUpdate;
+        Int32 clocksToEndOfScanLine;
+        uInt32 scanlineCountForLastFrame;
+        Int32 VSYNCFinishClock;
+        uInt32 PF;
+        uInt32 collisionEnabledMask;
+        Int32 dumpDisabledCycle;
+        Int32 motionClockP0, motionClockP1, motionClockM0, motionClockM1,
+              motionClockBL;
+        Int32 startP0, startP1, startM0, startM1;
+        Int32 currentHMOVEPos;
+        Int32 previousHMOVEPos;
+        uInt32 frameCounter;
+        uInt32 PALFrameCounter;
+
+        uInt16 collision;
+        Int16 POSP0, POSP1, POSM0, POSM1, POSBL;
+
+        uInt8 enabledObjects, disabledObjects;
+        uInt8 VSYNC, VBLANK, NUSIZ0, NUSIZ1;
+        uInt8 color[8];
+        uInt8 CTRLPF, playfieldPriorityAndScore;
+        uInt8 REFP0, REFP1;
+        uInt8 GRP0, GRP1, DGRP0, DGRP1;
+        uInt8 ENAM0, ENAM1, ENABL, DENABL;
+        uInt8 HMP0, HMP1, HMM0, HMM1, HMBL;
+        uInt8 VDELP0, VDELP1, VDELBL;
+        uInt8 RESMP0, RESMP1;
+        uInt8 currentGRP0, currentGRP1;
+        uInt8 dumpEnabled;
+        uInt8 suppressP0, suppressP1;
+        uInt8 HMP0mmr, HMP1mmr, HMM0mmr, HMM1mmr, HMBLmmr;
+        uInt8 HMOVEBlankEnabled;
+        uInt8 unused;
+    };
+
     private:
       // Following constructors and assignment operators not supported
     TIA() = delete;
@@ -19,6 +19,7 @@
 
 #include "System.hxx"
 #include "TIATables.hxx"
+#include "SharedContext.hxx"
 #include "TIASnd.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -26,7 +27,10 @@ TIASound::TIASound(Int32 outputFrequency)
     : myChannelMode(Hardware2Stereo),
     myOutputFrequency(outputFrequency),
     myOutputCounter(0),
-    myVolumePercentage(100)
+    myVolumePercentage(100),
+    Bit4(SharedContext::instance().poly4()),
+    Bit5(SharedContext::instance().poly5()),
+    Bit9(SharedContext::instance().poly9())
 {
     reset();
 }
@@ -34,12 +38,7 @@ TIASound::TIASound(Int32 outputFrequency)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASound::reset()
 {
-  // Fill the polynomials
-    polyInit(Bit4, 4, 4, 3);
-    polyInit(Bit5, 5, 5, 3);
-    polyInit(Bit9, 9, 9, 5);
-
-    // Initialize instance variables
+  // Initialize instance variables
     for (int chan = 0; chan <= 1; ++chan)
     {
         myVolume[chan] = 0;
@@ -368,21 +367,6 @@ void TIASound::process(Int16* buffer, uInt32 samples)
     myDivNCnt[1] = div_n_cnt1;
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void TIASound::polyInit(uInt8* poly, int size, int f0, int f1)
-{
-    int mask = (1 << size) - 1, x = mask;
-
-    for (int i = 0; i < mask; i++)
-    {
-        int bit0 = ((size - f0) ? (x >> (size - f0)) : x) & 0x01;
-        int bit1 = ((size - f1) ? (x >> (size - f1)) : x) & 0x01;
-        poly[i] = x & 1;
-        // calculate next bit
-        x = (x >> 1) | ((bit0 ^ bit1) << (size - 1));
-    }
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const uInt8 TIASound::Div31[POLY5_SIZE] = {
   0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -94,9 +94,6 @@ class TIASound
     */
     void volume(uInt32 percent);
 
-    private:
-    void polyInit(uInt8* poly, int size, int f0, int f1);
-
     private:
       // Definitions for AUDCx (15, 16)
     enum AUDCxRegister
@@ -156,16 +153,17 @@ class TIASound
     uInt32 myVolumePercentage;
 
     /*
-      Initialize the bit patterns for the polynomials (at runtime).
+      The bit patterns for the polynomials, shared by all instances
+      (see SharedContext).
 
       The 4bit and 5bit patterns are the identical ones used in the tia chip.
       Though the patterns could be packed with 8 bits per byte, using only a
       single bit per byte keeps the math simple, which is important for
       efficient processing.
     */
-    uInt8 Bit4[POLY4_SIZE];
-    uInt8 Bit5[POLY5_SIZE];
-    uInt8 Bit9[POLY9_SIZE];
+    const uInt8* const Bit4;
+    const uInt8* const Bit5;
+    const uInt8* const Bit9;
 
     /*
       The 'Div by 31' counter is treated as another polynomial because of
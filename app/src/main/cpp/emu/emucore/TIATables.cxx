@@ -18,6 +18,7 @@
 //============================================================================
 
 #include <cassert>
+#include <mutex>
 
 #include "bspf.hxx"
 #include "TIATables.hxx"
@@ -25,14 +26,20 @@
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIATables::computeAllTables()
 {
-    memset(DisabledMask, 0, 640);
-    buildCollisionMaskTable();
-    buildPxMaskTable();
-    buildMxMaskTable();
-    buildBLMaskTable();
-    buildPFMaskTable();
-    buildGRPReflectTable();
-    buildPxPosResetWhenTable();
+  // The tables never change, so every TIA (i.e. every cloned console)
+  // after the first one shares them as they are
+    static std::once_flag computed;
+    std::call_once(computed, []
+    {
+        memset(DisabledMask, 0, 640);
+        buildCollisionMaskTable();
+        buildPxMaskTable();
+        buildMxMaskTable();
+        buildBLMaskTable();
+        buildPFMaskTable();
+        buildGRPReflectTable();
+        buildPxPosResetWhenTable();
+    });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -139,7 +139,7 @@ class TIATables
 {
     public:
       /**
-        Compute all static tables used by the TIA
+        Compute all static tables used by the TIA (only done once)
       */
     static void computeAllTables();
 
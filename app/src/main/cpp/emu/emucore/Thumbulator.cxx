@@ -2064,6 +2064,6 @@ int Thumbulator::reset()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Thumbulator::trapOnFatal = true;
+std::atomic<bool> Thumbulator::trapOnFatal(true);
 
 #endif
@@ -29,6 +29,8 @@
 #ifndef THUMBULATOR_HXX
 #define THUMBULATOR_HXX
 
+#include <atomic>
+
 #include "bspf.hxx"
 
 #define ROMADDMASK 0x7FFF
@@ -111,7 +113,7 @@ class Thumbulator
 
     ostringstream statusMsg;
 
-    static bool trapOnFatal;
+    static std::atomic<bool> trapOnFatal;
 
     private:
       // Following constructors and assignment operators not supported
@@ -14162,6 +14162,13 @@
 "Cartridge.Note" "AKA Grand Prix"
 ""
 
+"Cartridge.MD5" "b50ae55aac93fbed258bc5a873edd2cb"
+"Cartridge.Manufacturer" "Recompile"
+"Cartridge.Name" "E.T. The Extra-Terrestrial (Recompile) (Hack)"
+"Cartridge.Note" "www.neocomputer.org/projects/et"
+"Cartridge.Rarity" "Hack"
+""
+
 "Cartridge.MD5" "b5110f55ed99d5279f18266d001a8cd5"
 "Cartridge.Manufacturer" "Eckhard Stolberg"
 "Cartridge.Name" "Auto-mobile Demo (2001) (Eckhard Stolberg)"
@@ -20309,10 +20316,3 @@
 "Display.YStart" "28"
 ""
 
-"Cartridge.MD5" "b50ae55aac93fbed258bc5a873edd2cb"
-"Cartridge.Manufacturer" "Recompile"
-"Cartridge.Name" "E.T. The Extra-Terrestrial (Recompile) (Hack)"
-"Cartridge.Note" "www.neocomputer.org/projects/et"
-"Cartridge.Rarity" "Hack"
-""
-
@@ -0,0 +1,211 @@
+#!/usr/bin/perl
+
+# create_props.pl
+#
+# Generates DefProps.hxx, the built-in properties database, from stella.pro:
+#
+#   perl tools/create_props.pl emucore/stella.pro > emucore/DefProps.hxx
+#
+# The database holds no pointers, so loading it needs no relocations:
+#  - every distinct property value is stored once in a pool of strings
+#  - each ROM has its binary MD5 and the start of its list of
+#    (property type, offset into the pool) pairs; unset properties are left out
+#  - the ROMs are ordered by a minimal perfect hash of the MD5 (hash and
+#    displace), so a lookup is a bucket, a displacement and one comparison
+
+use strict;
+use warnings;
+
+my @names = (
+  "Cartridge.MD5", "Cartridge.Manufacturer", "Cartridge.ModelNo",
+  "Cartridge.Name", "Cartridge.Note", "Cartridge.Rarity", "Cartridge.Sound",
+  "Cartridge.Type", "Console.LeftDifficulty", "Console.RightDifficulty",
+  "Console.TelevisionType", "Console.SwapPorts", "Controller.Left",
+  "Controller.Right", "Controller.SwapPaddles", "Controller.MouseAxis",
+  "Display.Format", "Display.YStart", "Display.Height", "Display.Phosphor",
+  "Display.PPBlend"
+);
+my %types;
+@types{@names} = (0 .. $#names);
+
+my $LAMBDA = 4;       # average number of ROMs per bucket
+my $MAX_DISPLACE = 65535;
+
+# Read the entries: quoted key/value pairs, each entry ended by ""
+my $text = do { local $/; <> };
+my @strings = ($text =~ /"([^"]*)"/g);
+
+my @entries;
+my %entry;
+while (@strings)
+{
+  my $key = shift @strings;
+  if ($key eq "")
+  {
+    push @entries, { %entry } if %entry;
+    %entry = ();
+    next;
+  }
+
+  my $value = shift @strings;
+  die "Unknown property '$key'\n" unless exists $types{$key};
+  $entry{$types{$key}} = $value if $value ne "";
+}
+push @entries, { %entry } if %entry;
+
+# Key them by binary MD5
+my %seen;
+foreach my $e (@entries)
+{
+  my $md5 = lc($e->{0} // "");
+  die "Invalid MD5 '$md5'\n" unless $md5 =~ /^[0-9a-f]{32}$/;
+  die "Duplicate MD5 '$md5'\n" if $seen{$md5}++;
+
+  my @bytes = map { hex } ($md5 =~ /(..)/g);
+  $e->{bytes} = \@bytes;
+  $e->{h0} = $bytes[0] | ($bytes[1] << 8) | ($bytes[2] << 16) | ($bytes[3] << 24);
+  $e->{h1} = $bytes[4] | ($bytes[5] << 8) | ($bytes[6] << 16) | ($bytes[7] << 24);
+}
+
+my $size = scalar @entries;
+my $buckets = int(($size + $LAMBDA - 1) / $LAMBDA);
+
+sub slot
+{
+  my ($h1, $d) = @_;
+  return ($h1 ^ (($d * 0x9E3779B1) & 0xFFFFFFFF)) % $size;
+}
+
+# Place the biggest buckets first, each with the first displacement
+# moving all of its ROMs to free slots
+my @bucket;
+push @{$bucket[$_->{h0} % $buckets]}, $_ foreach @entries;
+
+my @displace = (0) x $buckets;
+my @slots;
+foreach my $b (sort { scalar(@{$bucket[$b] // []}) <=> scalar(@{$bucket[$a] // []}) || $a <=> $b }
+               (0 .. $buckets - 1))
+{
+  my @members = @{$bucket[$b] // []};
+  next unless @members;
+
+  my $d = 0;
+  DISPLACE: for (; $d <= $MAX_DISPLACE; ++$d)
+  {
+    my %taken;
+    foreach my $e (@members)
+    {
+      my $s = slot($e->{h1}, $d);
+      next DISPLACE if defined $slots[$s] || $taken{$s}++;
+    }
+    last;
+  }
+  die "No displacement found for bucket $b\n" if $d > $MAX_DISPLACE;
+
+  $displace[$b] = $d;
+  $slots[slot($_->{h1}, $d)] = $_ foreach @members;
+}
+
+# Pool of the distinct values, and the property list of every ROM
+my $pool = "";
+my %offsets;
+my @fields;
+my @first;
+foreach my $e (@slots)
+{
+  push @first, scalar @fields;
+  foreach my $type (1 .. $#names)
+  {
+    next unless exists $e->{$type};
+    my $value = $e->{$type};
+    if (!exists $offsets{$value})
+    {
+      $offsets{$value} = length $pool;
+      $pool .= $value . "\0";
+    }
+    push @fields, ($type << 24) | $offsets{$value};
+  }
+}
+push @first, scalar @fields;
+die "Pool too big\n" if length($pool) >= (1 << 24);
+
+print <<"END";
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2016 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef DEF_PROPS_HXX
+#define DEF_PROPS_HXX
+
+/**
+  This code is generated using the 'create_props.pl' script,
+  located in the tools directory.  All properties changes
+  should be made in stella.pro, and then this file should be
+  regenerated and the application recompiled.
+
+  The ROMs are ordered by a minimal perfect hash of their MD5: the first
+  four bytes of it (little endian) pick a bucket, and the slot is
+
+    (next four bytes ^ (DefPropsDisplace[bucket] * 0x9E3779B1)) % DEF_PROPS_SIZE
+
+  The properties of the ROM in slot i are DefPropsFields[DefProps[i].fields]
+  up to DefProps[i + 1].fields, each the property type in the top byte and
+  the offset of the value in DefPropsPool in the rest.
+*/
+
+#define DEF_PROPS_SIZE $size
+#define DEF_PROPS_BUCKETS $buckets
+
+struct DefPropsEntry {
+    uInt8 md5[16];
+    uInt32 fields;
+};
+
+static const DefPropsEntry DefProps[DEF_PROPS_SIZE + 1] = {
+END
+
+for (my $i = 0; $i < $size; ++$i)
+{
+  my $bytes = join(",", map { sprintf("0x%02x", $_) } @{$slots[$i]->{bytes}});
+  print "  { { $bytes }, $first[$i] },\n";
+}
+print "  { { 0 }, $first[$size] }\n};\n\n";
+
+print "static const uInt32 DefPropsFields[] = {\n";
+for (my $i = 0; $i < @fields; $i += 8)
+{
+  my $end = $i + 7 < $#fields ? $i + 7 : $#fields;
+  print "  " . join(", ", map { sprintf("0x%08x", $_) } @fields[$i .. $end]) .
+        ($end < $#fields ? ",\n" : "\n");
+}
+print "};\n\n";
+
+print "static const uInt16 DefPropsDisplace[DEF_PROPS_BUCKETS] = {\n";
+for (my $i = 0; $i < $buckets; $i += 12)
+{
+  my $end = $i + 11 < $buckets - 1 ? $i + 11 : $buckets - 1;
+  print "  " . join(", ", @displace[$i .. $end]) . ($end < $buckets - 1 ? ",\n" : "\n");
+}
+print "};\n\n";
+
+print "static const char DefPropsPool[] =\n";
+my @values = split /\0/, $pool;
+for (my $i = 0; $i < @values; ++$i)
+{
+  print "  \"$values[$i]\\0\"" . ($i < $#values ? "\n" : ";\n");
+}
+
+print "\n#endif\n";
@@ -5,6 +5,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <memory.h>
 #include <jni.h>
 #include <cstdio>
@@ -12,12 +13,6 @@
 
 #include "./emu_bindings.h"
 
-static const int rawVideoBufferSize = 160 * 320 * 4;
-static void* rawVideoBuffer = NULL;
-
-static int rawAudioBufferSize = 0;
-static void* rawAudioBuffer = NULL;
-
 typedef struct
 {
     uint32_t render_width;
@@ -25,29 +20,81 @@ typedef struct
     uint32_t render_ystart;
 } emu_stats_t;
 
-static emu_stats_t emuStats;
+// Everything the Java side works with: the emulator instance and the
+// buffers its output is converted in
+typedef struct
+{
+    emu_instance_t* emu;
+
+    // The resident instances emu is one of, or NULL (see 'consolepool')
+    emu_pool_t* pool;
+
+    int rawAudioBufferSize;
+    void* rawAudioBuffer;
+
+    emu_stats_t emuStats;
 
-static bool emuReady = false;
+    bool emuReady;
+} native_instance_t;
 
-static void setAudioBuffer(int sz)
+static native_instance_t* theInstance = NULL;
+
+static void setAudioBuffer(native_instance_t* instance, int sz)
 {
-    if (sz > 0 && sz <= rawAudioBufferSize)
+    if (sz > 0 && sz <= instance->rawAudioBufferSize)
     {
         return;
     }
 
-    if (NULL != rawAudioBuffer)
+    if (NULL != instance->rawAudioBuffer)
     {
-        delete [] (unsigned char*) rawAudioBuffer;
-        rawAudioBuffer = NULL;
+        delete [] (unsigned char*) instance->rawAudioBuffer;
+        instance->rawAudioBuffer = NULL;
     }
 
     if (sz > 0)
     {
-        rawAudioBuffer = new unsigned char[sz];
+        instance->rawAudioBuffer = new unsigned char[sz];
+    }
+
+    instance->rawAudioBufferSize = sz;
+}
+
+static int destroyInstance(native_instance_t* instance)
+{
+    instance->emuReady = false;
+
+    setAudioBuffer(instance, 0);
+
+    int result = (NULL != instance->pool) ? emu_pool_destroy(instance->pool)
+                                          : emu_destroy(instance->emu);
+
+    delete instance;
+
+    return result;
+}
+
+// NewStringUTF() takes modified UTF-8 only: sequences of up to three
+// bytes, no four-byte ones
+static bool isModifiedUtf8(const char* str)
+{
+    const unsigned char* p = (const unsigned char*) str;
+    while (*p)
+    {
+        int n;
+        if (*p < 0x80) n = 0;
+        else if ((*p & 0xE0) == 0xC0) n = 1;
+        else if ((*p & 0xF0) == 0xE0) n = 2;
+        else return false;
+
+        p++;
+        for (int i=0; i<n; i++, p++)
+        {
+            if ((*p & 0xC0) != 0x80) return false;
+        }
     }
 
-    rawAudioBufferSize = sz;
+    return true;
 }
 
 extern "C"
@@ -55,27 +102,37 @@ extern "C"
 
 JNIEXPORT jint JNICALL Java_emu_NativeInterface_init(JNIEnv* env, jobject obj, jstring prefs, jint flags)
 {
-    if (NULL == rawVideoBuffer)
+    if (NULL != theInstance)
     {
-        rawVideoBuffer = new unsigned char[rawVideoBufferSize];
+        destroyInstance(theInstance);
+        theInstance = NULL;
     }
 
-    memset(rawVideoBuffer, 0, rawVideoBufferSize);
-
     //setAudioBuffer(4096); // should be more than enough for one fragment
 
     const char *nativeString = env->GetStringUTFChars(prefs, 0);
 
-    int result = emu_init(nativeString, (int) flags);
+    emu_instance_t* emu = emu_create(nativeString, (int) flags);
+    emu_pool_t* pool = (NULL != emu) ? emu_pool_create(emu, nativeString, 0) : NULL;
 
     env->ReleaseStringUTFChars(prefs, nativeString);
 
-    return result;
+    if (NULL == emu) return -1;
+
+    native_instance_t* instance = new native_instance_t();
+    instance->emu = emu;
+    instance->pool = pool;
+
+    theInstance = instance;
+
+    return 0;
 }
 
 JNIEXPORT jint JNICALL Java_emu_NativeInterface_input(JNIEnv* env, jobject obj, jint keyCode, jint state)
 {
-    return emu_input((int) keyCode, (int) state);
+    if (NULL == theInstance) return 0;
+
+    return emu_instance_input(theInstance->emu, (int) keyCode, (int) state);
 }
 
 JNIEXPORT jint JNICALL Java_emu_NativeInterface_load(JNIEnv* env, jobject obj,
@@ -84,18 +141,131 @@ JNIEXPORT jint JNICALL Java_emu_NativeInterface_load(JNIEnv* env, jobject obj,
                                                                  jint dataSize,
                                                                  jstring filename)
 {
-    emuReady = false;
+    if (NULL == theInstance) return -1;
+
+    // snapshots and EEPROM data are loaded into the running console
+    bool isImage = (EMU_DATA_SNAPSHOT != dataType && EMU_DATA_NVRAM != dataType);
+
+    if (isImage) theInstance->emuReady = false;
 
     jboolean isCopy;
     jbyte* rawjBytes = env->GetByteArrayElements(data, &isCopy);
     const char *nativeString = env->GetStringUTFChars(filename, 0);
 
-    int result = emu_load((int) dataType, rawjBytes, (int) dataSize, nativeString);
+    int result = -1;
+    if (isImage && NULL != theInstance->pool)
+    {
+        // switch to the resident instance of the ROM, or one built for it
+        emu_instance_t* emu = emu_pool_switch(theInstance->pool, rawjBytes, (int) dataSize, nativeString);
+        if (NULL != emu)
+        {
+            theInstance->emu = emu;
+            result = 0;
+        }
+    }
+    else
+    {
+        result = emu_instance_load(theInstance->emu, (int) dataType, rawjBytes, (int) dataSize, nativeString);
+    }
 
-    env->ReleaseByteArrayElements(data, rawjBytes, 0);
+    // data is only read, no need to copy it back
+    env->ReleaseByteArrayElements(data, rawjBytes, JNI_ABORT);
     env->ReleaseStringUTFChars(filename, nativeString);
 
-    emuReady = (0 == result);
+    if (isImage) theInstance->emuReady = (0 == result);
+
+    return result;
+}
+
+JNIEXPORT jint JNICALL Java_emu_NativeInterface_loadArchive(JNIEnv* env, jobject obj,
+                                                                        jstring archivePath,
+                                                                        jstring entryName)
+{
+    if (NULL == theInstance) return -1;
+
+    // the archive stays open in the emulator until the file changes, so
+    // opening it again is just a lookup
+    const char *path = env->GetStringUTFChars(archivePath, 0);
+    emu_archive_t* archive = emu_archive_open(path);
+    env->ReleaseStringUTFChars(archivePath, path);
+
+    if (NULL == archive) return -1;
+
+    theInstance->emuReady = false;
+
+    const char *entry = env->GetStringUTFChars(entryName, 0);
+
+    int result = -1;
+    if (NULL != theInstance->pool)
+    {
+        emu_instance_t* emu = emu_pool_switch_archive(theInstance->pool, archive, entry);
+        if (NULL != emu)
+        {
+            theInstance->emu = emu;
+            result = 0;
+        }
+    }
+    else
+    {
+        result = emu_instance_load_archive(theInstance->emu, archive, entry);
+    }
+
+    env->ReleaseStringUTFChars(entryName, entry);
+    emu_archive_close(archive);
+
+    theInstance->emuReady = (0 == result);
+
+    return result;
+}
+
+JNIEXPORT jstring JNICALL Java_emu_NativeInterface_listArchive(JNIEnv* env, jobject obj,
+                                                                          jstring archivePath)
+{
+    const char *path = env->GetStringUTFChars(archivePath, 0);
+    emu_archive_t* archive = emu_archive_open(path);
+    env->ReleaseStringUTFChars(archivePath, path);
+
+    if (NULL == archive) return NULL;
+
+    // names separated by '\n'; names which aren't UTF-8 (usually CP437)
+    // wouldn't make it through a Java string and back, so those archives
+    // are left to java.util.zip
+    jstring result = NULL;
+    if (emu_archive_utf8_names(archive))
+    {
+        int size = emu_archive_list(archive, NULL, 0);
+        char* list = (char*) malloc(size);
+        emu_archive_list(archive, list, size);
+
+        if (isModifiedUtf8(list))
+        {
+            result = env->NewStringUTF(list);
+        }
+
+        free(list);
+    }
+
+    emu_archive_close(archive);
+
+    return result;
+}
+
+JNIEXPORT jint JNICALL Java_emu_NativeInterface_prepare(JNIEnv* env, jobject obj,
+                                                                    jbyteArray data,
+                                                                    jint dataSize,
+                                                                    jstring filename)
+{
+    if (NULL == theInstance || NULL == theInstance->pool) return -1;
+
+    jboolean isCopy;
+    jbyte* rawjBytes = env->GetByteArrayElements(data, &isCopy);
+    const char *nativeString = env->GetStringUTFChars(filename, 0);
+
+    // the pool copies the image for its thread
+    int result = emu_pool_prepare(theInstance->pool, rawjBytes, (int) dataSize, nativeString);
+
+    env->ReleaseByteArrayElements(data, rawjBytes, JNI_ABORT);
+    env->ReleaseStringUTFChars(filename, nativeString);
 
     return result;
 }
@@ -105,28 +275,38 @@ JNIEXPORT jint JNICALL Java_emu_NativeInterface_store(JNIEnv* env, jobject obj,
                                                                   jbyteArray data,
                                                                   jint dataSize)
 {
-    jboolean isCopy;
-    jbyte* rawjBytes = env->GetByteArrayElements(data, &isCopy);
+    if (NULL == theInstance) return 0;
 
-    int result = emu_store((int) dataType, (void*) rawjBytes, (int) dataSize);
+    // no buffer: just query the size to allocate
+    if (NULL == data) return emu_instance_store(theInstance->emu, (int) dataType, NULL, 0);
 
-    env->ReleaseByteArrayElements(data, rawjBytes, 0);
+    // emu_store only copies into the buffer, so it is safe to write to the
+    // array in place instead of a copy
+    void* rawjBytes = env->GetPrimitiveArrayCritical(data, NULL);
+
+    int result = emu_instance_store(theInstance->emu, (int) dataType, rawjBytes, (int) dataSize);
+
+    env->ReleasePrimitiveArrayCritical(data, rawjBytes, 0);
 
     return result;
 }
 
 JNIEXPORT jint JNICALL Java_emu_NativeInterface_command(JNIEnv* env, jobject obj, jint command, jint param)
 {
-    return emu_command((int) command, (int) param);
+    if (NULL == theInstance) return 0;
+
+    if (NULL != theInstance->pool) return emu_pool_command(theInstance->pool, (int) command, (int) param);
+
+    return emu_instance_command(theInstance->emu, (int) command, (int) param);
 }
 
 JNIEXPORT jint JNICALL Java_emu_NativeInterface_updateInput(JNIEnv* env, jobject obj,
                                                        jint joystickInput,
                                                        int flags)
 {
-    if (false == emuReady) return 0;
+    if (NULL == theInstance || false == theInstance->emuReady) return 0;
 
-    return emu_update_input((int) joystickInput, (int) flags);
+    return emu_instance_update_input(theInstance->emu, (int) joystickInput, (int) flags);
 }
 
 JNIEXPORT jint JNICALL Java_emu_NativeInterface_updateVideo(JNIEnv* env, jobject obj,
@@ -134,45 +314,32 @@ JNIEXPORT jint JNICALL Java_emu_NativeInterface_updateVideo(JNIEnv* env, jobject
                                                        jbyteArray emuStatsBuffer,
                                                        int flags)
 {
-    if (false == emuReady) return 0;
+    if (NULL == theInstance || false == theInstance->emuReady) return 0;
 
     emu_update_info_t updateInfo;
 
-    int result = emu_update_video(&updateInfo, (int) flags);
+    // The emulator converts the frame to colours, possibly on a second
+    // core (see the 'pipeline' setting)
+    int result = emu_instance_update_video(theInstance->emu, &updateInfo,
+                                           (int) flags | EMU_VIDEO_FLAG_COLORS);
 
     if (0 == result) return 0;
 
-    int w = updateInfo.video_width;
     int h = updateInfo.video_height;
-    int s = updateInfo.video_ystart;
-    const uint32_t* palette = updateInfo.palette;
-
-    ////
 
     const uint8_t* src = (const uint8_t*) updateInfo.video_buffer;
-    uint32_t* dest = (uint32_t*) rawVideoBuffer;
 
-    //LOG("EmuBindings frame: %p (%d/%d/%d)", (const void*) src, w, h, s);
-
-    for (int y=0; y<h; y++)
-    {
-        const uint8_t* srcLine = src + w*y;
-        uint32_t* destLine = dest + 160*y; // fixed width: 160 pixels
-
-        for (int x=0; x<w; x++)
-        {
-            uint8_t p = *(srcLine++);
-            uint32_t c = palette[p];
-            *(destLine++) = 0xFF000000 | c;
-        }
-    }
+    //LOG("EmuBindings frame: %p (%d/%d/%d)", (const void*) src, updateInfo.video_width, h, 160 * 4);
 
+    emu_stats_t& emuStats = theInstance->emuStats;
     emuStats.render_width = (uint32_t) updateInfo.video_width;
     emuStats.render_height = (uint32_t) updateInfo.video_height;
     emuStats.render_ystart = (uint32_t) updateInfo.video_ystart;
 
     env->SetByteArrayRegion(emuStatsBuffer, 0, (jsize) sizeof(emuStats), (const jbyte*) &emuStats);
-    env->SetByteArrayRegion(videoOutput, 0, (jsize) rawVideoBufferSize, (const jbyte*) rawVideoBuffer);
+
+    // fixed width: 160 pixels
+    env->SetByteArrayRegion(videoOutput, 0, (jsize) (160 * h * 4), (const jbyte*) src);
 
     return result;
 }
@@ -181,12 +348,12 @@ JNIEXPORT jint JNICALL Java_emu_NativeInterface_updateAudio(JNIEnv* env, jobject
                                                        jbyteArray audioOutputBuffer,
                                                        jint audioOutputBufferSize)
 {
-    if (false == emuReady)
+    if (NULL == theInstance || false == theInstance->emuReady)
     {
         return 0;
     }
 
-    setAudioBuffer(audioOutputBufferSize);
+    setAudioBuffer(theInstance, audioOutputBufferSize);
     if (NULL == audioOutputBuffer)
     {
         return 0;
@@ -194,13 +361,13 @@ JNIEXPORT jint JNICALL Java_emu_NativeInterface_updateAudio(JNIEnv* env, jobject
 
     //if (NULL == audioOutputBuffer || audioOutputBufferSize > rawAudioBufferSize) return 0;
 
-    int result = emu_update_audio(rawAudioBuffer, (int) audioOutputBufferSize, 0);
+    int result = emu_instance_update_audio(theInstance->emu, theInstance->rawAudioBuffer, (int) audioOutputBufferSize, 0);
     if (0 == result)
     {
         return 0;
     }
 
-    env->SetByteArrayRegion(audioOutputBuffer, 0, (jsize) audioOutputBufferSize, (const jbyte*) rawAudioBuffer);
+    env->SetByteArrayRegion(audioOutputBuffer, 0, (jsize) audioOutputBufferSize, (const jbyte*) theInstance->rawAudioBuffer);
 
     return result;
 }
@@ -208,10 +375,17 @@ JNIEXPORT jint JNICALL Java_emu_NativeInterface_updateAudio(JNIEnv* env, jobject
 JNIEXPORT jstring JNICALL Java_emu_NativeInterface_get(JNIEnv* env, jobject obj, jstring key)
 {
     char buf[512];
+    buf[0] = '\0';
 
     const char* cstrKey = env->GetStringUTFChars(key, NULL);
 
-    emu_get(cstrKey, buf, sizeof(buf));
+    if (NULL != theInstance)
+    {
+        if (NULL != theInstance->pool && 0 == strcmp(cstrKey, "pool.info"))
+            emu_pool_info(theInstance->pool, buf, sizeof(buf));
+        else
+            emu_instance_get(theInstance->emu, cstrKey, buf, sizeof(buf));
+    }
 
     env->ReleaseStringUTFChars(key, cstrKey);
 
@@ -222,17 +396,10 @@ JNIEXPORT jstring JNICALL Java_emu_NativeInterface_get(JNIEnv* env, jobject obj,
 
 JNIEXPORT jint JNICALL Java_emu_NativeInterface_shutdown(JNIEnv* env, jobject obj)
 {
-    emuReady = false;
-
-    if (rawVideoBuffer)
-    {
-        delete [] (unsigned char*) rawVideoBuffer;
-        rawVideoBuffer = NULL;
-    }
-
-    setAudioBuffer(0);
+    if (NULL == theInstance) return -1;
 
-    int result = emu_shutdown();
+    int result = destroyInstance(theInstance);
+    theInstance = NULL;
 
     return result;
 }
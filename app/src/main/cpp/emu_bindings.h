@@ -12,9 +12,35 @@
 #define DLLBINDING /* */
 #endif
 
+// Key codes of emu_input (state 1 = pressed, 0 = released).  The events
+// are queued with the time they are pushed at, from any one thread, and
+// go into the frame at the cycle matching their distance in time; use
+// either them or the joystick mask of emu_update_input.
+#define VKEY_JOYSTICK_FIRE 0x01
+#define VKEY_JOYSTICK_LEFT 0x02
+#define VKEY_JOYSTICK_RIGHT 0x04
+#define VKEY_JOYSTICK_UP 0x08
+#define VKEY_JOYSTICK_DOWN 0x10
+#define VKEY_JOYSTICK_ONE 0x100 /* or'ed in for the second joystick */
 #define VKEY_CONSOLE_RESET 0x10000
 #define VKEY_CONSOLE_SELECT 0x20000
 
+// Audio output format, passed as parameter of COMMAND_AUDIO_FORMAT
+#define EMU_AUDIO_FORMAT_RATE_MASK 0xfffff
+#define EMU_AUDIO_FORMAT_CHANNELS_SHIFT 24
+#define EMU_AUDIO_FORMAT_FLOAT 0x10000000
+#define EMU_AUDIO_FORMAT(rate, channels, isFloat) \
+    ((rate) | ((channels) << EMU_AUDIO_FORMAT_CHANNELS_SHIFT) | ((isFloat) ? EMU_AUDIO_FORMAT_FLOAT : 0))
+
+// Data types of emu_load/emu_store (matching the frontend image types)
+#define EMU_DATA_SNAPSHOT 1 /* console state */
+#define EMU_DATA_ROM 5 /* cartridge image, the default for unknown types */
+#define EMU_DATA_NVRAM 6 /* EEPROM of a SaveKey/AtariVox */
+
+// Flag of emu_update_video: deliver the frame as 32 bit colours (RGBA in
+// memory, 160 pixels per line) instead of palette indices
+#define EMU_VIDEO_FLAG_COLORS 0x8
+
 typedef struct
 {
     const void* video_buffer;
@@ -24,9 +50,123 @@ typedef struct
     const uint32_t* palette;
 } emu_update_info_t;
 
+// An independent emulator instance; any number of them can be created,
+// each with its own settings, console, ROM and buffers.  The functions
+// without a handle work on a default instance created by emu_init().
+typedef struct emu_instance emu_instance_t;
+
+// Flag of emu_create: an instance without a frontend of its own (batch
+// environments, ROM runs, pool consoles), which never opens the state
+// slot file nor saves its settings
+#define EMU_CREATE_FLAG_HEADLESS 0x1
+
+extern "C" emu_instance_t* DLLBINDING emu_create(const char* prefs, int flags);
+extern "C" int DLLBINDING emu_destroy(emu_instance_t* emu);
+extern "C" int DLLBINDING emu_instance_input(emu_instance_t* emu, int keyCode, int state);
+extern "C" int DLLBINDING emu_instance_load(emu_instance_t* emu, int data_type, const void* data, int data_size, const char* filename);
+extern "C" int DLLBINDING emu_instance_load_archive(emu_instance_t* emu, struct emu_archive* archive, const char* entry);
+extern "C" int DLLBINDING emu_instance_store(emu_instance_t* emu, int data_type, void* buffer, int buffer_size);
+extern "C" int DLLBINDING emu_instance_command(emu_instance_t* emu, int command, int param);
+extern "C" int DLLBINDING emu_instance_get(emu_instance_t* emu, const char* key, char* buffer, int buffer_size);
+extern "C" int DLLBINDING emu_instance_update_input(emu_instance_t* emu, int joystickInput, int flags);
+extern "C" int DLLBINDING emu_instance_update_audio(emu_instance_t* emu, void* buffer, int bufferLen, int flags);
+extern "C" int DLLBINDING emu_instance_update_video(emu_instance_t* emu, emu_update_info_t* update_info, int flags);
+
+// Observation types of emu_batch_step
+#define EMU_BATCH_OBSERVATION_NONE 0
+#define EMU_BATCH_OBSERVATION_FRAME 1 /* palette indices, 160x210 */
+#define EMU_BATCH_OBSERVATION_GREY 2 /* grey levels, scaled to 84x84 */
+
+#define EMU_BATCH_FRAME_WIDTH 160
+#define EMU_BATCH_FRAME_HEIGHT 210
+#define EMU_BATCH_GREY_WIDTH 84
+#define EMU_BATCH_GREY_HEIGHT 84
+#define EMU_BATCH_RAM_SIZE 128
+
+// Arrays owned by the caller receiving the results of emu_batch_step, one
+// fixed-size entry per instance in the order of the batch (NULL to skip)
+typedef struct
+{
+    int observation_type;
+    void* observations; /* emu_batch_observation_size() bytes each */
+    void* audio; /* audio_size bytes each, in the audio format of the instance */
+    int audio_size;
+    void* ram; /* EMU_BATCH_RAM_SIZE bytes each */
+} emu_batch_output_t;
+
+// A set of instances stepped together by a pool of threads
+typedef struct emu_batch emu_batch_t;
+
+extern "C" emu_batch_t* DLLBINDING emu_batch_create(emu_instance_t* const* envs, int n_envs, int n_threads);
+extern "C" int DLLBINDING emu_batch_destroy(emu_batch_t* batch);
+extern "C" int DLLBINDING emu_batch_observation_size(int observation_type);
+extern "C" int DLLBINDING emu_batch_step(emu_batch_t* batch, const int* actions, int frames_per_step, const emu_batch_output_t* output);
+
+// Status of a ROM run of emu_run_roms
+#define EMU_RUN_OK 0
+#define EMU_RUN_ERROR_READ 1 /* ROM file unreadable */
+#define EMU_RUN_ERROR_INSTANCE 2 /* no instance could be created */
+#define EMU_RUN_ERROR_CONSOLE 3 /* no console for the ROM */
+#define EMU_RUN_ERROR_EMULATION 4 /* emulation failed */
+
+// A ROM run: the ROM and the number of frames are filled in by the
+// caller, the rest by the run
+typedef struct
+{
+    const char* path; /* ROM file, or NULL to run the image in data */
+    const void* data;
+    int data_size;
+    int frames;
+    uint32_t* frame_hashes; /* one hash per frame, or NULL */
+    uint32_t hash; /* hash of all frames */
+    double micros; /* time taken to create the console and run it */
+    int status;
+} emu_run_t;
+
+extern "C" int DLLBINDING emu_run_roms(emu_run_t* runs, int n_runs, const char* prefs, int n_threads);
+
+// The instances of the ROMs used last, kept resident so that switching
+// back to a ROM hands out its paused instance instead of loading it again.
+// Instances for ROMs expected next can be built ahead on a thread of the
+// pool.  emu_pool_create() takes over the instance given, which has no ROM
+// yet; capacity 0 takes the 'consolepool' setting of it, and no pool is
+// created if that is 0.  An instance handed out by emu_pool_switch()
+// belongs to the pool and stays valid while it is the current or the
+// previous one; like loading a ROM, switching must not overlap with
+// calls on the instance switched away from.
+typedef struct emu_pool emu_pool_t;
+
+extern "C" emu_pool_t* DLLBINDING emu_pool_create(emu_instance_t* first, const char* prefs, int capacity);
+extern "C" int DLLBINDING emu_pool_destroy(emu_pool_t* pool);
+extern "C" int DLLBINDING emu_pool_prepare(emu_pool_t* pool, const void* data, int data_size, const char* filename);
+extern "C" emu_instance_t* DLLBINDING emu_pool_switch(emu_pool_t* pool, const void* data, int data_size, const char* filename);
+extern "C" emu_instance_t* DLLBINDING emu_pool_switch_archive(emu_pool_t* pool, struct emu_archive* archive, const char* entry);
+extern "C" int DLLBINDING emu_pool_command(emu_pool_t* pool, int command, int param);
+extern "C" int DLLBINDING emu_pool_info(emu_pool_t* pool, char* buffer, int buffer_size);
+
+// A zip archive of ROMs, mapped into memory with its directory indexed;
+// listing or loading its entries never extracts them.  An archive is
+// opened by path or from a piece of a file (i.e. an asset of the
+// application package, whose descriptor can be closed once it is open).
+// Archives are shared and kept open across handles until their file
+// changes.  A ROM loaded is a copy of its entry, so it never reads the
+// file again and stays valid after emu_archive_close().
+// emu_archive_list() writes the names of the entries, each followed by
+// '\n', and returns the size of the list.  The names are raw bytes;
+// emu_archive_utf8_names() tells whether all of them are UTF-8 (archives
+// made without the UTF-8 flag usually use CP437).
+typedef struct emu_archive emu_archive_t;
+
+extern "C" emu_archive_t* DLLBINDING emu_archive_open(const char* path);
+extern "C" emu_archive_t* DLLBINDING emu_archive_open_fd(int fd, long long offset, long long length);
+extern "C" int DLLBINDING emu_archive_close(emu_archive_t* archive);
+extern "C" int DLLBINDING emu_archive_list(emu_archive_t* archive, char* buffer, int buffer_size);
+extern "C" int DLLBINDING emu_archive_utf8_names(emu_archive_t* archive);
+
 extern "C" int DLLBINDING emu_init(const char* prefs, int flags);
 extern "C" int DLLBINDING emu_input(int keyCode, int state);
 extern "C" int DLLBINDING emu_load(int data_type, const void* data, int data_size, const char* filename);
+extern "C" int DLLBINDING emu_load_archive(emu_archive_t* archive, const char* entry);
 extern "C" int DLLBINDING emu_store(int data_type, void* buffer, int buffer_size);
 extern "C" int DLLBINDING emu_command(int command, int param);
 extern "C" int DLLBINDING emu_get(const char* key, char* buffer, int buffer_size);
@@ -128,6 +128,11 @@ public class Emu {
 
 			prefsDocument.append("JoystickSwap = " + (prefs.isJoystickSwapEnabled() ? "TRUE" : "FALSE") + "\n");
 
+			AudioControl.AudioSpec audioSpec = audioControl.getAudioSpec();
+			prefsDocument.append("freq = " + audioSpec.getNumSamplesPerSec() + "\n");
+			prefsDocument.append("hwchannels = " + audioSpec.getNumChannels() + "\n");
+			prefsDocument.append("sampleformat = s16\n");
+
 			if (0 != emu.init(prefsDocument.toString(), 0x0)) {
 				Log.e("emu", "failed to initialize emulator kernel");
 				return;
@@ -380,6 +385,22 @@ public class Emu {
 
 	public boolean attachImage(Image image) {
 
+		// ROMs in zip files are loaded by the emulator in place, anything
+		// it can't read is extracted here as before
+		if (image.isZip() && image.getType() == Image.TYPE_ROM) {
+			int status;
+			synchronized(emuLock) {
+				status = emu.loadArchive(image.getUrl(), image.getArchivePath());
+			}
+
+			if (0 == status) {
+				ImageManager.instance().setCurrent(image);
+				allocateSnapshotBuffer();
+				paused = false; // auto-resume
+				return true;
+			}
+		}
+
 		byte[] imageBuffer = image.load();
 		if (null != imageBuffer) {
 			ImageManager.instance().setCurrent(image);
@@ -402,6 +423,10 @@ public class Emu {
 			return false;
 		}
 
+		if (type == Image.TYPE_ROM) {
+			allocateSnapshotBuffer();
+		}
+
 		paused = false; // auto-resume
 
 		return true;
@@ -492,12 +517,13 @@ public class Emu {
 
 	public void storeSnapshot() {
 
+		int result = 0;
+
 		if (null == snapshotBuffer) {
-			snapshotBuffer = new byte[128*1024];
+			allocateSnapshotBuffer();
+			if (null == snapshotBuffer) return;
 		}
 
-		int result = 0;
-
 		synchronized (emuLock) {
 			result = emu.store(Image.TYPE_SNAPSHOT, snapshotBuffer, snapshotBuffer.length);
 		}
@@ -516,6 +542,22 @@ public class Emu {
 
 	}
 
+	private void allocateSnapshotBuffer() {
+
+		// the size only changes with the cartridge type, so the buffer
+		// is sized once per ROM and every snapshot is a single store
+		int size = 0;
+
+		synchronized (emuLock) {
+			size = emu.store(Image.TYPE_SNAPSHOT, null, 0);
+		}
+
+		if (size > 0 && (null == snapshotBuffer || snapshotBuffer.length < size)) {
+			snapshotBuffer = new byte[size];
+			snapshotBufferUsage = 0;
+		}
+	}
+
 	public void restoreSnapshot() {
 		if (null == snapshotBuffer || snapshotBufferUsage == 0) {
 			return;
@@ -174,6 +174,28 @@ public class ImageManager {
 
 	private void scanZipFile(File zip) {
 
+		String zipPath = zip.getAbsolutePath();
+
+		// the emulator lists the archive without unpacking anything, and
+		// keeps its index for loading from it later
+		String list = null;
+		try {
+			list = new NativeInterface().listArchive(zipPath);
+		} catch (UnsatisfiedLinkError e) {
+			list = null;
+		}
+
+		if (null != list) {
+			for (String name : list.split("\n")) {
+				if (name.isEmpty()) continue;
+				if (isValidExtension(getFileExtension(name))) {
+					logger.info("found disk in zip file: " + name);
+					diskImageList.add(new Image(zipPath, name));
+				}
+			}
+			return;
+		}
+
 		ZipFile zipFile = null;
 
 		try {
@@ -183,8 +205,6 @@ public class ImageManager {
 			return;
 		}
 
-		String zipPath = zip.getAbsolutePath();
-
 		Enumeration zipEntries = zipFile.entries();
 		while (zipEntries.hasMoreElements()) {
 			ZipEntry entry = ((ZipEntry) zipEntries.nextElement());
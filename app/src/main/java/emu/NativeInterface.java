@@ -11,6 +11,36 @@ public class NativeInterface {
 	public static int COMMAND_JOYSTICK_SWAP_ON  = 6;
 	public static int COMMAND_JOYSTICK_SWAP_OFF  = 7;
 	public static int COMMAND_SELECT = 8;
+	public static int COMMAND_AUDIO_CAPTURE_START = 9;
+	public static int COMMAND_AUDIO_CAPTURE_STOP = 10;
+	public static int COMMAND_AUDIO_FORMAT = 11;
+	public static int COMMAND_REWIND_STEP = 12;
+	public static int COMMAND_REWIND_RESUME = 13;
+	public static int COMMAND_RUNAHEAD = 14;
+	public static int COMMAND_MOVIE_RECORD = 15;
+	public static int COMMAND_MOVIE_PLAY = 16;
+	public static int COMMAND_NETPLAY_START = 17;
+	public static int COMMAND_NETPLAY_STOP = 18;
+	public static int COMMAND_PIPELINE = 19;
+
+	// key codes of input, the second joystick or'ed with KEY_JOYSTICK_ONE
+	public static int KEY_JOYSTICK_FIRE = 0x01;
+	public static int KEY_JOYSTICK_LEFT = 0x02;
+	public static int KEY_JOYSTICK_RIGHT = 0x04;
+	public static int KEY_JOYSTICK_UP = 0x08;
+	public static int KEY_JOYSTICK_DOWN = 0x10;
+	public static int KEY_JOYSTICK_ONE = 0x100;
+	public static int KEY_CONSOLE_RESET = 0x10000;
+	public static int KEY_CONSOLE_SELECT = 0x20000;
+
+	// data types of load/store, besides the image types
+	public static int DATA_NVRAM = 6;
+
+	public static int AUDIO_FORMAT_FLOAT = 0x10000000;
+
+	public static int audioFormat(int sampleRate, int numChannels, boolean isFloat) {
+		return sampleRate | (numChannels << 24) | (isFloat ? AUDIO_FORMAT_FLOAT : 0);
+	}
 
 	static {
         System.loadLibrary("Droid2600");
@@ -19,7 +49,10 @@ public class NativeInterface {
 	public native int init(String prefs, int flags);
 	public native int input(int keyCode, int state); // buffered, does not need to be synchronized!
 	public native int load(int dataType, byte[] buffer, int bufferSize, String filename); // to be synchronized
-	public native int store(int dataType, byte[] buffer, int bufferSize); // to be synchronized
+	public native int loadArchive(String archivePath, String entry); // to be synchronized, loads a ROM from a zip archive without extracting it
+	public native String listArchive(String archivePath); // entries of a zip archive separated by '\n', or null if it can't be read or its names aren't UTF-8
+	public native int prepare(byte[] buffer, int bufferSize, String filename); // builds the console of a ROM to be loaded next in the background (with 'consolepool')
+	public native int store(int dataType, byte[] buffer, int bufferSize); // to be synchronized, null buffer returns the size needed
 	public native int command(int command, int param); // buffered, does not need to be synchronized!
 	public native String get(String key);
 	public native int shutdown();
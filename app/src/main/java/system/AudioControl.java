@@ -18,19 +18,32 @@ public class AudioControl {
 
     public class AudioSpec {
 
-        private final int numSamplesPerSec = 44100;
+        private final int numSamplesPerSec;
         private final int numFragmentSamples = 512;
         private final int numBits = 16;
-        private final int numChannels = 1;
+        private final int numChannels = 2;
 
         private int numFragmentBuffers;
         private int numFragmentBufferBytes;
 
-        public AudioSpec(int hardwareBufferSize) {
+        public AudioSpec(int numSamplesPerSec) {
+            this.numSamplesPerSec = numSamplesPerSec;
             numFragmentBufferBytes = numFragmentSamples * numChannels * numBits / 8;
+            numFragmentBuffers = 1;
+        }
+
+        public void setHardwareBufferSize(int hardwareBufferSize) {
             numFragmentBuffers = (hardwareBufferSize + numFragmentBufferBytes - 1) / numFragmentBufferBytes;
         }
 
+        public int getChannelConfig() {
+            return (numChannels == 2) ? AudioFormat.CHANNEL_OUT_STEREO : AudioFormat.CHANNEL_OUT_MONO;
+        }
+
+        public int getEncoding() {
+            return AudioFormat.ENCODING_PCM_16BIT;
+        }
+
         public int getNumSamplesPerSec() {
             return numSamplesPerSec;
         }
@@ -76,7 +89,15 @@ public class AudioControl {
     }
 
     public void init() {
-        ;
+        // generate at the native output rate to avoid resampling in the mixer
+        int nativeRate = AudioTrack.getNativeOutputSampleRate(AudioManager.STREAM_MUSIC);
+        int rate = (48000 == nativeRate) ? 48000 : 44100;
+
+        audioSpec = new AudioSpec(rate);
+    }
+
+    public AudioSpec getAudioSpec() {
+        return audioSpec;
     }
 
     public synchronized void start() {
@@ -85,13 +106,14 @@ public class AudioControl {
 
         Preferences prefs = Preferences.instance();
 
-        int minBufferSize = AudioTrack.getMinBufferSize(44100, AudioFormat.CHANNEL_OUT_MONO, AudioFormat.ENCODING_PCM_16BIT);
+        int minBufferSize = AudioTrack.getMinBufferSize(audioSpec.getNumSamplesPerSec(),
+                audioSpec.getChannelConfig(), audioSpec.getEncoding());
 
-        audioSpec = new AudioSpec(minBufferSize);
+        audioSpec.setHardwareBufferSize(minBufferSize);
 
-        audioTrack = new AudioTrack(AudioManager.STREAM_MUSIC, 44100,
-                AudioFormat.CHANNEL_OUT_MONO,
-                AudioFormat.ENCODING_PCM_16BIT,
+        audioTrack = new AudioTrack(AudioManager.STREAM_MUSIC, audioSpec.getNumSamplesPerSec(),
+                audioSpec.getChannelConfig(),
+                audioSpec.getEncoding(),
                 minBufferSize,
                 AudioTrack.MODE_STREAM);
 